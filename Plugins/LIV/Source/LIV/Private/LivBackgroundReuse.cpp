@@ -0,0 +1,133 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#include "LivBackgroundReuse.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Components/SceneCaptureComponent2D.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "ConvexVolume.h"
+#include "Engine/World.h"
+#include "LivCaptureBase.h"
+#include "LivPrimitiveCache.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "SceneManagement.h"
+
+const FName FLivBackgroundReuse::AnimatedTag(TEXT("LivAnimated"));
+
+// camera movement below these is tracking noise
+static constexpr float LivBackgroundLocationTolerance = 0.05f;
+static constexpr float LivBackgroundRotationTolerance = 1.e-4f;
+
+FLivBackgroundReuse::FLivBackgroundReuse()
+	: MaxAge(1.0)
+	, bHasCapture(false)
+	, LastCaptureTime(0.0)
+	, LastFOVAngle(0.0f)
+	, LastResolution(FIntPoint::ZeroValue)
+{
+}
+
+bool FLivBackgroundReuse::ShouldRecapture(const FTransform& CameraTransform, float FOVAngle, const FIntPoint& Resolution, bool bSceneDirty, double Time)
+{
+	const bool bCameraChanged = !bHasCapture
+		|| !CameraTransform.GetLocation().Equals(LastCameraTransform.GetLocation(), LivBackgroundLocationTolerance)
+		|| !CameraTransform.GetRotation().Equals(LastCameraTransform.GetRotation(), LivBackgroundRotationTolerance)
+		|| !FMath::IsNearlyEqual(FOVAngle, LastFOVAngle)
+		|| Resolution != LastResolution;
+
+	const bool bExpired = MaxAge > 0.0 && Time - LastCaptureTime >= MaxAge;
+
+	if (!bCameraChanged && !bSceneDirty && !bExpired)
+	{
+		return false;
+	}
+
+	bHasCapture = true;
+	LastCaptureTime = Time;
+	LastCameraTransform = CameraTransform;
+	LastFOVAngle = FOVAngle;
+	LastResolution = Resolution;
+
+	return true;
+}
+
+bool FLivBackgroundReuse::UpdateSceneDirty(const USceneCaptureComponent2D* SceneCaptureComponent, const FIntPoint& Resolution)
+{
+	UWorld* World = SceneCaptureComponent->GetWorld();
+
+	if (!World || Resolution.X <= 0 || Resolution.Y <= 0)
+	{
+		return true;
+	}
+
+	FConvexVolume ViewFrustum;
+	GetViewFrustumBounds(ViewFrustum, ULivCaptureBase::GetCaptureViewProjectionMatrix(SceneCaptureComponent, Resolution), false);
+
+	bool bDirty = false;
+
+	TSet<TObjectKey<UPrimitiveComponent>> InView;
+	InView.Reserve(PrimitiveTransforms.Num());
+
+	const FLivPrimitiveCache::FHiddenPrimitives HiddenPrimitives(SceneCaptureComponent);
+
+	for (const TWeakObjectPtr<UPrimitiveComponent>& WeakPrimitiveComponent : FLivPrimitiveCache::Get(World).GetMovablePrimitives())
+	{
+		const UPrimitiveComponent* PrimitiveComponent = WeakPrimitiveComponent.Get();
+
+		// hidden, destroyed or made static since the primitives were gathered
+		if (HiddenPrimitives.IsHidden(PrimitiveComponent) || PrimitiveComponent->Mobility != EComponentMobility::Movable)
+		{
+			continue;
+		}
+
+		const AActor* Actor = PrimitiveComponent->GetOwner();
+
+		const FBoxSphereBounds& Bounds = PrimitiveComponent->Bounds;
+
+		if (!ViewFrustum.IntersectBox(Bounds.Origin, Bounds.BoxExtent))
+		{
+			continue;
+		}
+
+		InView.Add(PrimitiveComponent);
+
+		const FTransform& Transform = PrimitiveComponent->GetComponentTransform();
+		const FTransform* LastTransform = PrimitiveTransforms.Find(PrimitiveComponent);
+
+		if (!LastTransform || !LastTransform->Equals(Transform))
+		{
+			PrimitiveTransforms.Add(PrimitiveComponent, Transform);
+			bDirty = true;
+		}
+		else if ((Actor && Actor->ActorHasTag(AnimatedTag)) || PrimitiveComponent->ComponentHasTag(AnimatedTag))
+		{
+			bDirty = true;
+		}
+		else if (const UFXSystemComponent* FXSystemComponent = Cast<UFXSystemComponent>(PrimitiveComponent))
+		{
+			bDirty |= FXSystemComponent->IsActive();
+		}
+		else if (const USkinnedMeshComponent* SkinnedMeshComponent = Cast<USkinnedMeshComponent>(PrimitiveComponent))
+		{
+			bDirty |= SkinnedMeshComponent->IsComponentTickEnabled();
+		}
+	}
+
+	// a primitive that left the view (or was hidden or destroyed) uncovers what was behind it
+	for (auto It = PrimitiveTransforms.CreateIterator(); It; ++It)
+	{
+		if (!InView.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+			bDirty = true;
+		}
+	}
+
+	return bDirty;
+}
+
+void FLivBackgroundReuse::Reset()
+{
+	bHasCapture = false;
+	PrimitiveTransforms.Reset();
+}
@@ -0,0 +1,224 @@
+// Copyright 2021 LIV Inc. - MIT License
+#include "LivCaptureAnalyticClipPlane.h"
+
+#include "LivCaptureContext.h"
+#include "LivPassTimings.h"
+#include "LivRenderPass.h"
+#include "LivShaders.h"
+#include "PixelShaderUtils.h"
+#include "ScreenPass.h"
+
+ULivCaptureAnalyticClipPlane::ULivCaptureAnalyticClipPlane(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, SceneRenderTarget(nullptr)
+	, BackgroundOutputRenderTarget(nullptr)
+	, ForegroundOutputRenderTarget(nullptr)
+{
+}
+
+FPlane ULivCaptureAnalyticClipPlane::MakeCameraSidePlane(const FMatrix& ClipPlaneMatrix, const FTransform& VROriginTransform, const FVector& CameraLocation)
+{
+	const FVector PlanePosition = VROriginTransform.TransformPosition(ClipPlaneMatrix.TransformPosition(FVector::ZeroVector));
+	const FVector PlaneNormal = VROriginTransform.TransformVector(ClipPlaneMatrix.TransformVector(FVector::ForwardVector)).GetSafeNormal();
+
+	const FPlane Plane(PlanePosition, PlaneNormal);
+
+	// the clip plane meshes clip whichever side the camera isn't on
+	return Plane.PlaneDot(CameraLocation) < 0.0f ? Plane.Flip() : Plane;
+}
+
+void ULivCaptureAnalyticClipPlane::OnActivated()
+{
+	Super::OnActivated();
+
+	PrimitiveRenderMode = ESceneCapturePrimitiveRenderMode::PRM_RenderScenePrimitives;
+	bCaptureEveryFrame = false;
+	bCaptureOnMovement = false;
+	bAlwaysPersistRenderingState = false;
+}
+
+void ULivCaptureAnalyticClipPlane::CreateRenderTargets()
+{
+	Super::CreateRenderTargets();
+
+	// Scene (RGB + Depth)
+	SceneRenderTarget = CreateRenderTarget2D(
+		GetWorld(),
+		LivInputFrameWidth,
+		LivInputFrameHeight,
+		"SceneRenderTarget",
+		ETextureRenderTargetFormat::RTF_RGBA16f
+	);
+
+	if (ShouldExtractIntermediates())
+	{
+		// Background output (8bpc)
+		BackgroundOutputRenderTarget = CreateRenderTarget2D(
+			GetWorld(),
+			LivInputFrameWidth,
+			LivInputFrameHeight,
+			"BackgroundOutputRenderTarget",
+			ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+		);
+
+		// Foreground masked
+		ForegroundOutputRenderTarget = CreateRenderTarget2D(
+			GetWorld(),
+			LivInputFrameWidth,
+			LivInputFrameHeight,
+			"ForegroundOutputRenderTarget",
+			ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+		);
+	}
+}
+
+void ULivCaptureAnalyticClipPlane::ReleaseRenderTargets()
+{
+	Super::ReleaseRenderTargets();
+
+	TextureTarget = nullptr;
+
+	ReleaseRenderTarget2D(SceneRenderTarget);
+	ReleaseRenderTarget2D(BackgroundOutputRenderTarget);
+	ReleaseRenderTarget2D(ForegroundOutputRenderTarget);
+}
+
+void ULivCaptureAnalyticClipPlane::Capture(const FLivCaptureContext& Context)
+{
+	Super::Capture(Context);
+
+#if LIV_CAPTURE_SUPPORTED
+
+	UWorld* World = GetWorld();
+
+	// the clip planes are applied in the segmentation pass
+	bEnableClipPlane = false;
+
+	UpdateLivInputFrame(this);
+
+	// set scene capture transform / FOV from input frame data
+	SetSceneCaptureComponentParameters(this);
+
+	// Apply context to scene capture (set hide list)
+	Context.ApplyHideLists(this);
+
+	const bool bCaptureBackground = ShouldCaptureBackground();
+	const bool bCaptureForeground = ShouldCaptureForeground();
+
+	if (!bCaptureBackground && !bCaptureForeground)
+	{
+		return;
+	}
+
+	// Capture the scene, the only scene rendering of this method
+	TextureTarget = SceneRenderTarget;
+	CaptureSource = SCS_SceneColorSceneDepth;
+	CaptureScene();
+
+	// a pixel's world position is origin + depth * (forward + x / scale.x * right + y / scale.y * up),
+	// the scales come from the capture's projection so portrait (vertical field of view) works too
+	const FTransform CameraTransform = GetComponentTransform();
+	const FMatrix ProjectionMatrix = GetCaptureProjectionMatrix(this, FIntPoint(SceneRenderTarget->SizeX, FMath::Max<int32>(SceneRenderTarget->SizeY, 1)));
+	const FVector2D ProjectionScale(ProjectionMatrix.M[0][0], ProjectionMatrix.M[1][1]);
+
+	const FVector CameraOrigin = CameraTransform.GetLocation();
+	const FVector CameraForward = CameraTransform.GetUnitAxis(EAxis::X);
+	const FVector CameraRight = CameraTransform.GetUnitAxis(EAxis::Y);
+	const FVector CameraUp = CameraTransform.GetUnitAxis(EAxis::Z);
+
+	const FTransform VROriginTransform = GetAttachParent()->GetComponentTransform();
+
+	const FPlane CameraClipPlane = MakeCameraSidePlane(InputFrame.CameraClipPlaneMatrix, VROriginTransform, CameraOrigin);
+
+	// without a floor every pixel is on the camera side of it
+	const FPlane FloorClipPlane = InputFrame.bFloorClipPlaneEnabled
+		? MakeCameraSidePlane(InputFrame.FloorClipPlaneMatrix, VROriginTransform, CameraOrigin)
+		: FPlane(0.0f, 0.0f, 0.0f, -1.0f);
+
+	const ERHIFeatureLevel::Type FeatureLevel = World->Scene->GetFeatureLevel();
+
+	FTextureResource* SceneResource = SceneRenderTarget->Resource;
+
+	// the segmented outputs are allocated in the graph, these only exist to extract them for debugging
+	FTextureResource* DebugForegroundOutputResource = ForegroundOutputRenderTarget ? ForegroundOutputRenderTarget->Resource : nullptr;
+	FTextureResource* DebugBackgroundOutputResource = BackgroundOutputRenderTarget ? BackgroundOutputRenderTarget->Resource : nullptr;
+
+	ENQUEUE_RENDER_COMMAND(LivRDGCaptureAnalyticClipPlane)(
+		[FeatureLevel, SceneResource, DebugForegroundOutputResource, DebugBackgroundOutputResource, bCaptureBackground, bCaptureForeground,
+		CameraOrigin, CameraForward, CameraRight, CameraUp, ProjectionScale, CameraClipPlane, FloorClipPlane](FRHICommandListImmediate& RHICmdList)
+		{
+			FRDGBuilder GraphBuilder(RHICmdList);
+
+			{
+				RDG_EVENT_SCOPE(GraphBuilder, "Liv Capture Analytic Clip Plane");
+				LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
+
+				const auto GlobalShaderMap = GetGlobalShaderMap(FeatureLevel);
+				const FIntPoint OutputExtent(SceneResource->GetSizeX(), SceneResource->GetSizeY());
+
+				const FRDGTextureRef OutputForegroundTexture = FLivRenderPass::CreateIntermediateTexture(
+					GraphBuilder,
+					OutputExtent,
+					LIV_TEXTURE_FOREGROUND_COLOR_BUFFER_ID,
+					TEXT("Foreground Output")
+				);
+
+				const FRDGTextureRef OutputBackgroundTexture = FLivRenderPass::CreateIntermediateTexture(
+					GraphBuilder,
+					OutputExtent,
+					LIV_TEXTURE_BACKGROUND_COLOR_BUFFER_ID,
+					TEXT("Background Output")
+				);
+
+				{
+					RDG_EVENT_SCOPE(GraphBuilder, "Liv Segment By Planes");
+
+					const TShaderMapRef<FLivRDGScreenPassVS> VertexShader(GlobalShaderMap);
+					const TShaderMapRef<FLivRDGSegmentByPlanesPS> PixelShader(GlobalShaderMap);
+
+					FLivRDGSegmentByPlanesPS::FParameters* Parameters = GraphBuilder.AllocParameters<FLivRDGSegmentByPlanesPS::FParameters>();
+					Parameters->InputSceneColorDepthTexture = SceneResource->TextureRHI;
+					Parameters->InputSceneColorDepthSampler = TStaticSamplerState<SF_Point>::GetRHI();
+					Parameters->CameraOrigin = CameraOrigin;
+					Parameters->CameraForward = CameraForward;
+					Parameters->CameraRight = CameraRight;
+					Parameters->CameraUp = CameraUp;
+					Parameters->ProjectionScale = ProjectionScale;
+					Parameters->CameraClipPlane = FVector4(CameraClipPlane.X, CameraClipPlane.Y, CameraClipPlane.Z, CameraClipPlane.W);
+					Parameters->FloorClipPlane = FVector4(FloorClipPlane.X, FloorClipPlane.Y, FloorClipPlane.Z, FloorClipPlane.W);
+
+					Parameters->RenderTargets[0] = FRenderTargetBinding(OutputForegroundTexture, ERenderTargetLoadAction::EClear, 0);
+					Parameters->RenderTargets[1] = FRenderTargetBinding(OutputBackgroundTexture, ERenderTargetLoadAction::EClear, 0);
+
+					const FScreenPassTextureViewport ScreenPassTextureViewport(OutputForegroundTexture);
+					const FScreenPassPipelineState PipelineState(VertexShader, PixelShader);
+
+					FLivRenderPass::AddLivPass(
+						GraphBuilder,
+						RDG_EVENT_NAME("Liv RDG Segment By Planes Pass"),
+						ScreenPassTextureViewport,
+						PipelineState,
+						PixelShader,
+						Parameters
+					);
+
+					FLivRenderPass::AddExtractPass(GraphBuilder, OutputForegroundTexture, DebugForegroundOutputResource);
+					FLivRenderPass::AddExtractPass(GraphBuilder, OutputBackgroundTexture, DebugBackgroundOutputResource);
+				}
+
+				{
+					RDG_EVENT_SCOPE(GraphBuilder, "Liv Submit");
+
+					FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
+					Parameters->ForegroundTexture = bCaptureForeground ? OutputForegroundTexture : nullptr;
+					Parameters->BackgroundTexture = bCaptureBackground ? OutputBackgroundTexture : nullptr;
+
+					FLivRenderPass::AddSubmitPass(GraphBuilder, Parameters);
+				}
+			}
+
+			GraphBuilder.Execute();
+		});
+
+#endif
+}
@@ -4,6 +4,8 @@
 #include "BasePassRendering.h"
 #include "Engine/World.h"
 #include "Kismet/KismetRenderingLibrary.h"
+#include "Misc/App.h"
+#include "UObject/UObjectIterator.h"
 #include "LivConversions.h"
 #include "LivShaders.h"
 
@@ -14,8 +16,13 @@
 #include "Windows/HideWindowsPlatformTypes.h"
 #endif
 
+#include "LivInputFramePoller.h"
+#include "LivLatencyTracker.h"
 #include "LivLocalPlayerSubsystem.h"
 #include "LivPluginSettings.h"
+#include "LivRenderTargetPool.h"
+#include "LivSceneViewExtensionLateLatch.h"
+#include "LivStats.h"
 #include "LivWorldSubsystem.h"
 
 #ifdef WITH_EDITORONLY//Editor only
@@ -24,13 +31,27 @@
 #include "LivEditorSettings.h"
 #endif
 
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
 TAutoConsoleVariable<int32> CVarLivColorSpace(TEXT("Liv.ColorSpace"),
 	LIV_TEXTURE_COLOR_SPACE_SRGB,
 	TEXT("Colorspace: Linear (1), sRGB (2)")
 );
 #endif
 
+static TAutoConsoleVariable<bool> CVarLivExtractIntermediates(TEXT("Liv.Debug.ExtractIntermediates"),
+	false,
+	TEXT("Copy the textures captures composite before submitting to render targets for the LIV debugging tab."),
+	ECVF_Default);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Foreground Empty"), STAT_LivForegroundEmpty, STATGROUP_Liv);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Foreground Primitives"), STAT_LivForegroundPrimitives, STATGROUP_Liv);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Foreground Captures Skipped"), STAT_LivForegroundCapturesSkipped, STATGROUP_Liv);
+
+static TAutoConsoleVariable<bool> CVarLivFollowCompositorLayers(TEXT("Liv.FollowCompositorLayers"),
+	true,
+	TEXT("Skip capturing the background or foreground when LIV is not compositing it."),
+	ECVF_Default);
+
 DEFINE_LOG_CATEGORY(LogLivCapture);
 
 ULivCaptureBase::ULivCaptureBase(const FObjectInitializer& ObjectInitializer)
@@ -39,6 +60,12 @@ ULivCaptureBase::ULivCaptureBase(const FObjectInitializer& ObjectInitializer)
 	, bLivActive(false)
 	, LivInputFrameWidth(0)
 	, LivInputFrameHeight(0)
+	, PolledInputFrameSequence(0)
+	, bExtractIntermediates(false)
+	, LivNativeResolution(FIntPoint::ZeroValue)
+	, bResolutionRequested(false)
+	, bLastFloorClipPlaneEnabled(false)
+	, bClipPlaneTransformsValid(false)
 #if WITH_EDITORONLY_DATA
 	, bRequestedCapture(false)
 #endif
@@ -53,10 +80,31 @@ bool ULivCaptureBase::IsLivCapturing() const
 	return bLivActive;
 }
 
+TArray<TSubclassOf<ULivCaptureBase>> ULivCaptureBase::GetCaptureClasses()
+{
+	TArray<TSubclassOf<ULivCaptureBase>> Classes;
+	// should be at least 4 non abstract capture classes
+	Classes.Reserve(4);
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		if (!It->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated) && It->IsChildOf<ULivCaptureBase>())
+		{
+			Classes.Add(*It);
+		}
+	}
+	return Classes;
+}
+
 void ULivCaptureBase::OnActivated()
 {
-#if PLATFORM_WINDOWS
-	const bool bSuccess = FLivNativeWrapper::GetInputFrame(InputFrame);
+#if LIV_CAPTURE_SUPPORTED
+	FLivInputFramePoller& Poller = FLivInputFramePoller::Get();
+	PolledInputFrameSequence = 0;
+
+	// only frames polled after this one are new, earlier ones may predate activation
+	const bool bSuccess = Poller.IsRunning()
+		? Poller.GetInputFrameNow(InputFrame, PolledInputFrameSequence)
+		: FLivNativeWrapper::GetInputFrame(InputFrame);
 
 	if(!bSuccess)
 	{
@@ -67,6 +115,28 @@ void ULivCaptureBase::OnActivated()
 	LivInputFrameWidth = InputFrame.Dimensions.X;
 	LivInputFrameHeight = InputFrame.Dimensions.Y;
 
+	// clip plane meshes are placed on the first capture
+	bClipPlaneTransformsValid = false;
+
+	PosePredictor.Reset();
+
+	CaptureScheduler.Reset();
+
+	DynamicResolution.Reset();
+	bResolutionRequested = false;
+	FLivNativeWrapper::SetRequestedResolution(FIntPoint::ZeroValue);
+	FLivNativeWrapper::SetRequestedBackgroundDepth(IsCompositorSegmentationRequested());
+
+	if (GetDefault<ULivPluginSettings>()->bLateLatchCameraPose && !LateLatchViewExtension.IsValid())
+	{
+
+		// scene captures only run view extensions when asked to
+		IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.SceneCapture.EnableViewExtensions"));
+		CVar->Set(1);
+
+		LateLatchViewExtension = FSceneViewExtensions::NewExtension<FLivSceneViewExtensionLateLatch>(nullptr);
+	}
+
 	// create render targets needed for rendering
 	CreateRenderTargets();
 
@@ -81,11 +151,22 @@ void ULivCaptureBase::OnActivated()
 
 void ULivCaptureBase::OnDeactivated()
 {
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
 
 	// release render targets used for capture
 	ReleaseRenderTargets();
 
+	// leave the resolution to LIV for whatever captures next
+	if (bResolutionRequested)
+	{
+		bResolutionRequested = false;
+		FLivNativeWrapper::SetRequestedResolution(FIntPoint::ZeroValue);
+	}
+
+	FLivNativeWrapper::SetRequestedBackgroundDepth(false);
+
+	LateLatchViewExtension = nullptr;
+
 	// track LIV inactive
 	bLivActive = false;
 
@@ -99,6 +180,14 @@ void ULivCaptureBase::TickComponent(float DeltaTime, ELevelTick TickType, FActor
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	UpdateDynamicResolution();
+
+	// real time, the capture rate shouldn't follow time dilation
+	if (!CaptureScheduler.ShouldCapture(FApp::GetDeltaTime(), GetDefault<ULivPluginSettings>()->CaptureRate))
+	{
+		return;
+	}
+
 	if (UWorld* World = GetWorld())
 	{
 		if (ULocalPlayer* LocalPlayer = GEngine->GetFirstGamePlayer(World))
@@ -107,7 +196,8 @@ void ULivCaptureBase::TickComponent(float DeltaTime, ELevelTick TickType, FActor
 			{
 				if (LivLocalPlayerSubsystem->IsCaptureActive())
 				{
-					FLivCaptureContext CaptureContext = LivLocalPlayerSubsystem->GetCaptureContext();
+					// by reference, the context tracks which hide lists each scene capture has already been given
+					const FLivCaptureContext& CaptureContext = LivLocalPlayerSubsystem->GetCaptureContextRef();
 
 					if (ULivWorldSubsystem* LivWorldSubsystem = World->GetSubsystem<ULivWorldSubsystem>())
 					{
@@ -129,6 +219,11 @@ void ULivCaptureBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 void ULivCaptureBase::CreateRenderTargets()
 {
+	bExtractIntermediates = ShouldExtractIntermediates();
+
+	// new render targets have no background in them
+	BackgroundReuse.Reset();
+
 	// Implement in subclass	
 }
 
@@ -145,21 +240,231 @@ void ULivCaptureBase::ReleaseRenderTargets()
 
 void ULivCaptureBase::UpdateLivInputFrame(USceneCaptureComponent2D* InSceneCaptureComponent)
 {
-	const bool bSuccess = FLivNativeWrapper::UpdateInputFrame(InputFrame, bOverrideCameraPose ? InSceneCaptureComponent : nullptr);
+	FLivInputFramePoller& Poller = FLivInputFramePoller::Get();
+	bool bNewInputFrame = true;
 
-	if(!bSuccess)
+	// settings can change while capturing
+	FLivNativeWrapper::SetRequestedBackgroundDepth(IsCompositorSegmentationRequested());
+
+	if (Poller.IsRunning())
+	{
+		// request is picked up by the next poll, keep the last frame until a new one is published
+		if (bOverrideCameraPose)
+		{
+			const FLivInputFramePoseRequest PoseRequest(InSceneCaptureComponent);
+			Poller.SetPoseRequest(&PoseRequest);
+		}
+		else
+		{
+			Poller.SetPoseRequest(nullptr);
+		}
+
+		bNewInputFrame = Poller.GetLatestInputFrame(InputFrame, PolledInputFrameSequence);
+	}
+	else if (!FLivNativeWrapper::UpdateInputFrame(InputFrame, bOverrideCameraPose ? InSceneCaptureComponent : nullptr))
 	{
 		UE_LOG(LogLivCapture, Warning, TEXT("Failed to update input frame."));
 		return;
 	}
 
+	if (GetDefault<ULivPluginSettings>()->bPredictCameraPose && !bOverrideCameraPose)
+	{
+		PredictCameraPose(bNewInputFrame);
+	}
+
 	// Check if output dimensions changed
-	if (LivInputFrameWidth != InputFrame.Dimensions.X || LivInputFrameHeight != InputFrame.Dimensions.Y)
+	if (InputFrame.IsDirty(ELivInputFrameFields::Resolution)
+		&& (LivInputFrameWidth != InputFrame.Dimensions.X || LivInputFrameHeight != InputFrame.Dimensions.Y))
 	{
 		LivInputFrameWidth = InputFrame.Dimensions.X;
 		LivInputFrameHeight = InputFrame.Dimensions.Y;
 		RecreateRenderTargets();
 	}
+	else if (bExtractIntermediates != ShouldExtractIntermediates())
+	{
+		RecreateRenderTargets();
+	}
+
+#if LIV_WITH_LATENCY_TRACKING
+	FLivLatencyTracker::Get().OnCapture(InputFrame);
+#endif
+}
+
+void ULivCaptureBase::UpdateDynamicResolution()
+{
+#if LIV_CAPTURE_SUPPORTED
+	const ULivPluginSettings* PluginSettings = GetDefault<ULivPluginSettings>();
+
+	if (!bLivActive || !PluginSettings->bDynamicResolution)
+	{
+		if (bResolutionRequested)
+		{
+			DynamicResolution.Reset();
+			bResolutionRequested = false;
+			FLivNativeWrapper::SetRequestedResolution(FIntPoint::ZeroValue);
+		}
+
+		return;
+	}
+
+	// input frames carry LIV's own resolution unless LIV took our request, while it does only LIV_GetResolution
+	// tells us when LIV wants another (the output was resized)
+	const FIntPoint PreviousNativeResolution = LivNativeResolution;
+	FIntPoint Resolution;
+
+	if (InputFrame.Dimensions != InputFrame.RequestedResolution)
+	{
+		LivNativeResolution = InputFrame.Dimensions;
+	}
+	else if (FLivNativeWrapper::GetResolution(Resolution) && Resolution.X > 0 && Resolution.Y > 0)
+	{
+		LivNativeResolution = Resolution;
+	}
+
+	DynamicResolution.MinScale = PluginSettings->DynamicResolutionMinScale;
+
+	const float GPUFrameTimeMs = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+	const bool bScaleChanged = DynamicResolution.Update(FApp::GetDeltaTime(), GPUFrameTimeMs, PluginSettings->DynamicResolutionFrameBudget);
+
+	// keep the scale relative to what LIV wants now
+	if (bScaleChanged || (bResolutionRequested && LivNativeResolution != PreviousNativeResolution))
+	{
+		bResolutionRequested = DynamicResolution.GetScale() < 1.0f;
+
+		const FIntPoint RequestedResolution = bResolutionRequested ? DynamicResolution.GetResolution(LivNativeResolution) : FIntPoint::ZeroValue;
+		FLivNativeWrapper::SetRequestedResolution(RequestedResolution);
+
+		UE_LOG(LogLivCapture, Log, TEXT("LIV dynamic resolution: GPU %.2f ms of %.2f ms, requesting %dx%d."),
+			GPUFrameTimeMs, PluginSettings->DynamicResolutionFrameBudget,
+			bResolutionRequested ? RequestedResolution.X : LivNativeResolution.X,
+			bResolutionRequested ? RequestedResolution.Y : LivNativeResolution.Y);
+	}
+#endif
+}
+
+void ULivCaptureBase::PredictCameraPose(bool bNewInputFrame)
+{
+	if (bNewInputFrame)
+	{
+		// an unchanged pose may still hold last frame's prediction, so repeat the newest sample
+		if (InputFrame.IsDirty(ELivInputFrameFields::Pose) || PosePredictor.Num() == 0)
+		{
+			PosePredictor.AddSample(InputFrame.Timestamp, InputFrame.CameraLocation, InputFrame.CameraRotation);
+		}
+		else
+		{
+			PosePredictor.RepeatNewestSample(InputFrame.Timestamp);
+		}
+	}
+
+	const double PredictionTime = GetDefault<ULivPluginSettings>()->CameraPosePredictionTime / 1000.0;
+
+	FVector PredictedLocation;
+	FQuat PredictedRotation;
+
+	if (PosePredictor.Predict(FPlatformTime::Seconds() + PredictionTime, PredictedLocation, PredictedRotation))
+	{
+		InputFrame.CameraLocation = PredictedLocation;
+		InputFrame.CameraRotation = PredictedRotation;
+		InputFrame.DirtyFields |= ELivInputFrameFields::Pose;
+	}
+}
+
+bool ULivCaptureBase::ShouldUpdateClipPlaneTransforms(const FTransform& VROriginTransform)
+{
+	const ULivPluginSettings* Settings = GetDefault<ULivPluginSettings>();
+	const bool bDebugClipPlanes = Settings->bUseDebugCameraClipPlane || Settings->bUseDebugFloorClipPlane;
+
+	const FTransform& CaptureTransform = GetComponentTransform();
+
+	// compared against what the meshes were last placed with rather than this frame's dirty fields,
+	// a change on a frame the foreground was skipped would be lost otherwise
+	if (bClipPlaneTransformsValid
+		&& !bDebugClipPlanes
+		&& InputFrame.CameraClipPlaneMatrix.Equals(LastClipPlaneCameraMatrix, 0.0f)
+		&& InputFrame.FloorClipPlaneMatrix.Equals(LastClipPlaneFloorMatrix, 0.0f)
+		&& InputFrame.bFloorClipPlaneEnabled == bLastFloorClipPlaneEnabled
+		&& InputFrame.CameraLocation.Equals(LastClipPlaneCameraLocation, 0.0f)
+		&& InputFrame.CameraRotation.Equals(LastClipPlaneCameraRotation, 0.0f)
+		&& VROriginTransform.Equals(LastClipPlaneOriginTransform)
+		&& CaptureTransform.Equals(LastClipPlaneCaptureTransform))
+	{
+		return false;
+	}
+
+	LastClipPlaneCameraMatrix = InputFrame.CameraClipPlaneMatrix;
+	LastClipPlaneFloorMatrix = InputFrame.FloorClipPlaneMatrix;
+	bLastFloorClipPlaneEnabled = InputFrame.bFloorClipPlaneEnabled;
+	LastClipPlaneCameraLocation = InputFrame.CameraLocation;
+	LastClipPlaneCameraRotation = InputFrame.CameraRotation;
+	LastClipPlaneOriginTransform = VROriginTransform;
+	LastClipPlaneCaptureTransform = CaptureTransform;
+
+	// debug transforms are reapplied every frame and must be undone once disabled
+	bClipPlaneTransformsValid = !bDebugClipPlanes;
+
+	return true;
+}
+
+bool ULivCaptureBase::ShouldExtractIntermediates()
+{
+	return CVarLivExtractIntermediates.GetValueOnGameThread();
+}
+
+bool ULivCaptureBase::ShouldCaptureBackground() const
+{
+	// always capture something
+	return InputFrame.bBackgroundEnabled || !ShouldCaptureForeground() || !CVarLivFollowCompositorLayers.GetValueOnGameThread();
+}
+
+bool ULivCaptureBase::IsCompositorSegmentationRequested() const
+{
+	const ULivPluginSettings* PluginSettings = GetDefault<ULivPluginSettings>();
+	return SupportsCompositorSegmentation() && PluginSettings->bCompositorSegmentation && !PluginSettings->bBackgroundOnly;
+}
+
+bool ULivCaptureBase::ShouldUseCompositorSegmentation() const
+{
+	return InputFrame.bBackgroundDepthEnabled && IsCompositorSegmentationRequested();
+}
+
+bool ULivCaptureBase::ShouldCaptureForeground() const
+{
+	if (GetDefault<ULivPluginSettings>()->bBackgroundOnly)
+	{
+		return false;
+	}
+
+	return InputFrame.bForegroundEnabled || !CVarLivFollowCompositorLayers.GetValueOnGameThread();
+}
+
+bool ULivCaptureBase::ShouldRenderBackground(const USceneCaptureComponent2D* InSceneCaptureComponent, bool bCaptureBackground)
+{
+	if (!bCaptureBackground)
+	{
+		// nothing rendered to reuse next time
+		BackgroundReuse.Reset();
+		return false;
+	}
+
+	const ULivPluginSettings* Settings = GetDefault<ULivPluginSettings>();
+
+	if (!Settings->bReuseBackground)
+	{
+		return true;
+	}
+
+	const FIntPoint Resolution(LivInputFrameWidth, LivInputFrameHeight);
+	const bool bSceneDirty = BackgroundReuse.UpdateSceneDirty(InSceneCaptureComponent, Resolution);
+
+	BackgroundReuse.MaxAge = Settings->BackgroundMaxAge;
+
+	return BackgroundReuse.ShouldRecapture(
+		InSceneCaptureComponent->GetComponentTransform(),
+		InSceneCaptureComponent->FOVAngle,
+		Resolution,
+		bSceneDirty,
+		FPlatformTime::Seconds());
 }
 
 void ULivCaptureBase::SetSceneCaptureComponentParameters(USceneCaptureComponent2D* InSceneCaptureComponent)
@@ -172,6 +477,11 @@ void ULivCaptureBase::SetSceneCaptureComponentParameters(USceneCaptureComponent2
 		InSceneCaptureComponent->SetWorldLocation(Settings->DebugCameraWorldLocation);
 		InSceneCaptureComponent->SetWorldRotation(Settings->DebugCameraWorldRotation);
 		InSceneCaptureComponent->FOVAngle = Settings->DebugCameraHorizontalFOV;
+
+		if (LateLatchViewExtension.IsValid())
+		{
+			LateLatchViewExtension->ClearCaptureView_GameThread(InSceneCaptureComponent);
+		}
 		return;
 	}
 #endif
@@ -179,6 +489,103 @@ void ULivCaptureBase::SetSceneCaptureComponentParameters(USceneCaptureComponent2
 	InSceneCaptureComponent->SetRelativeLocation(InputFrame.CameraLocation);
 	InSceneCaptureComponent->SetRelativeRotation(InputFrame.GetCameraRotator());
 	InSceneCaptureComponent->FOVAngle = InputFrame.HorizontalFieldOfView;
+
+	if (LateLatchViewExtension.IsValid())
+	{
+		// the game's own pose request must not be replaced
+		if (bOverrideCameraPose)
+		{
+			LateLatchViewExtension->ClearCaptureView_GameThread(InSceneCaptureComponent);
+		}
+		else
+		{
+			LateLatchViewExtension->SetCaptureView_GameThread(InSceneCaptureComponent, InSceneCaptureComponent == this ? GetNumCaptureViews() : 1);
+		}
+	}
+}
+
+void ULivCaptureBase::SetCaptureUsesLighting(USceneCaptureComponent2D* InSceneCaptureComponent, bool bUsesLighting)
+{
+	const bool bLighting = bUsesLighting || !GetDefault<ULivPluginSettings>()->bReusePreviousCaptureLighting;
+
+	// depth and opacity don't depend on any of these, shadow depths are the expensive part
+	FEngineShowFlags& CaptureShowFlags = InSceneCaptureComponent->ShowFlags;
+	CaptureShowFlags.DynamicShadows = bLighting;
+	CaptureShowFlags.ContactShadows = bLighting;
+	CaptureShowFlags.CapsuleShadows = bLighting;
+	CaptureShowFlags.DirectLighting = bLighting;
+	CaptureShowFlags.GlobalIllumination = bLighting;
+	CaptureShowFlags.AmbientOcclusion = bLighting;
+	CaptureShowFlags.DistanceFieldAO = bLighting;
+	CaptureShowFlags.ReflectionEnvironment = bLighting;
+	CaptureShowFlags.ScreenSpaceReflections = bLighting;
+	CaptureShowFlags.VolumetricFog = bLighting;
+	CaptureShowFlags.LightShafts = bLighting;
+}
+
+void ULivCaptureBase::BeginForegroundCulling(USceneCaptureComponent2D* InSceneCaptureComponent)
+{
+	if (!GetDefault<ULivPluginSettings>()->bCullForegroundPrimitives)
+	{
+		return;
+	}
+
+	ForegroundCulling.Apply(InSceneCaptureComponent, FIntPoint(LivInputFrameWidth, LivInputFrameHeight));
+}
+
+void ULivCaptureBase::EndForegroundCulling(USceneCaptureComponent2D* InSceneCaptureComponent)
+{
+	if (InSceneCaptureComponent->PrimitiveRenderMode == ESceneCapturePrimitiveRenderMode::PRM_UseShowOnlyList)
+	{
+		FLivForegroundCulling::Restore(InSceneCaptureComponent);
+	}
+}
+
+bool ULivCaptureBase::IsForegroundEmpty(const USceneCaptureComponent2D* InSceneCaptureComponent, const FPlane& ClipPlane)
+{
+	if (!GetDefault<ULivPluginSettings>()->bSkipEmptyForeground)
+	{
+		return false;
+	}
+
+	ForegroundCulling.Update(InSceneCaptureComponent, ClipPlane, FIntPoint(LivInputFrameWidth, LivInputFrameHeight));
+
+	const bool bEmpty = ForegroundCulling.GetNumVisible() == 0;
+
+	SET_DWORD_STAT(STAT_LivForegroundPrimitives, ForegroundCulling.GetNumVisible());
+
+	if (bEmpty)
+	{
+		INC_DWORD_STAT(STAT_LivForegroundEmpty);
+		INC_DWORD_STAT(STAT_LivForegroundCapturesSkipped);
+	}
+
+	return bEmpty;
+}
+
+FMatrix ULivCaptureBase::GetCaptureProjectionMatrix(const USceneCaptureComponent2D* InSceneCaptureComponent, const FIntPoint& Resolution)
+{
+	const float HalfFOV = FMath::Max(0.001f, InSceneCaptureComponent->FOVAngle) * static_cast<float>(PI) / 360.0f;
+	const float XAxisMultiplier = Resolution.X > Resolution.Y ? 1.0f : static_cast<float>(Resolution.Y) / Resolution.X;
+	const float YAxisMultiplier = Resolution.X > Resolution.Y ? static_cast<float>(Resolution.X) / Resolution.Y : 1.0f;
+
+	return FReversedZPerspectiveMatrix(HalfFOV, HalfFOV, XAxisMultiplier, YAxisMultiplier, GNearClippingPlane, GNearClippingPlane);
+}
+
+FMatrix ULivCaptureBase::GetCaptureViewProjectionMatrix(const USceneCaptureComponent2D* InSceneCaptureComponent, const FIntPoint& Resolution)
+{
+	const FTransform CameraTransform = InSceneCaptureComponent->GetComponentTransform();
+
+	// unreal to view space axes
+	const FMatrix ViewMatrix = FTranslationMatrix(-CameraTransform.GetLocation())
+		* FInverseRotationMatrix(CameraTransform.Rotator())
+		* FMatrix(
+			FPlane(0, 0, 1, 0),
+			FPlane(1, 0, 0, 0),
+			FPlane(0, 1, 0, 0),
+			FPlane(0, 0, 0, 1));
+
+	return ViewMatrix * GetCaptureProjectionMatrix(InSceneCaptureComponent, Resolution);
 }
 
 void ULivCaptureBase::Capture(const struct FLivCaptureContext& Context)
@@ -206,22 +613,36 @@ UTextureRenderTarget2D* ULivCaptureBase::CreateRenderTarget2D(UObject* Owner,
 	FLinearColor ClearColor /*= FLinearColor::Black*/,
 	float TargetGamma /*= 0.0f*/)
 {
-	/*UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);*/
+	return CreateRenderTarget2D(Width, Height, Name, Format, true, ClearColor, TargetGamma);
+}
 
-	if (Width > 0 && Height > 0/* && World*/)
+UTextureRenderTarget2D* ULivCaptureBase::CreateRenderTarget2D(int32 Width,
+	int32 Height,
+	FName Name,
+	ETextureRenderTargetFormat Format,
+	bool bForceLinearGamma,
+	FLinearColor ClearColor /*= FLinearColor::Black*/,
+	float TargetGamma /*= 0.0f*/)
+{
+	ULivRenderTargetPool* RenderTargetPool = ULivRenderTargetPool::Get();
+	return RenderTargetPool ? RenderTargetPool->Acquire(Width, Height, Name, Format, bForceLinearGamma, ClearColor, TargetGamma) : nullptr;
+}
+
+void ULivCaptureBase::ReleaseRenderTarget2D(UTextureRenderTarget2D*& RenderTarget)
+{
+	if (!RenderTarget)
 	{
-		UTextureRenderTarget2D* NewRenderTarget2D = NewObject<UTextureRenderTarget2D>(GetTransientPackage(), Name);
-		check(NewRenderTarget2D);
-		NewRenderTarget2D->RenderTargetFormat = Format;
-		NewRenderTarget2D->ClearColor = ClearColor;
-		NewRenderTarget2D->bAutoGenerateMips = false;
-		NewRenderTarget2D->TargetGamma = TargetGamma;
-		NewRenderTarget2D->bForceLinearGamma = true;
-		NewRenderTarget2D->InitAutoFormat(Width, Height);
-		NewRenderTarget2D->UpdateResourceImmediate(true);
+		return;
+	}
 
-		return NewRenderTarget2D;
+	if (ULivRenderTargetPool* RenderTargetPool = ULivRenderTargetPool::Get())
+	{
+		RenderTargetPool->Release(RenderTarget);
+	}
+	else
+	{
+		RenderTarget->ReleaseResource();
 	}
 
-	return nullptr;
+	RenderTarget = nullptr;
 }
@@ -78,14 +78,14 @@ void ULivCaptureCombo::CreateRenderTargets()
 		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
 	);
 
-	if (GetDefault<ULivPluginSettings>()->bTransparency)
+	if (ShouldExtractIntermediates())
 	{
 		// Foreground output (8bpc)
 		ForegroundOutputRenderTarget = CreateRenderTarget2D(
 			GetWorld(),
 			LivInputFrameWidth,
 			LivInputFrameHeight,
-			"ForegroundRenderTarget",
+			"ForegroundOutputRenderTarget",
 			ETextureRenderTargetFormat::RTF_RGBA8_SRGB
 		);
 	}
@@ -97,35 +97,21 @@ void ULivCaptureCombo::ReleaseRenderTargets()
 
 	TextureTarget = nullptr;
 
-	if (BackgroundRenderTarget)
-	{
-		BackgroundRenderTarget->ReleaseResource();
-		BackgroundRenderTarget = nullptr;
-	}
-
-	if (ForegroundRenderTarget)
-	{
-		ForegroundRenderTarget->ReleaseResource();
-		ForegroundRenderTarget = nullptr;
-	}
-
-	if (ForegroundOutputRenderTarget)
-	{
-		ForegroundOutputRenderTarget->ReleaseResource();
-		ForegroundOutputRenderTarget = nullptr;
-	}
+	ReleaseRenderTarget2D(BackgroundRenderTarget);
+	ReleaseRenderTarget2D(ForegroundRenderTarget);
+	ReleaseRenderTarget2D(ForegroundOutputRenderTarget);
 }
 
 void ULivCaptureCombo::Capture(const FLivCaptureContext& Context)
 {
 	Super::Capture(Context);
 
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
 
 	// set our render targets so we can determine if relevant in scene view ext
 	SceneViewExtension->BackgroundRenderTarget2D = BackgroundRenderTarget;
 	SceneViewExtension->ForegroundRenderTarget2D = ForegroundRenderTarget;
-	//SceneViewExtension->ForegroundOutputRenderTarget2D = ForegroundOutputRenderTarget;
+	SceneViewExtension->ForegroundOutputRenderTarget2D = ForegroundOutputRenderTarget;
 	
 
 	UpdateLivInputFrame(this);
@@ -138,12 +124,29 @@ void ULivCaptureCombo::Capture(const FLivCaptureContext& Context)
 	Context.ApplyHideLists(this);
 	Context.ApplyHideLists(SceneCaptureComponent);
 
+	const ULivPluginSettings* PluginSettings = GetDefault<ULivPluginSettings>();
+	const bool bCompositorSegmentation = ShouldUseCompositorSegmentation();
+
+	// LIV separates the foreground from the background depth with compositor segmentation
+	const bool bCaptureBackground = ShouldCaptureBackground() || bCompositorSegmentation;
+	const bool bCaptureForeground = ShouldCaptureForeground() && !bCompositorSegmentation;
+
+	SceneViewExtension->SetCaptureLayers_GameThread(bCaptureBackground, bCaptureForeground, bCompositorSegmentation);
+
 	// Capture full scene with post processing (RGB)
-	TextureTarget = BackgroundRenderTarget;
-	CaptureSource = SCS_FinalColorLDR;
-	bEnableClipPlane = false;
-	PostProcessSettings = GetDefault<ULivPluginSettings>()->PostProcessSettings;
-	CaptureScene();
+	if (bCaptureBackground)
+	{
+		TextureTarget = BackgroundRenderTarget;
+		CaptureSource = SCS_FinalColorLDR;
+		bEnableClipPlane = false;
+		PostProcessSettings = PluginSettings->PostProcessSettings;
+		CaptureScene();
+	}
+
+	if (!bCaptureForeground)
+	{
+		return;
+	}
 
 	// Calculate clip plane transform
 	const auto VROriginTransform = GetAttachParent()->GetComponentTransform();
@@ -1,3 +1,137 @@
 // Copyright 2021 LIV Inc. - MIT License
 #include "LivCaptureContext.h"
 
+FLivCaptureContext::FLivCaptureContext()
+	: Version(0)
+{
+}
+
+void FLivCaptureContext::HideComponents(TArrayView<UPrimitiveComponent* const> Components)
+{
+	const int32 NumHidden = HiddenComponents.Num();
+
+	for (UPrimitiveComponent* Component : Components)
+	{
+		if (Component)
+		{
+			HiddenComponents.Add(Component);
+		}
+	}
+
+	if (HiddenComponents.Num() != NumHidden)
+	{
+		++Version;
+	}
+}
+
+void FLivCaptureContext::ShowComponents(TArrayView<UPrimitiveComponent* const> Components)
+{
+	int32 NumRemoved = 0;
+
+	for (UPrimitiveComponent* Component : Components)
+	{
+		NumRemoved += HiddenComponents.Remove(Component);
+	}
+
+	if (NumRemoved > 0)
+	{
+		++Version;
+	}
+}
+
+void FLivCaptureContext::ClearHiddenComponents()
+{
+	if (HiddenComponents.Num() > 0)
+	{
+		HiddenComponents.Reset();
+		++Version;
+	}
+}
+
+void FLivCaptureContext::HideActors(TArrayView<AActor* const> Actors)
+{
+	const int32 NumHidden = HiddenActors.Num();
+
+	for (AActor* Actor : Actors)
+	{
+		if (Actor)
+		{
+			HiddenActors.Add(Actor);
+		}
+	}
+
+	if (HiddenActors.Num() != NumHidden)
+	{
+		++Version;
+	}
+}
+
+void FLivCaptureContext::ShowActors(TArrayView<AActor* const> Actors)
+{
+	int32 NumRemoved = 0;
+
+	for (AActor* Actor : Actors)
+	{
+		NumRemoved += HiddenActors.Remove(Actor);
+	}
+
+	if (NumRemoved > 0)
+	{
+		++Version;
+	}
+}
+
+void FLivCaptureContext::ClearHiddenActors()
+{
+	if (HiddenActors.Num() > 0)
+	{
+		HiddenActors.Reset();
+		++Version;
+	}
+}
+
+void FLivCaptureContext::ApplyHideLists(USceneCaptureComponent2D* Component) const
+{
+	uint32* AppliedVersion = AppliedVersions.Find(Component);
+
+	if (AppliedVersion && *AppliedVersion == Version)
+	{
+		return;
+	}
+
+	// the scene capture's lists are arrays, rebuilt once per change rather than diffed entry by entry
+	Component->HiddenComponents.Reset(HiddenComponents.Num());
+
+	for (const TWeakObjectPtr<UPrimitiveComponent>& HiddenComponent : HiddenComponents)
+	{
+		Component->HiddenComponents.Add(HiddenComponent);
+	}
+
+	// destroyed actors drop out of the scene capture's list when they're garbage collected
+	Component->HiddenActors.Reset(HiddenActors.Num());
+
+	for (const TWeakObjectPtr<AActor>& HiddenActor : HiddenActors)
+	{
+		if (AActor* Actor = HiddenActor.Get())
+		{
+			Component->HiddenActors.Add(Actor);
+		}
+	}
+
+	if (AppliedVersion)
+	{
+		*AppliedVersion = Version;
+		return;
+	}
+
+	// new scene capture, forget the destroyed ones
+	for (auto It = AppliedVersions.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	AppliedVersions.Add(Component, Version);
+}
@@ -0,0 +1,517 @@
+// Copyright 2021 LIV Inc. - MIT License
+#include "LivCaptureDualView.h"
+
+#include "CanvasTypes.h"
+#include "EngineModule.h"
+#include "Engine/GameViewportClient.h"
+#include "LegacyScreenPercentageDriver.h"
+#include "LivCaptureAnalyticClipPlane.h"
+#include "LivCaptureContext.h"
+#include "LivForegroundRegion.h"
+#include "LivPassTimings.h"
+#include "LivPluginSettings.h"
+#include "LivRenderPass.h"
+#include "LivSceneViewExtensionDualView.h"
+#include "LivShaders.h"
+#include "PixelShaderUtils.h"
+#include "SceneView.h"
+#include "ScreenPass.h"
+
+ULivCaptureDualView::ULivCaptureDualView(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, SceneRenderTarget(nullptr)
+	, ForegroundOpacityRenderTarget(nullptr)
+	, BackgroundOutputRenderTarget(nullptr)
+	, ForegroundOutputRenderTarget(nullptr)
+	, bRenderPending(false)
+	, bPendingCaptureBackground(false)
+	, bPendingCaptureForeground(false)
+	, PendingClipPlane(ForceInitToZero)
+{
+}
+
+void ULivCaptureDualView::OnActivated()
+{
+	Super::OnActivated();
+
+	if (!SceneViewExtension.IsValid())
+	{
+		// Null viewport should ensure it doesn't run anywhere yet (unless explicitly gathered)
+		SceneViewExtension = FSceneViewExtensions::NewExtension<FLivSceneViewExtensionDualView>(nullptr);
+	}
+
+	PrimitiveRenderMode = ESceneCapturePrimitiveRenderMode::PRM_RenderScenePrimitives;
+	bCaptureEveryFrame = false;
+	bCaptureOnMovement = false;
+
+	// a view state per view for eye adaptation and temporal effects
+	bAlwaysPersistRenderingState = true;
+
+	// render once the game viewport has drawn, see RenderViews
+	if (UGameViewportClient* GameViewport = GetWorld()->GetGameViewport())
+	{
+		EndDrawViewport = GameViewport;
+		EndDrawHandle = GameViewport->OnEndDraw().AddUObject(this, &ULivCaptureDualView::RenderViews);
+	}
+}
+
+void ULivCaptureDualView::OnDeactivated()
+{
+	Super::OnDeactivated();
+
+	if (EndDrawViewport.IsValid())
+	{
+		EndDrawViewport->OnEndDraw().Remove(EndDrawHandle);
+	}
+
+	EndDrawViewport = nullptr;
+	EndDrawHandle.Reset();
+	bRenderPending = false;
+
+	SceneViewExtension = nullptr;
+}
+
+void ULivCaptureDualView::CreateRenderTargets()
+{
+	Super::CreateRenderTargets();
+
+	// Background | Foreground, post processed
+	SceneRenderTarget = CreateRenderTarget2D(
+		GetWorld(),
+		LivInputFrameWidth * 2,
+		LivInputFrameHeight,
+		"SceneRenderTarget",
+		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+	);
+
+	// Foreground inverse opacity, from scene color before post processing
+	ForegroundOpacityRenderTarget = CreateRenderTarget2D(
+		GetWorld(),
+		LivInputFrameWidth,
+		LivInputFrameHeight,
+		"ForegroundOpacityRenderTarget",
+		ETextureRenderTargetFormat::RTF_RGBA16f
+	);
+
+	if (ShouldExtractIntermediates())
+	{
+		// Background output (8bpc)
+		BackgroundOutputRenderTarget = CreateRenderTarget2D(
+			GetWorld(),
+			LivInputFrameWidth,
+			LivInputFrameHeight,
+			"BackgroundOutputRenderTarget",
+			ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+		);
+
+		// Foreground masked
+		ForegroundOutputRenderTarget = CreateRenderTarget2D(
+			GetWorld(),
+			LivInputFrameWidth,
+			LivInputFrameHeight,
+			"ForegroundOutputRenderTarget",
+			ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+		);
+	}
+
+	if (SceneViewExtension.IsValid())
+	{
+		SceneViewExtension->RenderTarget2D = SceneRenderTarget;
+		SceneViewExtension->ForegroundOpacityRenderTarget2D = ForegroundOpacityRenderTarget;
+	}
+}
+
+void ULivCaptureDualView::ReleaseRenderTargets()
+{
+	Super::ReleaseRenderTargets();
+
+	TextureTarget = nullptr;
+
+	ReleaseRenderTarget2D(SceneRenderTarget);
+	ReleaseRenderTarget2D(ForegroundOpacityRenderTarget);
+	ReleaseRenderTarget2D(BackgroundOutputRenderTarget);
+	ReleaseRenderTarget2D(ForegroundOutputRenderTarget);
+}
+
+void ULivCaptureDualView::Capture(const FLivCaptureContext& Context)
+{
+	Super::Capture(Context);
+
+#if LIV_CAPTURE_SUPPORTED
+
+	// the clip plane is set on the foreground view only
+	bEnableClipPlane = false;
+
+	UpdateLivInputFrame(this);
+
+	// set scene capture transform / FOV from input frame data
+	SetSceneCaptureComponentParameters(this);
+
+	// Apply context to scene capture (set hide list), copied to both views
+	Context.ApplyHideLists(this);
+
+	const bool bCaptureBackground = ShouldCaptureBackground();
+	const bool bCaptureForeground = ShouldCaptureForeground();
+
+	if (!bCaptureBackground && !bCaptureForeground)
+	{
+		return;
+	}
+
+	// Calculate clip plane transform
+	const auto VROriginTransform = GetAttachParent()->GetComponentTransform();
+
+	const auto ClipPlaneTransform = InputFrame.CameraClipPlaneMatrix;
+	const auto ClipPlanePosition = VROriginTransform.TransformPosition(ClipPlaneTransform.TransformPosition(FVector::ZeroVector));
+	const auto ClipPlaneForward = VROriginTransform.TransformVector(ClipPlaneTransform.TransformVector(FVector::ForwardVector));
+	const FPlane ClipPlane(ClipPlanePosition, ClipPlaneForward.GetSafeNormal());
+
+	const FIntPoint ViewSize(SceneRenderTarget->SizeX / 2, SceneRenderTarget->SizeY);
+	const bool bForegroundEmpty = bCaptureForeground && IsForegroundEmpty(this, ClipPlane);
+
+	bPendingCaptureBackground = bCaptureBackground;
+	bPendingCaptureForeground = bCaptureForeground;
+	PendingClipPlane = ClipPlane;
+	PendingForegroundRect = bCaptureForeground && !bForegroundEmpty ? GetForegroundRect(ViewSize) : FIntRect();
+	bRenderPending = true;
+
+	if (!EndDrawHandle.IsValid())
+	{
+		// no game viewport (e.g. -nullrhi automation), nothing to render ahead of
+		RenderViews();
+	}
+
+#endif
+}
+
+void ULivCaptureDualView::RenderViews()
+{
+#if LIV_CAPTURE_SUPPORTED
+
+	if (!bRenderPending || !SceneRenderTarget || !ForegroundOpacityRenderTarget)
+	{
+		return;
+	}
+
+	bRenderPending = false;
+
+	UWorld* World = GetWorld();
+
+	if (!World || !World->Scene)
+	{
+		return;
+	}
+
+	const bool bCaptureBackground = bPendingCaptureBackground;
+	const bool bCaptureForeground = bPendingCaptureForeground;
+
+	TextureTarget = SceneRenderTarget;
+	PostProcessSettings = GetDefault<ULivPluginSettings>()->PostProcessSettings;
+
+	FTextureRenderTargetResource* SceneRenderTargetResource = SceneRenderTarget->GameThread_GetRenderTargetResource();
+
+	FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(
+			SceneRenderTargetResource,
+			World->Scene,
+			ShowFlags)
+		.SetResolveScene(true)
+		.SetRealtimeUpdate(true)
+		.SetWorldTimes(World->GetTimeSeconds(), World->GetDeltaSeconds(), World->GetRealTimeSeconds()));
+
+	ViewFamily.SceneCaptureSource = SCS_FinalColorLDR;
+	ViewFamily.ViewExtensions = GEngine->ViewExtensions->GatherActiveExtensions(FSceneViewExtensionContext(World->Scene));
+
+	for (const FSceneViewExtensionRef& Extension : ViewFamily.ViewExtensions)
+	{
+		Extension->SetupViewFamily(ViewFamily);
+	}
+
+	const int32 ViewWidth = SceneRenderTarget->SizeX / 2;
+	const int32 ViewHeight = SceneRenderTarget->SizeY;
+	const FIntRect FullRect(0, 0, ViewWidth, ViewHeight);
+	const FIntRect ForegroundRect = PendingForegroundRect;
+
+	FSceneView* BackgroundView = nullptr;
+
+	if (bCaptureBackground)
+	{
+		BackgroundView = AddView(ViewFamily, 0, FullRect, FullRect);
+	}
+
+	// an empty region still submits a cleared foreground
+	if (bCaptureForeground && ForegroundRect.Area() > 0)
+	{
+		FSceneView* ForegroundView = AddView(ViewFamily, 1, FIntRect(ViewWidth, 0, ViewWidth * 2, ViewHeight), ForegroundRect);
+		ForegroundView->GlobalClippingPlane = PendingClipPlane;
+
+#if !WITH_EYE_ADAPTATION_CALLBACK
+		// the foreground would meter its exposure on the clipped scene and come out darker than the background,
+		// without the engine's eye adaptation callback to share the background's (see FLivSceneViewExtensionDualView)
+		// both views are pinned to the manual exposure of the post process settings instead
+		ForegroundView->FinalPostProcessSettings.AutoExposureMethod = EAutoExposureMethod::AEM_Manual;
+
+		if (BackgroundView)
+		{
+			BackgroundView->FinalPostProcessSettings.AutoExposureMethod = EAutoExposureMethod::AEM_Manual;
+		}
+#endif
+	}
+
+	if (ViewFamily.Views.Num() > 0)
+	{
+		ViewFamily.SetScreenPercentageInterface(new FLegacyScreenPercentageDriver(ViewFamily, 1.0f, false));
+
+		for (const FSceneViewExtensionRef& Extension : ViewFamily.ViewExtensions)
+		{
+			Extension->BeginRenderViewFamily(ViewFamily);
+		}
+
+		// Render both views, one scene renderer for the family. Like CaptureScene this sends the world's end of frame
+		// updates, unlike it it also increments the scene's frame number (as any other viewport would), updates planar
+		// reflections for these views and flushes deferred scene captures. Rendering after the game viewport has drawn
+		// leaves the game's own deferred captures and planar reflections to its viewport and the tick untouched
+		FCanvas Canvas(SceneRenderTargetResource, nullptr, World, World->Scene->GetFeatureLevel(), FCanvas::CDM_DeferDrawing, 1.0f);
+		Canvas.Clear(FLinearColor::Transparent);
+
+		GetRendererModule().BeginRenderingViewFamily(&Canvas, &ViewFamily);
+	}
+
+	// foreground region in output UVs, min (xy) max (zw)
+	const FVector4 ForegroundRegion(
+		static_cast<float>(ForegroundRect.Min.X) / ViewWidth,
+		static_cast<float>(ForegroundRect.Min.Y) / ViewHeight,
+		static_cast<float>(ForegroundRect.Max.X) / ViewWidth,
+		static_cast<float>(ForegroundRect.Max.Y) / ViewHeight);
+
+	const ERHIFeatureLevel::Type FeatureLevel = World->Scene->GetFeatureLevel();
+
+	FTextureResource* SceneResource = SceneRenderTarget->Resource;
+	FTextureResource* ForegroundOpacityResource = ForegroundOpacityRenderTarget->Resource;
+
+	// the segmented outputs are allocated in the graph, these only exist to extract them for debugging
+	FTextureResource* DebugForegroundOutputResource = ForegroundOutputRenderTarget ? ForegroundOutputRenderTarget->Resource : nullptr;
+	FTextureResource* DebugBackgroundOutputResource = BackgroundOutputRenderTarget ? BackgroundOutputRenderTarget->Resource : nullptr;
+
+	ENQUEUE_RENDER_COMMAND(LivRDGCaptureDualView)(
+		[FeatureLevel, SceneResource, ForegroundOpacityResource, DebugForegroundOutputResource, DebugBackgroundOutputResource, bCaptureBackground, bCaptureForeground, ForegroundRegion](FRHICommandListImmediate& RHICmdList)
+		{
+			FRDGBuilder GraphBuilder(RHICmdList);
+
+			{
+				RDG_EVENT_SCOPE(GraphBuilder, "Liv Capture Dual View");
+				LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
+
+				const auto GlobalShaderMap = GetGlobalShaderMap(FeatureLevel);
+				const FIntPoint OutputExtent(ForegroundOpacityResource->GetSizeX(), ForegroundOpacityResource->GetSizeY());
+
+				const FRDGTextureRef OutputForegroundTexture = FLivRenderPass::CreateIntermediateTexture(
+					GraphBuilder,
+					OutputExtent,
+					LIV_TEXTURE_FOREGROUND_COLOR_BUFFER_ID,
+					TEXT("Foreground Output")
+				);
+
+				const FRDGTextureRef OutputBackgroundTexture = FLivRenderPass::CreateIntermediateTexture(
+					GraphBuilder,
+					OutputExtent,
+					LIV_TEXTURE_BACKGROUND_COLOR_BUFFER_ID,
+					TEXT("Background Output")
+				);
+
+				{
+					RDG_EVENT_SCOPE(GraphBuilder, "Liv Segment Dual View");
+
+					const TShaderMapRef<FLivRDGScreenPassVS> VertexShader(GlobalShaderMap);
+					const TShaderMapRef<FLivRDGSegmentDualViewPS> PixelShader(GlobalShaderMap);
+
+					FLivRDGSegmentDualViewPS::FParameters* Parameters = GraphBuilder.AllocParameters<FLivRDGSegmentDualViewPS::FParameters>();
+					Parameters->InputSceneTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(GraphBuilder, SceneResource, TEXT("LivDualViewScene"));
+					Parameters->InputSceneSampler = TStaticSamplerState<>::GetRHI();
+					Parameters->InputForegroundOpacityTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(GraphBuilder, ForegroundOpacityResource, TEXT("LivForegroundOpacity"));
+					Parameters->InputForegroundOpacitySampler = TStaticSamplerState<>::GetRHI();
+
+					// background left, foreground right
+					Parameters->BackgroundUVScaleBias = FVector4(0.5f, 1.0f, 0.0f, 0.0f);
+					Parameters->ForegroundUVScaleBias = FVector4(0.5f, 1.0f, 0.5f, 0.0f);
+					Parameters->ForegroundRegion = ForegroundRegion;
+
+					Parameters->RenderTargets[0] = FRenderTargetBinding(OutputForegroundTexture, ERenderTargetLoadAction::EClear, 0);
+					Parameters->RenderTargets[1] = FRenderTargetBinding(OutputBackgroundTexture, ERenderTargetLoadAction::EClear, 0);
+
+					const FScreenPassTextureViewport ScreenPassTextureViewport(OutputForegroundTexture);
+					const FScreenPassPipelineState PipelineState(VertexShader, PixelShader);
+
+					FLivRenderPass::AddLivPass(
+						GraphBuilder,
+						RDG_EVENT_NAME("Liv RDG Segment Dual View Pass"),
+						ScreenPassTextureViewport,
+						PipelineState,
+						PixelShader,
+						Parameters
+					);
+
+					FLivRenderPass::AddExtractPass(GraphBuilder, OutputForegroundTexture, DebugForegroundOutputResource);
+					FLivRenderPass::AddExtractPass(GraphBuilder, OutputBackgroundTexture, DebugBackgroundOutputResource);
+				}
+
+				{
+					RDG_EVENT_SCOPE(GraphBuilder, "Liv Submit");
+
+					FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
+					Parameters->ForegroundTexture = bCaptureForeground ? OutputForegroundTexture : nullptr;
+					Parameters->BackgroundTexture = bCaptureBackground ? OutputBackgroundTexture : nullptr;
+
+					FLivRenderPass::AddSubmitPass(GraphBuilder, Parameters);
+				}
+			}
+
+			GraphBuilder.Execute();
+		});
+
+#endif
+}
+
+FSceneView* ULivCaptureDualView::AddView(FSceneViewFamily& ViewFamily, int32 ViewIndex, const FIntRect& ViewRect, const FIntRect& CropRect)
+{
+	const FVector ViewLocation = GetComponentLocation();
+
+	FSceneViewInitOptions ViewInitOptions;
+	ViewInitOptions.SetViewRectangle(FIntRect(ViewRect.Min + CropRect.Min, ViewRect.Min + CropRect.Max));
+	ViewInitOptions.ViewFamily = &ViewFamily;
+	ViewInitOptions.ViewActor = GetViewOwner();
+	ViewInitOptions.ViewOrigin = ViewLocation;
+	ViewInitOptions.ViewRotationMatrix = GetViewRotationMatrix();
+	ViewInitOptions.ProjectionMatrix = FLivForegroundRegion::CropProjectionMatrix(GetProjectionMatrix(ViewRect.Size()), CropRect, ViewRect.Size());
+
+	ViewInitOptions.FOV = FOVAngle;
+	ViewInitOptions.DesiredFOV = FOVAngle;
+	ViewInitOptions.BackgroundColor = FLinearColor::Black;
+	ViewInitOptions.OverrideFarClippingPlaneDistance = MaxViewDistanceOverride;
+	ViewInitOptions.SceneViewStateInterface = GetViewState(ViewIndex);
+	ViewInitOptions.StereoPass = eSSP_FULL;
+	ViewInitOptions.LODDistanceFactor = FMath::Clamp(LODDistanceFactor, 0.01f, 100.0f);
+	ViewInitOptions.bUseFieldOfViewForLOD = bUseFieldOfViewForLOD;
+
+	FSceneView* View = new FSceneView(ViewInitOptions);
+	View->bIsSceneCapture = true;
+
+	// the hide lists of the component apply to both views
+	for (const TWeakObjectPtr<UPrimitiveComponent>& HiddenComponent : HiddenComponents)
+	{
+		if (const UPrimitiveComponent* PrimitiveComponent = HiddenComponent.Get())
+		{
+			View->HiddenPrimitives.Add(PrimitiveComponent->ComponentId);
+		}
+	}
+
+	for (const AActor* HiddenActor : HiddenActors)
+	{
+		if (!HiddenActor)
+		{
+			continue;
+		}
+
+		for (const UActorComponent* Component : HiddenActor->GetComponents())
+		{
+			if (const UPrimitiveComponent* PrimitiveComponent = Cast<UPrimitiveComponent>(Component))
+			{
+				View->HiddenPrimitives.Add(PrimitiveComponent->ComponentId);
+			}
+		}
+	}
+
+	if (PrimitiveRenderMode == ESceneCapturePrimitiveRenderMode::PRM_UseShowOnlyList)
+	{
+		View->ShowOnlyPrimitives.Emplace();
+
+		for (const TWeakObjectPtr<UPrimitiveComponent>& ShowOnlyComponent : ShowOnlyComponents)
+		{
+			if (const UPrimitiveComponent* PrimitiveComponent = ShowOnlyComponent.Get())
+			{
+				View->ShowOnlyPrimitives->Add(PrimitiveComponent->ComponentId);
+			}
+		}
+
+		for (const AActor* ShowOnlyActor : ShowOnlyActors)
+		{
+			if (!ShowOnlyActor)
+			{
+				continue;
+			}
+
+			for (const UActorComponent* Component : ShowOnlyActor->GetComponents())
+			{
+				if (const UPrimitiveComponent* PrimitiveComponent = Cast<UPrimitiveComponent>(Component))
+				{
+					View->ShowOnlyPrimitives->Add(PrimitiveComponent->ComponentId);
+				}
+			}
+		}
+	}
+
+	ViewFamily.Views.Add(View);
+
+	View->StartFinalPostprocessSettings(ViewLocation);
+	View->OverridePostProcessSettings(PostProcessSettings, PostProcessBlendWeight);
+	View->EndFinalPostprocessSettings(ViewInitOptions);
+
+	for (const FSceneViewExtensionRef& Extension : ViewFamily.ViewExtensions)
+	{
+		Extension->SetupView(ViewFamily, *View);
+	}
+
+	return View;
+}
+
+FMatrix ULivCaptureDualView::GetViewRotationMatrix() const
+{
+	// unreal to view space axes
+	return FInverseRotationMatrix(GetComponentRotation()) * FMatrix(
+		FPlane(0, 0, 1, 0),
+		FPlane(1, 0, 0, 0),
+		FPlane(0, 1, 0, 0),
+		FPlane(0, 0, 0, 1));
+}
+
+FMatrix ULivCaptureDualView::GetProjectionMatrix(const FIntPoint& ViewSize) const
+{
+	const float HalfFOV = FMath::Max(0.001f, FOVAngle) * static_cast<float>(PI) / 360.0f;
+	const float XAxisMultiplier = ViewSize.X > ViewSize.Y ? 1.0f : static_cast<float>(ViewSize.Y) / ViewSize.X;
+	const float YAxisMultiplier = ViewSize.X > ViewSize.Y ? static_cast<float>(ViewSize.X) / ViewSize.Y : 1.0f;
+
+	return FReversedZPerspectiveMatrix(HalfFOV, HalfFOV, XAxisMultiplier, YAxisMultiplier, GNearClippingPlane, GNearClippingPlane);
+}
+
+FIntRect ULivCaptureDualView::GetForegroundRect(const FIntPoint& ViewSize) const
+{
+	const FIntRect FullRect(FIntPoint::ZeroValue, ViewSize);
+	const ULivPluginSettings* Settings = GetDefault<ULivPluginSettings>();
+
+	if (!Settings->bLimitForegroundToPlayer)
+	{
+		return FullRect;
+	}
+
+	// without a player there's nothing to limit the foreground to
+	const FBox PlayerBounds = FLivForegroundRegion::GetPlayerBounds(GetWorld());
+
+	if (!PlayerBounds.IsValid)
+	{
+		return FullRect;
+	}
+
+	const FTransform VROriginTransform = GetAttachParent()->GetComponentTransform();
+	const FVector CameraLocation = GetComponentLocation();
+
+	TArray<FPlane, TInlineAllocator<2>> Planes;
+	Planes.Add(ULivCaptureAnalyticClipPlane::MakeCameraSidePlane(InputFrame.CameraClipPlaneMatrix, VROriginTransform, CameraLocation));
+
+	if (InputFrame.bFloorClipPlaneEnabled)
+	{
+		Planes.Add(ULivCaptureAnalyticClipPlane::MakeCameraSidePlane(InputFrame.FloorClipPlaneMatrix, VROriginTransform, CameraLocation));
+	}
+
+	const FMatrix ViewProjectionMatrix = FTranslationMatrix(-CameraLocation) * GetViewRotationMatrix() * GetProjectionMatrix(ViewSize);
+
+	return FLivForegroundRegion::Compute(PlayerBounds, Planes, ViewProjectionMatrix, ViewSize, Settings->ForegroundRegionPadding);
+}
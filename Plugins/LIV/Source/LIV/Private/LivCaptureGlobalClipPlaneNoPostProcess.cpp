@@ -5,6 +5,7 @@
 #include "LivConversions.h"
 #include "LivClipPlane.h"
 #include "LivCaptureContext.h"
+#include "LivPassTimings.h"
 #include "LivRenderPass.h"
 #include "LivShaders.h"
 #include "PixelShaderUtils.h"
@@ -60,14 +61,17 @@ void ULivCaptureGlobalClipPlaneNoPostProcess::CreateRenderTargets()
 		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
 	);
 
-	// Foreground masked
-	ForegroundMaskedRenderTarget = CreateRenderTarget2D(
-		GetWorld(),
-		LivInputFrameWidth,
-		LivInputFrameHeight,
-		"ForegroundMaskedRenderTarget",
-		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
-	);
+	if (ShouldExtractIntermediates())
+	{
+		// Foreground masked
+		ForegroundMaskedRenderTarget = CreateRenderTarget2D(
+			GetWorld(),
+			LivInputFrameWidth,
+			LivInputFrameHeight,
+			"ForegroundMaskedRenderTarget",
+			ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+		);
+	}
 }
 
 void ULivCaptureGlobalClipPlaneNoPostProcess::ReleaseRenderTargets()
@@ -76,30 +80,16 @@ void ULivCaptureGlobalClipPlaneNoPostProcess::ReleaseRenderTargets()
 
 	TextureTarget = nullptr;
 
-	if (BackgroundRenderTarget)
-	{
-		BackgroundRenderTarget->ReleaseResource();
-		BackgroundRenderTarget = nullptr;
-	}
-
-	if (ForegroundRenderTarget)
-	{
-		ForegroundRenderTarget->ReleaseResource();
-		ForegroundRenderTarget = nullptr;
-	}
-
-	if (ForegroundMaskedRenderTarget)
-	{
-		ForegroundMaskedRenderTarget->ReleaseResource();
-		ForegroundMaskedRenderTarget = nullptr;
-	}
+	ReleaseRenderTarget2D(BackgroundRenderTarget);
+	ReleaseRenderTarget2D(ForegroundRenderTarget);
+	ReleaseRenderTarget2D(ForegroundMaskedRenderTarget);
 }
 
 void ULivCaptureGlobalClipPlaneNoPostProcess::Capture(const FLivCaptureContext& Context)
 {
 	Super::Capture(Context);
 
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
 
 	UWorld* World = GetWorld();
 
@@ -111,11 +101,17 @@ void ULivCaptureGlobalClipPlaneNoPostProcess::Capture(const FLivCaptureContext&
 	// Apply context to scene capture (set hide list)
 	Context.ApplyHideLists(this);
 
-	// Capture Background
-	TextureTarget = BackgroundRenderTarget;
-	CaptureSource = SCS_SceneColorHDRNoAlpha;
-	bEnableClipPlane = false;
-	CaptureScene();
+	const bool bCaptureBackground = ShouldCaptureBackground();
+	const bool bCaptureForeground = ShouldCaptureForeground();
+
+	// Capture Background, the last one is submitted again when nothing changed
+	if (ShouldRenderBackground(this, bCaptureBackground))
+	{
+		TextureTarget = BackgroundRenderTarget;
+		CaptureSource = SCS_SceneColorHDRNoAlpha;
+		bEnableClipPlane = false;
+		CaptureScene();
+	}
 
 	// Calculate clip plane transform
 	const auto VROriginTransform = GetAttachParent()->GetComponentTransform();
@@ -125,40 +121,57 @@ void ULivCaptureGlobalClipPlaneNoPostProcess::Capture(const FLivCaptureContext&
 	const auto ClipPlaneForward = VROriginTransform.TransformVector(ClipPlaneTransform.TransformVector(FVector::ForwardVector));
 
 	FTextureResource* InputResource = ForegroundRenderTarget->Resource;
-	FTextureResource* OutputResource = ForegroundMaskedRenderTarget->Resource;
+	FTextureResource* DebugOutputResource = ForegroundMaskedRenderTarget ? ForegroundMaskedRenderTarget->Resource : nullptr;
 
-	// Capture Foreground
-	ClipPlaneBase = ClipPlanePosition;
-	ClipPlaneNormal = ClipPlaneForward;
-	TextureTarget = ForegroundRenderTarget;
-	CaptureSource = SCS_SceneColorHDR;
-	bEnableClipPlane = true;
-	CaptureScene();
+	// Capture Foreground, unless nothing can be in front of the clip plane
+	const bool bForegroundEmpty = bCaptureForeground && IsForegroundEmpty(this, FPlane(ClipPlanePosition, ClipPlaneForward.GetSafeNormal()));
 
-	const ERHIFeatureLevel::Type FeatureLevel = World->Scene->GetFeatureLevel();
+	if (bCaptureForeground && !bForegroundEmpty)
+	{
+		ClipPlaneBase = ClipPlanePosition;
+		ClipPlaneNormal = ClipPlaneForward;
+		TextureTarget = ForegroundRenderTarget;
+		CaptureSource = SCS_SceneColorHDR;
+		bEnableClipPlane = true;
+		BeginForegroundCulling(this);
+		CaptureScene();
+		EndForegroundCulling(this);
+	}
 
-	// @TODO:	we only need RTs for captured textures, intermediate/processed textures
-	//			can be allocate in RDG (though it will make the debug window less useful)
+	const ERHIFeatureLevel::Type FeatureLevel = World->Scene->GetFeatureLevel();
 
+	// only the scene captures are render targets, the masked foreground is allocated in the graph
 	FTextureResource* BackgroundResource = BackgroundRenderTarget->Resource;
 	
 	ENQUEUE_RENDER_COMMAND(LivRDGCaptureGlobalClipPlaneNoPostProcess)(
-	[FeatureLevel, InputResource, OutputResource, BackgroundResource](FRHICommandListImmediate& RHICmdList)
+	[FeatureLevel, InputResource, DebugOutputResource, BackgroundResource, bCaptureBackground, bCaptureForeground, bForegroundEmpty](FRHICommandListImmediate& RHICmdList)
 	{
 		FRDGBuilder GraphBuilder(RHICmdList);
 
 		{
 			RDG_EVENT_SCOPE(GraphBuilder, "Liv Capture Global Clip Plane No PostProcess");
+			LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
 
 			const auto GlobalShaderMap = GetGlobalShaderMap(FeatureLevel);
 
-			const FRDGTextureRef OutputTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(
-				GraphBuilder,
-				OutputResource,
-				TEXT("LivInvertedAlpha")
-			);
+			const FIntPoint OutputExtent(InputResource->GetSizeX(), InputResource->GetSizeY());
+
+			FRDGTextureRef OutputTexture = nullptr;
 
+			if (bForegroundEmpty)
 			{
+				OutputTexture = FLivRenderPass::GetTransparentTexture(GraphBuilder, OutputExtent);
+				FLivRenderPass::AddExtractPass(GraphBuilder, OutputTexture, DebugOutputResource);
+			}
+			else if (bCaptureForeground)
+			{
+				OutputTexture = FLivRenderPass::CreateIntermediateTexture(
+					GraphBuilder,
+					OutputExtent,
+					LIV_TEXTURE_FOREGROUND_COLOR_BUFFER_ID,
+					TEXT("LivInvertedAlpha")
+				);
+
 				RDG_EVENT_SCOPE(GraphBuilder, "Liv RDG Invert Alpha");
 
 				const TShaderMapRef<FLivRDGScreenPassVS> VertexShader(GlobalShaderMap);
@@ -182,6 +195,8 @@ void ULivCaptureGlobalClipPlaneNoPostProcess::Capture(const FLivCaptureContext&
 					PixelShader, 
 					Parameters
 				);
+
+				FLivRenderPass::AddExtractPass(GraphBuilder, OutputTexture, DebugOutputResource);
 			}
 
 			{
@@ -189,11 +204,11 @@ void ULivCaptureGlobalClipPlaneNoPostProcess::Capture(const FLivCaptureContext&
 
 				FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
 				Parameters->ForegroundTexture = OutputTexture;
-				Parameters->BackgroundTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(
+				Parameters->BackgroundTexture = bCaptureBackground ? FLivRenderPass::CreateRDGTextureFromRenderTarget(
 					GraphBuilder,
 					BackgroundResource,
 					TEXT("LivBackground")
-				);
+				) : nullptr;
 
 				FLivRenderPass::AddSubmitPass(GraphBuilder, Parameters);
 			}
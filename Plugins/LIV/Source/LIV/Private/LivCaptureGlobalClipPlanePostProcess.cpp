@@ -7,6 +7,7 @@
 #include "LivConversions.h"
 #include "LivClipPlane.h"
 #include "LivCaptureContext.h"
+#include "LivPassTimings.h"
 #include "LivPluginSettings.h"
 #include "LivRenderPass.h"
 #include "LivShaders.h"
@@ -85,14 +86,17 @@ void ULivCaptureGlobalClipPlanePostProcess::CreateRenderTargets()
 		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
 	);
 
-	// Output foreground masked 8bpc
-	ForegroundOutputRenderTarget = CreateRenderTarget2D(
-		GetWorld(),
-		LivInputFrameWidth,
-		LivInputFrameHeight,
-		"ForegroundMaskedRenderTarget",
-		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
-	);
+	if (ShouldExtractIntermediates())
+	{
+		// Output foreground masked 8bpc
+		ForegroundOutputRenderTarget = CreateRenderTarget2D(
+			GetWorld(),
+			LivInputFrameWidth,
+			LivInputFrameHeight,
+			"ForegroundMaskedRenderTarget",
+			ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+		);
+	}
 }
 
 void ULivCaptureGlobalClipPlanePostProcess::ReleaseRenderTargets()
@@ -104,36 +108,17 @@ void ULivCaptureGlobalClipPlanePostProcess::ReleaseRenderTargets()
 		SceneCaptureComponent->TextureTarget = nullptr;
 	}
 
-	if (PostProcessedBackgroundRenderTarget)
-	{
-		PostProcessedBackgroundRenderTarget->ReleaseResource();
-		PostProcessedBackgroundRenderTarget = nullptr;
-	}
-
-	if (PostProcessedForegroundRenderTarget)
-	{
-		PostProcessedForegroundRenderTarget->ReleaseResource();
-		PostProcessedForegroundRenderTarget = nullptr;
-	}
-
-	if (ForegroundInverseOpacityRenderTarget)
-	{
-		ForegroundInverseOpacityRenderTarget->ReleaseResource();
-		ForegroundInverseOpacityRenderTarget = nullptr;
-	}
-
-	if (ForegroundOutputRenderTarget)
-	{
-		ForegroundOutputRenderTarget->ReleaseResource();
-		ForegroundOutputRenderTarget = nullptr;
-	}
+	ReleaseRenderTarget2D(PostProcessedBackgroundRenderTarget);
+	ReleaseRenderTarget2D(PostProcessedForegroundRenderTarget);
+	ReleaseRenderTarget2D(ForegroundInverseOpacityRenderTarget);
+	ReleaseRenderTarget2D(ForegroundOutputRenderTarget);
 }
 
 void ULivCaptureGlobalClipPlanePostProcess::Capture(const FLivCaptureContext& Context)
 {
 	Super::Capture(Context);
 
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
 
 	UWorld* World = GetWorld();
 
@@ -147,12 +132,19 @@ void ULivCaptureGlobalClipPlanePostProcess::Capture(const FLivCaptureContext& Co
 	Context.ApplyHideLists(this);
 	Context.ApplyHideLists(SceneCaptureComponent);
 
-	// Capture full scene with post processing (RGB)
-	TextureTarget = PostProcessedBackgroundRenderTarget;
-	CaptureSource = SCS_FinalColorLDR;
-	bEnableClipPlane = false;
+	const bool bCaptureBackground = ShouldCaptureBackground();
+	const bool bCaptureForeground = ShouldCaptureForeground();
+
+	// Capture full scene with post processing (RGB), the last one is submitted again when nothing changed
 	PostProcessSettings = GetDefault<ULivPluginSettings>()->PostProcessSettings;
-	CaptureScene();
+	const bool bRenderBackground = ShouldRenderBackground(this, bCaptureBackground);
+	if (bRenderBackground)
+	{
+		TextureTarget = PostProcessedBackgroundRenderTarget;
+		CaptureSource = SCS_FinalColorLDR;
+		bEnableClipPlane = false;
+		CaptureScene();
+	}
 
 	// Calculate clip plane transform
 	const auto VROriginTransform = GetAttachParent()->GetComponentTransform();
@@ -161,47 +153,81 @@ void ULivCaptureGlobalClipPlanePostProcess::Capture(const FLivCaptureContext& Co
 	const auto ClipPlanePosition = VROriginTransform.TransformPosition(ClipPlaneTransform.TransformPosition(FVector::ZeroVector));
 	const auto ClipPlaneForward = VROriginTransform.TransformVector(ClipPlaneTransform.TransformVector(FVector::ForwardVector));
 
-	// Capture foreground scene with post processing (RGB)
-	ClipPlaneBase = ClipPlanePosition;
-	ClipPlaneNormal = ClipPlaneForward;
-	bEnableClipPlane = true;
-	TextureTarget = PostProcessedForegroundRenderTarget;
-	CaptureSource = SCS_FinalColorLDR;
-	CaptureScene();
-
-	// Capture foreground scene, no post processing for it's alpha channel 
-	SceneCaptureComponent->ClipPlaneBase = ClipPlanePosition;
-	SceneCaptureComponent->ClipPlaneNormal = ClipPlaneForward;
-	SceneCaptureComponent->bEnableClipPlane = true;
-	SceneCaptureComponent->TextureTarget = ForegroundInverseOpacityRenderTarget;
-	SceneCaptureComponent->CaptureSource = SCS_SceneColorHDR; // deliberately not LDR
-	SceneCaptureComponent->CaptureScene();
+	// nothing can be in front of the clip plane, submit a transparent foreground instead
+	const bool bForegroundEmpty = bCaptureForeground && IsForegroundEmpty(this, FPlane(ClipPlanePosition, ClipPlaneForward.GetSafeNormal()));
+
+	if (bCaptureForeground && !bForegroundEmpty)
+	{
+		// Capture foreground scene with post processing (RGB)
+		ClipPlaneBase = ClipPlanePosition;
+		ClipPlaneNormal = ClipPlaneForward;
+		bEnableClipPlane = true;
+		TextureTarget = PostProcessedForegroundRenderTarget;
+		CaptureSource = SCS_FinalColorLDR;
+
+		if (bCaptureBackground && !bRenderBackground)
+		{
+			// the foreground shares the background's view state, while the background is reused
+			// hold its eye adaptation rather than let the clipped scene drive it
+			PostProcessSettings.bOverride_AutoExposureSpeedUp = true;
+			PostProcessSettings.AutoExposureSpeedUp = 0.0f;
+			PostProcessSettings.bOverride_AutoExposureSpeedDown = true;
+			PostProcessSettings.AutoExposureSpeedDown = 0.0f;
+		}
+
+		BeginForegroundCulling(this);
+		CaptureScene();
+		EndForegroundCulling(this);
+
+		// Capture foreground scene, no post processing for it's alpha channel 
+		SceneCaptureComponent->ClipPlaneBase = ClipPlanePosition;
+		SceneCaptureComponent->ClipPlaneNormal = ClipPlaneForward;
+		SceneCaptureComponent->bEnableClipPlane = true;
+		SceneCaptureComponent->TextureTarget = ForegroundInverseOpacityRenderTarget;
+		SceneCaptureComponent->CaptureSource = SCS_SceneColorHDR; // deliberately not LDR
+		SetCaptureUsesLighting(SceneCaptureComponent, false); // only the opacity is used
+		BeginForegroundCulling(SceneCaptureComponent);
+		SceneCaptureComponent->CaptureScene();
+		EndForegroundCulling(SceneCaptureComponent);
+	}
 
 	const ERHIFeatureLevel::Type FeatureLevel = World->Scene->GetFeatureLevel();
 
-	// @TODO:	we only need RTs for captured textures, intermediate/processed textures
-	//			can be allocate in RDG (though it will make the debug window less useful)
+	// only the scene captures are render targets, the combined foreground is allocated in the graph
 	FTextureResource* InputColorResource = PostProcessedForegroundRenderTarget->Resource;
 	FTextureResource* InputAlphaResource = ForegroundInverseOpacityRenderTarget->Resource;
-	FTextureResource* OutputResource = ForegroundOutputRenderTarget->Resource;
+	FTextureResource* DebugOutputResource = ForegroundOutputRenderTarget ? ForegroundOutputRenderTarget->Resource : nullptr;
 	FTextureResource* BackgroundResource = PostProcessedBackgroundRenderTarget->Resource;
 
 	ENQUEUE_RENDER_COMMAND(LivRDGCaptureGlobalClipPlanePostProcess)(
-		[FeatureLevel, InputColorResource, InputAlphaResource, OutputResource, BackgroundResource](FRHICommandListImmediate& RHICmdList)
+		[FeatureLevel, InputColorResource, InputAlphaResource, DebugOutputResource, BackgroundResource, bCaptureBackground, bCaptureForeground, bForegroundEmpty](FRHICommandListImmediate& RHICmdList)
 		{
 			FRDGBuilder GraphBuilder(RHICmdList);
 
 			{
 				RDG_EVENT_SCOPE(GraphBuilder, "Liv Capture Global Clip Plane PostProcess");
+				LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
 
 				const auto GlobalShaderMap = GetGlobalShaderMap(FeatureLevel);
 
-				const FRDGTextureRef OutputTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(
-					GraphBuilder,
-					OutputResource,
-					TEXT("LivCombinedAlpha"));
+				const FIntPoint OutputExtent(InputColorResource->GetSizeX(), InputColorResource->GetSizeY());
 
+				FRDGTextureRef OutputTexture = nullptr;
+
+				if (bForegroundEmpty)
+				{
+					OutputTexture = FLivRenderPass::GetTransparentTexture(GraphBuilder, OutputExtent);
+					FLivRenderPass::AddExtractPass(GraphBuilder, OutputTexture, DebugOutputResource);
+				}
+				else if (bCaptureForeground)
 				{
+					OutputTexture = FLivRenderPass::CreateIntermediateTexture(
+						GraphBuilder,
+						OutputExtent,
+						LIV_TEXTURE_FOREGROUND_COLOR_BUFFER_ID,
+						TEXT("LivCombinedAlpha")
+					);
+
 					RDG_EVENT_SCOPE(GraphBuilder, "Liv RDG Combine Alpha");
 
 					const TShaderMapRef<FLivRDGScreenPassVS> VertexShader(GlobalShaderMap);
@@ -225,6 +251,8 @@ void ULivCaptureGlobalClipPlanePostProcess::Capture(const FLivCaptureContext& Co
 						PixelShader,
 						Parameters
 					);
+
+					FLivRenderPass::AddExtractPass(GraphBuilder, OutputTexture, DebugOutputResource);
 				}
 
 				{
@@ -232,11 +260,11 @@ void ULivCaptureGlobalClipPlanePostProcess::Capture(const FLivCaptureContext& Co
 
 					FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
 					Parameters->ForegroundTexture = OutputTexture;
-					Parameters->BackgroundTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(
+					Parameters->BackgroundTexture = bCaptureBackground ? FLivRenderPass::CreateRDGTextureFromRenderTarget(
 						GraphBuilder,
 						BackgroundResource,
 						TEXT("LivBackground")
-					);
+					) : nullptr;
 
 					FLivRenderPass::AddSubmitPass(GraphBuilder, Parameters);
 				}
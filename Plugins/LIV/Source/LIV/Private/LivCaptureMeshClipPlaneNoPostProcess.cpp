@@ -7,10 +7,12 @@
 #include "LivConversions.h"
 #include "LivClipPlane.h"
 #include "LivCaptureContext.h"
+#include "LivPassTimings.h"
 #include "LivPluginSettings.h"
 #include "LivRenderPass.h"
 #include "LivShaders.h"
 #include "PixelShaderUtils.h"
+#include "RenderUtils.h"
 #include "SceneFilterRendering.h"
 #include "ScreenPass.h"
 
@@ -84,23 +86,26 @@ void ULivCaptureMeshClipPlaneNoPostProcess::CreateRenderTargets()
 		ETextureRenderTargetFormat::RTF_R16f
 	);
 
-	// Background output (8bpc)
-	BackgroundOutputRenderTarget = CreateRenderTarget2D(
-		GetWorld(),
-		LivInputFrameWidth,
-		LivInputFrameHeight,
-		"BackgroundOutputRenderTarget",
-		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
-	);
-
-	// Foreground masked
-	ForegroundOutputRenderTarget = CreateRenderTarget2D(
-		GetWorld(),
-		LivInputFrameWidth,
-		LivInputFrameHeight,
-		"ForegroundOutputRenderTarget",
-		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
-	);
+	if (ShouldExtractIntermediates())
+	{
+		// Background output (8bpc)
+		BackgroundOutputRenderTarget = CreateRenderTarget2D(
+			GetWorld(),
+			LivInputFrameWidth,
+			LivInputFrameHeight,
+			"BackgroundOutputRenderTarget",
+			ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+		);
+
+		// Foreground masked
+		ForegroundOutputRenderTarget = CreateRenderTarget2D(
+			GetWorld(),
+			LivInputFrameWidth,
+			LivInputFrameHeight,
+			"ForegroundOutputRenderTarget",
+			ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+		);
+	}
 }
 
 void ULivCaptureMeshClipPlaneNoPostProcess::ReleaseRenderTargets()
@@ -109,36 +114,17 @@ void ULivCaptureMeshClipPlaneNoPostProcess::ReleaseRenderTargets()
 
 	TextureTarget = nullptr;
 
-	if (BackgroundRenderTarget)
-	{
-		BackgroundRenderTarget->ReleaseResource();
-		BackgroundRenderTarget = nullptr;
-	}
-
-	if (ForegroundRenderTarget)
-	{
-		ForegroundRenderTarget->ReleaseResource();
-		ForegroundRenderTarget = nullptr;
-	}
-
-	if (BackgroundOutputRenderTarget)
-	{
-		BackgroundOutputRenderTarget->ReleaseResource();
-		BackgroundOutputRenderTarget = nullptr;
-	}
-
-	if (ForegroundOutputRenderTarget)
-	{
-		ForegroundOutputRenderTarget->ReleaseResource();
-		ForegroundOutputRenderTarget = nullptr;
-	}
+	ReleaseRenderTarget2D(BackgroundRenderTarget);
+	ReleaseRenderTarget2D(ForegroundRenderTarget);
+	ReleaseRenderTarget2D(BackgroundOutputRenderTarget);
+	ReleaseRenderTarget2D(ForegroundOutputRenderTarget);
 }
 
 void ULivCaptureMeshClipPlaneNoPostProcess::Capture(const FLivCaptureContext& Context)
 {
 	Super::Capture(Context);
 
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
 
 	UWorld* World = GetWorld();
 
@@ -153,77 +139,54 @@ void ULivCaptureMeshClipPlaneNoPostProcess::Capture(const FLivCaptureContext& Co
 	// Apply context to scene capture (set hide list)
 	Context.ApplyHideLists(this);
 
+	// the foreground is segmented from the background capture so it is captured for either layer
+	const bool bCaptureBackground = ShouldCaptureBackground();
+	const bool bCaptureForeground = ShouldCaptureForeground();
+
 	// Capture Background
 	TextureTarget = BackgroundRenderTarget;
 	CaptureSource = SCS_SceneColorSceneDepth;
+	SetCaptureUsesLighting(this, true);
 	CaptureScene();
 
-	// Calculate clip plane transform
-	const auto VROriginTransform = GetAttachParent()->GetComponentTransform();
-	
-	const auto CameraClipPlaneMatrix = InputFrame.CameraClipPlaneMatrix;// Convert<LIV_Matrix4x4, FMatrix>(LivInputFrame->clipPlane.transform);
-	const auto CameraClipPlanePosition = VROriginTransform.TransformPosition(CameraClipPlaneMatrix.TransformPosition(FVector::ZeroVector));
-	const auto CameraClipPlaneForward = VROriginTransform.TransformVector(CameraClipPlaneMatrix.TransformVector(FVector::ForwardVector));
-	const auto CameraClipPlaneRotation = CameraClipPlaneForward.Rotation();
-	const auto CameraClipPlaneScale = VROriginTransform.GetScale3D() * CameraClipPlaneMatrix.GetScaleVector();
-
-	// Transform camera clip plane mesh
-	CameraClipPlane->SetWorldLocationAndRotation(CameraClipPlanePosition, CameraClipPlaneRotation);
-	CameraClipPlane->SetWorldScale3D(CameraClipPlaneScale);
-	CameraClipPlane->SetHiddenInGame(false);
-
-	if (InputFrame.bFloorClipPlaneEnabled)
+	if (bCaptureForeground)
 	{
-		// Transform floor clip plane mesh
-		const auto FloorClipPlaneMatrix = InputFrame.FloorClipPlaneMatrix;// Convert<LIV_Matrix4x4, FMatrix>(LivInputFrame->GroundPlane.transform);
-		const auto FloorClipPlanePosition = VROriginTransform.TransformPosition(FloorClipPlaneMatrix.TransformPosition(FVector::ZeroVector));
-		const auto FloorClipPlaneForward = VROriginTransform.TransformVector(FloorClipPlaneMatrix.TransformVector(FVector::ForwardVector));
-		const auto FloorClipPlaneRotation = FloorClipPlaneForward.Rotation();
-		const auto FloorClipPlaneScale = VROriginTransform.GetScale3D() * FloorClipPlaneMatrix.GetScaleVector();
-
-
-		FloorClipPlane->SetWorldLocationAndRotation(FloorClipPlanePosition, FloorClipPlaneRotation);
-		FloorClipPlane->SetWorldScale3D(FloorClipPlaneScale);
-		FloorClipPlane->SetHiddenInGame(false);
+		CaptureForeground();
 	}
 
-	// Capture Foreground
-	TextureTarget = ForegroundRenderTarget;
-	CaptureSource = SCS_SceneDepth;
-	CaptureScene();
-	
-	// hide clip planes
-	CameraClipPlane->SetHiddenInGame(true);
-	FloorClipPlane->SetHiddenInGame(true);
-
-	// @TODO: combine the following two shader calls into one if possible
-
 	const ERHIFeatureLevel::Type FeatureLevel = World->Scene->GetFeatureLevel();
 
-	FTextureResource* ForegroundResource = ForegroundRenderTarget->Resource;
+	// without a foreground capture segment against black, the pass is still needed to copy the background
+	FTexture* ForegroundResource = bCaptureForeground ? static_cast<FTexture*>(ForegroundRenderTarget->Resource) : GBlackTexture;
 	FTextureResource* BackgroundResource = BackgroundRenderTarget->Resource;
-	FTextureResource* ForegroundOutputResource = ForegroundOutputRenderTarget->Resource;
-	FTextureResource* BackgroundOutputResource = BackgroundOutputRenderTarget->Resource;
+
+	// the segmented outputs are allocated in the graph, these only exist to extract them for debugging
+	FTextureResource* DebugForegroundOutputResource = ForegroundOutputRenderTarget ? ForegroundOutputRenderTarget->Resource : nullptr;
+	FTextureResource* DebugBackgroundOutputResource = BackgroundOutputRenderTarget ? BackgroundOutputRenderTarget->Resource : nullptr;
 
 	ENQUEUE_RENDER_COMMAND(LivRDGCaptureMeshClipPlaneNoPostProcess)(
-		[FeatureLevel, ForegroundResource, BackgroundResource, ForegroundOutputResource, BackgroundOutputResource](FRHICommandListImmediate& RHICmdList)
+		[FeatureLevel, ForegroundResource, BackgroundResource, DebugForegroundOutputResource, DebugBackgroundOutputResource, bCaptureBackground, bCaptureForeground](FRHICommandListImmediate& RHICmdList)
 		{
 			FRDGBuilder GraphBuilder(RHICmdList);
 
 			{
 				RDG_EVENT_SCOPE(GraphBuilder, "Liv Capture Mesh Clip Plane No Post Process");
+				LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
 
 				const auto GlobalShaderMap = GetGlobalShaderMap(FeatureLevel);
+				const FIntPoint OutputExtent(BackgroundResource->GetSizeX(), BackgroundResource->GetSizeY());
 
-				const FRDGTextureRef OutputForegroundTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(
+				const FRDGTextureRef OutputForegroundTexture = FLivRenderPass::CreateIntermediateTexture(
 					GraphBuilder,
-					ForegroundOutputResource,
+					OutputExtent,
+					LIV_TEXTURE_FOREGROUND_COLOR_BUFFER_ID,
 					TEXT("Foreground Output")
 				);
 
-				const FRDGTextureRef OutputBackgroundTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(
+				const FRDGTextureRef OutputBackgroundTexture = FLivRenderPass::CreateIntermediateTexture(
 					GraphBuilder,
-					BackgroundOutputResource,
+					OutputExtent,
+					LIV_TEXTURE_BACKGROUND_COLOR_BUFFER_ID,
 					TEXT("Background Output")
 				);
 
@@ -253,14 +216,17 @@ void ULivCaptureMeshClipPlaneNoPostProcess::Capture(const FLivCaptureContext& Co
 						PixelShader,
 						Parameters
 					);
+
+					FLivRenderPass::AddExtractPass(GraphBuilder, OutputForegroundTexture, DebugForegroundOutputResource);
+					FLivRenderPass::AddExtractPass(GraphBuilder, OutputBackgroundTexture, DebugBackgroundOutputResource);
 				}
 
 				{
 					RDG_EVENT_SCOPE(GraphBuilder, "Liv Submit");
 
 					FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
-					Parameters->ForegroundTexture = OutputForegroundTexture;
-					Parameters->BackgroundTexture = OutputBackgroundTexture;
+					Parameters->ForegroundTexture = bCaptureForeground ? OutputForegroundTexture : nullptr;
+					Parameters->BackgroundTexture = bCaptureBackground ? OutputBackgroundTexture : nullptr;
 
 					FLivRenderPass::AddSubmitPass(GraphBuilder, Parameters);
 				}
@@ -271,3 +237,52 @@ void ULivCaptureMeshClipPlaneNoPostProcess::Capture(const FLivCaptureContext& Co
 
 #endif
 }
+
+void ULivCaptureMeshClipPlaneNoPostProcess::CaptureForeground()
+{
+	// Calculate clip plane transform
+	const auto VROriginTransform = GetAttachParent()->GetComponentTransform();
+	
+	const auto CameraClipPlaneMatrix = InputFrame.CameraClipPlaneMatrix;// Convert<LIV_Matrix4x4, FMatrix>(LivInputFrame->clipPlane.transform);
+	const auto CameraClipPlanePosition = VROriginTransform.TransformPosition(CameraClipPlaneMatrix.TransformPosition(FVector::ZeroVector));
+	const auto CameraClipPlaneForward = VROriginTransform.TransformVector(CameraClipPlaneMatrix.TransformVector(FVector::ForwardVector));
+	const auto CameraClipPlaneRotation = CameraClipPlaneForward.Rotation();
+	const auto CameraClipPlaneScale = VROriginTransform.GetScale3D() * CameraClipPlaneMatrix.GetScaleVector();
+
+	// Transform camera clip plane mesh (only when it moved)
+	const bool bUpdateClipPlaneTransforms = ShouldUpdateClipPlaneTransforms(VROriginTransform);
+	if (bUpdateClipPlaneTransforms)
+	{
+		CameraClipPlane->SetWorldLocationAndRotation(CameraClipPlanePosition, CameraClipPlaneRotation);
+		CameraClipPlane->SetWorldScale3D(CameraClipPlaneScale);
+	}
+	CameraClipPlane->SetHiddenInGame(false);
+
+	if (InputFrame.bFloorClipPlaneEnabled)
+	{
+		// Transform floor clip plane mesh
+		const auto FloorClipPlaneMatrix = InputFrame.FloorClipPlaneMatrix;// Convert<LIV_Matrix4x4, FMatrix>(LivInputFrame->GroundPlane.transform);
+		const auto FloorClipPlanePosition = VROriginTransform.TransformPosition(FloorClipPlaneMatrix.TransformPosition(FVector::ZeroVector));
+		const auto FloorClipPlaneForward = VROriginTransform.TransformVector(FloorClipPlaneMatrix.TransformVector(FVector::ForwardVector));
+		const auto FloorClipPlaneRotation = FloorClipPlaneForward.Rotation();
+		const auto FloorClipPlaneScale = VROriginTransform.GetScale3D() * FloorClipPlaneMatrix.GetScaleVector();
+
+
+		if (bUpdateClipPlaneTransforms)
+		{
+			FloorClipPlane->SetWorldLocationAndRotation(FloorClipPlanePosition, FloorClipPlaneRotation);
+			FloorClipPlane->SetWorldScale3D(FloorClipPlaneScale);
+		}
+		FloorClipPlane->SetHiddenInGame(false);
+	}
+
+	// Capture Foreground (depth only, reuses the background's lighting)
+	TextureTarget = ForegroundRenderTarget;
+	CaptureSource = SCS_SceneDepth;
+	SetCaptureUsesLighting(this, false);
+	CaptureScene();
+	
+	// hide clip planes
+	CameraClipPlane->SetHiddenInGame(true);
+	FloorClipPlane->SetHiddenInGame(true);
+}
@@ -7,6 +7,7 @@
 #include "LivConversions.h"
 #include "LivClipPlane.h"
 #include "LivCaptureContext.h"
+#include "LivPassTimings.h"
 #include "LivPluginSettings.h"
 #include "LivRenderPass.h"
 #include "LivShaders.h"
@@ -106,23 +107,26 @@ void ULivCaptureMeshClipPlanePostProcess::CreateRenderTargets()
 		ETextureRenderTargetFormat::RTF_R16f
 	);
 
-	// Output background 8bpc
-	BackgroundOutputRenderTarget = CreateRenderTarget2D(
-		GetWorld(),
-		LivInputFrameWidth,
-		LivInputFrameHeight,
-		"BackgroundOutputRenderTarget",
-		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
-	);
-
-	// Output foreground masked 8bpc
-	ForegroundOutputRenderTarget = CreateRenderTarget2D(
-		GetWorld(),
-		LivInputFrameWidth,
-		LivInputFrameHeight,
-		"ForegroundOutputRenderTarget",
-		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
-	);
+	if (ShouldExtractIntermediates())
+	{
+		// Output background 8bpc
+		BackgroundOutputRenderTarget = CreateRenderTarget2D(
+			GetWorld(),
+			LivInputFrameWidth,
+			LivInputFrameHeight,
+			"BackgroundOutputRenderTarget",
+			ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+		);
+
+		// Output foreground masked 8bpc
+		ForegroundOutputRenderTarget = CreateRenderTarget2D(
+			GetWorld(),
+			LivInputFrameWidth,
+			LivInputFrameHeight,
+			"ForegroundOutputRenderTarget",
+			ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+		);
+	}
 }
 
 void ULivCaptureMeshClipPlanePostProcess::ReleaseRenderTargets()
@@ -136,42 +140,18 @@ void ULivCaptureMeshClipPlanePostProcess::ReleaseRenderTargets()
 
 	TextureTarget = nullptr;
 
-	if (PostProcessedSceneRenderTarget)
-	{
-		PostProcessedSceneRenderTarget->ReleaseResource();
-		PostProcessedSceneRenderTarget = nullptr;
-	}
-
-	if (BackgroundDepthRenderTarget)
-	{
-		BackgroundDepthRenderTarget->ReleaseResource();
-		BackgroundDepthRenderTarget = nullptr;
-	}
-
-	if (ForegroundDepthRenderTarget)
-	{
-		ForegroundDepthRenderTarget->ReleaseResource();
-		ForegroundDepthRenderTarget = nullptr;
-	}
-
-	if (BackgroundOutputRenderTarget)
-	{
-		BackgroundOutputRenderTarget->ReleaseResource();
-		BackgroundOutputRenderTarget = nullptr;
-	}
-
-	if (ForegroundOutputRenderTarget)
-	{
-		ForegroundOutputRenderTarget->ReleaseResource();
-		ForegroundOutputRenderTarget = nullptr;
-	}
+	ReleaseRenderTarget2D(PostProcessedSceneRenderTarget);
+	ReleaseRenderTarget2D(BackgroundDepthRenderTarget);
+	ReleaseRenderTarget2D(ForegroundDepthRenderTarget);
+	ReleaseRenderTarget2D(BackgroundOutputRenderTarget);
+	ReleaseRenderTarget2D(ForegroundOutputRenderTarget);
 }
 
 void ULivCaptureMeshClipPlanePostProcess::Capture(const FLivCaptureContext& Context)
 {
 	Super::Capture(Context);
 
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
 
 	UWorld* World = GetWorld();
 
@@ -188,85 +168,62 @@ void ULivCaptureMeshClipPlanePostProcess::Capture(const FLivCaptureContext& Cont
 	Context.ApplyHideLists(this);
 	Context.ApplyHideLists(SceneCaptureComponent);
 
+	// the foreground is segmented from the background capture so it is captured for either layer
+	const bool bCaptureBackground = ShouldCaptureBackground();
+	const bool bCaptureForeground = ShouldCaptureForeground();
+
 	// Capture full scene with post processing (RGB)
 	TextureTarget = PostProcessedSceneRenderTarget;
 	CaptureSource = SCS_FinalColorLDR;
 	PostProcessSettings = GetDefault<ULivPluginSettings>()->PostProcessSettings;
 	CaptureScene();
 
-	// Capture full scene depth (Depth)
-	SceneCaptureComponent->TextureTarget = BackgroundDepthRenderTarget;
-	SceneCaptureComponent->CaptureSource = SCS_SceneDepth;
-	SceneCaptureComponent->CaptureScene();
-
-	// Calculate clip plane transform
-	const auto VROriginTransform = GetAttachParent()->GetComponentTransform();
-
-	const auto CameraClipPlaneMatrix = InputFrame.CameraClipPlaneMatrix; // Convert<LIV_Matrix4x4, FMatrix>(LivInputFrame->clipPlane.transform);
-	const auto CameraClipPlanePosition = VROriginTransform.TransformPosition(CameraClipPlaneMatrix.TransformPosition(FVector::ZeroVector));
-	const auto CameraClipPlaneForward = VROriginTransform.TransformVector(CameraClipPlaneMatrix.TransformVector(FVector::ForwardVector));
-	const auto CameraClipPlaneRotation = CameraClipPlaneForward.Rotation();
-	const auto CameraClipPlaneScale = VROriginTransform.GetScale3D() * CameraClipPlaneMatrix.GetScaleVector();
-
-	// Transform camera clip plane mesh
-	CameraClipPlane->SetWorldLocationAndRotation(CameraClipPlanePosition, CameraClipPlaneRotation);
-	CameraClipPlane->SetWorldScale3D(CameraClipPlaneScale);
-	CameraClipPlane->SetHiddenInGame(false);
-
-	if (InputFrame.bFloorClipPlaneEnabled)
+	if (bCaptureForeground)
 	{
-		// Transform floor clip plane mesh
-		const auto FloorClipPlaneMatrix = InputFrame.FloorClipPlaneMatrix;// Convert<LIV_Matrix4x4, FMatrix>(LivInputFrame->GroundPlane.transform);
-		const auto FloorClipPlanePosition = VROriginTransform.TransformPosition(FloorClipPlaneMatrix.TransformPosition(FVector::ZeroVector));
-		const auto FloorClipPlaneForward = VROriginTransform.TransformVector(FloorClipPlaneMatrix.TransformVector(FVector::ForwardVector));
-		const auto FloorClipPlaneRotation = FloorClipPlaneForward.Rotation();
-		const auto FloorClipPlaneScale = VROriginTransform.GetScale3D() * FloorClipPlaneMatrix.GetScaleVector();
-
-		FloorClipPlane->SetWorldLocationAndRotation(FloorClipPlanePosition, FloorClipPlaneRotation);
-		FloorClipPlane->SetWorldScale3D(FloorClipPlaneScale);
-		FloorClipPlane->SetHiddenInGame(false);
+		CaptureForeground();
 	}
-
-	// Capture Foreground Depth
-	SceneCaptureComponent->TextureTarget = ForegroundDepthRenderTarget;
-	SceneCaptureComponent->CaptureSource = SCS_SceneDepth;
-	SceneCaptureComponent->CaptureScene();
-
-	// hide clip planes
-	CameraClipPlane->SetHiddenInGame(true);
-	FloorClipPlane->SetHiddenInGame(true);
 	
 	const ERHIFeatureLevel::Type FeatureLevel = World->Scene->GetFeatureLevel();
 
 	FTextureResource* BackgroundResource = PostProcessedSceneRenderTarget->Resource;
 	FTextureResource* BackgroundDepthResource = BackgroundDepthRenderTarget->Resource;
 	FTextureResource* ForegroundDepthResource = ForegroundDepthRenderTarget->Resource;
-	FTextureResource* ForegroundOutputResource = ForegroundOutputRenderTarget->Resource;
-	FTextureResource* BackgroundOutputResource = BackgroundOutputRenderTarget->Resource;
+
+	// the segmented outputs are allocated in the graph, these only exist to extract them for debugging
+	FTextureResource* DebugForegroundOutputResource = ForegroundOutputRenderTarget ? ForegroundOutputRenderTarget->Resource : nullptr;
+	FTextureResource* DebugBackgroundOutputResource = BackgroundOutputRenderTarget ? BackgroundOutputRenderTarget->Resource : nullptr;
 
 	ENQUEUE_RENDER_COMMAND(LivRDGCaptureMeshClipPlanePostProcess)(
-		[FeatureLevel, BackgroundResource, BackgroundDepthResource, ForegroundDepthResource, ForegroundOutputResource, BackgroundOutputResource](FRHICommandListImmediate& RHICmdList)
+		[FeatureLevel, BackgroundResource, BackgroundDepthResource, ForegroundDepthResource, DebugForegroundOutputResource, DebugBackgroundOutputResource, bCaptureBackground, bCaptureForeground](FRHICommandListImmediate& RHICmdList)
 		{
 			FRDGBuilder GraphBuilder(RHICmdList);
 
 			{
 				RDG_EVENT_SCOPE(GraphBuilder, "Liv Capture Mesh Clip Plane Post Process");
+				LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
 
 				const auto GlobalShaderMap = GetGlobalShaderMap(FeatureLevel);
+				const FIntPoint OutputExtent(BackgroundResource->GetSizeX(), BackgroundResource->GetSizeY());
 
-				const FRDGTextureRef OutputForegroundTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(
-					GraphBuilder,
-					ForegroundOutputResource,
-					TEXT("Foreground Output")
-				);
-
-				const FRDGTextureRef OutputBackgroundTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(
-					GraphBuilder,
-					BackgroundOutputResource,
-					TEXT("Background Output")
-				);
+				FRDGTextureRef OutputForegroundTexture = nullptr;
+				FRDGTextureRef OutputBackgroundTexture = nullptr;
 
+				if (bCaptureForeground)
 				{
+					OutputForegroundTexture = FLivRenderPass::CreateIntermediateTexture(
+						GraphBuilder,
+						OutputExtent,
+						LIV_TEXTURE_FOREGROUND_COLOR_BUFFER_ID,
+						TEXT("Foreground Output")
+					);
+
+					OutputBackgroundTexture = FLivRenderPass::CreateIntermediateTexture(
+						GraphBuilder,
+						OutputExtent,
+						LIV_TEXTURE_BACKGROUND_COLOR_BUFFER_ID,
+						TEXT("Background Output")
+					);
+
 					RDG_EVENT_SCOPE(GraphBuilder, "Liv Foreground Segmentation PP and Copy");
 
 					const TShaderMapRef<FLivRDGScreenPassVS> VertexShader(GlobalShaderMap);
@@ -294,6 +251,9 @@ void ULivCaptureMeshClipPlanePostProcess::Capture(const FLivCaptureContext& Cont
 						PixelShader,
 						Parameters
 					);
+
+					FLivRenderPass::AddExtractPass(GraphBuilder, OutputForegroundTexture, DebugForegroundOutputResource);
+					FLivRenderPass::AddExtractPass(GraphBuilder, OutputBackgroundTexture, DebugBackgroundOutputResource);
 				}
 
 				{
@@ -301,7 +261,16 @@ void ULivCaptureMeshClipPlanePostProcess::Capture(const FLivCaptureContext& Cont
 
 					FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
 					Parameters->ForegroundTexture = OutputForegroundTexture;
-					Parameters->BackgroundTexture = OutputBackgroundTexture;
+
+					if (bCaptureBackground)
+					{
+						// the post processed capture is submitted as is when there was no segmentation pass to copy it
+						Parameters->BackgroundTexture = bCaptureForeground ? OutputBackgroundTexture : FLivRenderPass::CreateRDGTextureFromRenderTarget(
+							GraphBuilder,
+							BackgroundResource,
+							TEXT("LivBackground")
+						);
+					}
 
 					FLivRenderPass::AddSubmitPass(GraphBuilder, Parameters);
 				}
@@ -312,3 +281,58 @@ void ULivCaptureMeshClipPlanePostProcess::Capture(const FLivCaptureContext& Cont
 
 #endif
 }
+
+void ULivCaptureMeshClipPlanePostProcess::CaptureForeground()
+{
+	// Both depth captures reuse the post processed capture's lighting
+	SetCaptureUsesLighting(SceneCaptureComponent, false);
+
+	// Capture full scene depth (Depth)
+	SceneCaptureComponent->TextureTarget = BackgroundDepthRenderTarget;
+	SceneCaptureComponent->CaptureSource = SCS_SceneDepth;
+	SceneCaptureComponent->CaptureScene();
+
+	// Calculate clip plane transform
+	const auto VROriginTransform = GetAttachParent()->GetComponentTransform();
+
+	const auto CameraClipPlaneMatrix = InputFrame.CameraClipPlaneMatrix; // Convert<LIV_Matrix4x4, FMatrix>(LivInputFrame->clipPlane.transform);
+	const auto CameraClipPlanePosition = VROriginTransform.TransformPosition(CameraClipPlaneMatrix.TransformPosition(FVector::ZeroVector));
+	const auto CameraClipPlaneForward = VROriginTransform.TransformVector(CameraClipPlaneMatrix.TransformVector(FVector::ForwardVector));
+	const auto CameraClipPlaneRotation = CameraClipPlaneForward.Rotation();
+	const auto CameraClipPlaneScale = VROriginTransform.GetScale3D() * CameraClipPlaneMatrix.GetScaleVector();
+
+	// Transform camera clip plane mesh (only when it moved)
+	const bool bUpdateClipPlaneTransforms = ShouldUpdateClipPlaneTransforms(VROriginTransform);
+	if (bUpdateClipPlaneTransforms)
+	{
+		CameraClipPlane->SetWorldLocationAndRotation(CameraClipPlanePosition, CameraClipPlaneRotation);
+		CameraClipPlane->SetWorldScale3D(CameraClipPlaneScale);
+	}
+	CameraClipPlane->SetHiddenInGame(false);
+
+	if (InputFrame.bFloorClipPlaneEnabled)
+	{
+		// Transform floor clip plane mesh
+		const auto FloorClipPlaneMatrix = InputFrame.FloorClipPlaneMatrix;// Convert<LIV_Matrix4x4, FMatrix>(LivInputFrame->GroundPlane.transform);
+		const auto FloorClipPlanePosition = VROriginTransform.TransformPosition(FloorClipPlaneMatrix.TransformPosition(FVector::ZeroVector));
+		const auto FloorClipPlaneForward = VROriginTransform.TransformVector(FloorClipPlaneMatrix.TransformVector(FVector::ForwardVector));
+		const auto FloorClipPlaneRotation = FloorClipPlaneForward.Rotation();
+		const auto FloorClipPlaneScale = VROriginTransform.GetScale3D() * FloorClipPlaneMatrix.GetScaleVector();
+
+		if (bUpdateClipPlaneTransforms)
+		{
+			FloorClipPlane->SetWorldLocationAndRotation(FloorClipPlanePosition, FloorClipPlaneRotation);
+			FloorClipPlane->SetWorldScale3D(FloorClipPlaneScale);
+		}
+		FloorClipPlane->SetHiddenInGame(false);
+	}
+
+	// Capture Foreground Depth
+	SceneCaptureComponent->TextureTarget = ForegroundDepthRenderTarget;
+	SceneCaptureComponent->CaptureSource = SCS_SceneDepth;
+	SceneCaptureComponent->CaptureScene();
+
+	// hide clip planes
+	CameraClipPlane->SetHiddenInGame(true);
+	FloorClipPlane->SetHiddenInGame(true);
+}
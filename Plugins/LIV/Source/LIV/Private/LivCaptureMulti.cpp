@@ -80,78 +80,50 @@ void ULivCaptureMulti::OnDeactivated()
 	SceneViewExtension = nullptr;
 }
 
-UTextureRenderTarget2D* CreateRenderTarget2D_Alt(UObject* Owner,
-	int32 Width,
-	int32 Height,
-	FName Name /*= NAME_None*/,
-	ETextureRenderTargetFormat Format = ETextureRenderTargetFormat::RTF_RGBA8,
-	bool bForceLinearGamma = false,
-	FLinearColor ClearColor = FLinearColor::Black,
-	float TargetGamma = 0.0f)
-{
-	/*UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);*/
-
-	if (Width > 0 && Height > 0/* && World*/)
-	{
-		UTextureRenderTarget2D* NewRenderTarget2D = NewObject<UTextureRenderTarget2D>(GetTransientPackage(), Name);
-		check(NewRenderTarget2D);
-		NewRenderTarget2D->RenderTargetFormat = Format;
-		NewRenderTarget2D->ClearColor = ClearColor;
-		NewRenderTarget2D->bAutoGenerateMips = false;
-		NewRenderTarget2D->TargetGamma = TargetGamma;
-		NewRenderTarget2D->bForceLinearGamma = bForceLinearGamma;
-		NewRenderTarget2D->InitAutoFormat(Width, Height);
-		NewRenderTarget2D->UpdateResourceImmediate(true);
-
-		return NewRenderTarget2D;
-	}
-
-	return nullptr;
-}
-
-
 void ULivCaptureMulti::CreateRenderTargets()
 {
 	Super::CreateRenderTargets();
 
 	// Background (8bpc)
-	BackgroundRenderTarget = CreateRenderTarget2D_Alt(
-		GetWorld(),
-		LivInputFrameWidth,
-		LivInputFrameHeight,
-		"BackgroundRenderTarget",
-		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
-	);
-
-	// Background output (8bpc)
-	BackgroundOutputRenderTarget = CreateRenderTarget2D_Alt(
-		GetWorld(),
+	BackgroundRenderTarget = CreateRenderTarget2D(
 		LivInputFrameWidth,
 		LivInputFrameHeight,
 		"BackgroundRenderTarget",
-		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+		ETextureRenderTargetFormat::RTF_RGBA8_SRGB,
+		false
 	);
 
 	// Foreground (8bpc)
-	ForegroundRenderTarget = CreateRenderTarget2D_Alt(
-		GetWorld(),
+	ForegroundRenderTarget = CreateRenderTarget2D(
 		LivInputFrameWidth,
 		LivInputFrameHeight,
 		"ForegroundRenderTarget",
-		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
+		ETextureRenderTargetFormat::RTF_RGBA8_SRGB,
+		false
 	);
 
-	// Foreground output (8bpc)
-	ForegroundOutputRenderTarget = CreateRenderTarget2D_Alt(
-		GetWorld(),
-		LivInputFrameWidth,
-		LivInputFrameHeight,
-		"ForegroundOutputRenderTarget",
-		ETextureRenderTargetFormat::RTF_RGBA8_SRGB
-	);
+	if (ShouldExtractIntermediates())
+	{
+		// Background output (8bpc)
+		BackgroundOutputRenderTarget = CreateRenderTarget2D(
+			LivInputFrameWidth,
+			LivInputFrameHeight,
+			"BackgroundOutputRenderTarget",
+			ETextureRenderTargetFormat::RTF_RGBA8_SRGB,
+			false
+		);
+
+		// Foreground output (8bpc)
+		ForegroundOutputRenderTarget = CreateRenderTarget2D(
+			LivInputFrameWidth,
+			LivInputFrameHeight,
+			"ForegroundOutputRenderTarget",
+			ETextureRenderTargetFormat::RTF_RGBA8_SRGB,
+			false
+		);
+	}
 
-	EyeAdaptionRenderTarget = CreateRenderTarget2D_Alt(
-		GetWorld(),
+	EyeAdaptionRenderTarget = CreateRenderTarget2D(
 		1,
 		1,
 		"LivEyeAdaptionRenderTarget",
@@ -166,36 +138,18 @@ void ULivCaptureMulti::ReleaseRenderTargets()
 
 	TextureTarget = nullptr;
 
-	if (BackgroundRenderTarget)
-	{
-		BackgroundRenderTarget->ReleaseResource();
-		BackgroundRenderTarget = nullptr;
-	}
-
-	if(BackgroundOutputRenderTarget)
-	{
-		BackgroundOutputRenderTarget->ReleaseResource();
-		BackgroundOutputRenderTarget = nullptr;
-	}
-
-	if (ForegroundRenderTarget)
-	{
-		ForegroundRenderTarget->ReleaseResource();
-		ForegroundRenderTarget = nullptr;
-	}
-
-	if (ForegroundOutputRenderTarget)
-	{
-		ForegroundOutputRenderTarget->ReleaseResource();
-		ForegroundOutputRenderTarget = nullptr;
-	}
+	ReleaseRenderTarget2D(BackgroundRenderTarget);
+	ReleaseRenderTarget2D(BackgroundOutputRenderTarget);
+	ReleaseRenderTarget2D(ForegroundRenderTarget);
+	ReleaseRenderTarget2D(ForegroundOutputRenderTarget);
+	ReleaseRenderTarget2D(EyeAdaptionRenderTarget);
 }
 
 void ULivCaptureMulti::Capture(const FLivCaptureContext& Context)
 {
 	Super::Capture(Context);
 
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
 
 	// set our render targets so we can determine if relevant in scene view ext
 	SceneViewExtension->BackgroundRenderTarget2D = BackgroundRenderTarget;
@@ -214,6 +168,11 @@ void ULivCaptureMulti::Capture(const FLivCaptureContext& Context)
 	Context.ApplyHideLists(this);
 	Context.ApplyHideLists(SceneCaptureComponent);
 
+	const bool bCaptureForeground = ShouldCaptureForeground();
+
+	// background is always captured, the foreground reuses its eye adaptation
+	SceneViewExtension->SetCaptureLayers_GameThread(ShouldCaptureBackground(), bCaptureForeground);
+
 	// Capture full scene with post processing (RGB)
 	TextureTarget = BackgroundRenderTarget;
 	CaptureSource = SCS_FinalToneCurveHDR;
@@ -226,6 +185,11 @@ void ULivCaptureMulti::Capture(const FLivCaptureContext& Context)
 	CaptureSortPriority = BackgroundPriority;
 	CaptureSceneDeferred();
 
+	if (!bCaptureForeground)
+	{
+		return;
+	}
+
 	// Calculate clip plane transform
 	const auto VROriginTransform = GetAttachParent()->GetComponentTransform();
 
@@ -236,9 +200,12 @@ void ULivCaptureMulti::Capture(const FLivCaptureContext& Context)
 	const auto CameraClipPlaneRotation = ClipPlaneForward.Rotation();
 	const auto CameraClipPlaneScale = VROriginTransform.GetScale3D() * ClipPlaneTransform.GetScaleVector();
 
-	// Transform camera clip plane mesh
-	CameraClipPlane->SetWorldLocationAndRotation(ClipPlanePosition, CameraClipPlaneRotation);
-	CameraClipPlane->SetWorldScale3D(CameraClipPlaneScale);
+	// Transform camera clip plane mesh (only when it moved)
+	if (ShouldUpdateClipPlaneTransforms(VROriginTransform))
+	{
+		CameraClipPlane->SetWorldLocationAndRotation(ClipPlanePosition, CameraClipPlaneRotation);
+		CameraClipPlane->SetWorldScale3D(CameraClipPlaneScale);
+	}
 	CameraClipPlane->SetHiddenInGame(false);
 
 	ShowFlags.EyeAdaptation = CVarEyeAdaption.GetValueOnGameThread();
@@ -0,0 +1,42 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#include "LivCaptureScheduler.h"
+
+FLivCaptureScheduler::FLivCaptureScheduler()
+	: Phase(1.0)
+{
+}
+
+bool FLivCaptureScheduler::ShouldCapture(double DeltaTime, double TargetRate)
+{
+	if (TargetRate <= 0.0)
+	{
+		Phase = 1.0;
+		return true;
+	}
+
+	const double Step = FMath::Max(DeltaTime, 0.0) * TargetRate;
+
+	Phase += Step;
+
+	// capture on the frame closest to when it's due rather than the first one after
+	if (Phase + 0.5 * Step < 1.0)
+	{
+		return false;
+	}
+
+	Phase -= 1.0;
+
+	// more than half a frame late (first capture or a hitch), schedule from now rather than catch up
+	if (Phase >= 0.5 * Step)
+	{
+		Phase = 0.0;
+	}
+
+	return true;
+}
+
+void FLivCaptureScheduler::Reset()
+{
+	Phase = 1.0;
+}
@@ -86,18 +86,14 @@ void ULivCaptureSingle::ReleaseRenderTargets()
 
 	TextureTarget = nullptr;
 	
-	if (BackgroundOutputRenderTarget)
-	{
-		BackgroundOutputRenderTarget->ReleaseResource();
-		BackgroundOutputRenderTarget = nullptr;
-	}
+	ReleaseRenderTarget2D(BackgroundOutputRenderTarget);
 }
 
 void ULivCaptureSingle::Capture(const FLivCaptureContext& Context)
 {
 	Super::Capture(Context);
 
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
 
 	// set our render target so we can determine if relevant in scene view ext
 	SceneViewExtension->RenderTarget2D = BackgroundOutputRenderTarget;
@@ -122,9 +118,13 @@ void ULivCaptureSingle::Capture(const FLivCaptureContext& Context)
 	const auto CameraClipPlaneRotation = CameraClipPlaneForward.Rotation();
 	const auto CameraClipPlaneScale = VROriginTransform.GetScale3D() * CameraClipPlaneMatrix.GetScaleVector();
 
-	// Transform camera clip plane mesh
-	CameraClipPlane->SetWorldLocationAndRotation(CameraClipPlanePosition, CameraClipPlaneRotation);
-	CameraClipPlane->SetWorldScale3D(CameraClipPlaneScale);
+	// Transform camera clip plane mesh (only when it moved)
+	const bool bUpdateClipPlaneTransforms = ShouldUpdateClipPlaneTransforms(VROriginTransform);
+	if (bUpdateClipPlaneTransforms)
+	{
+		CameraClipPlane->SetWorldLocationAndRotation(CameraClipPlanePosition, CameraClipPlaneRotation);
+		CameraClipPlane->SetWorldScale3D(CameraClipPlaneScale);
+	}
 	CameraClipPlane->SetHiddenInGame(false);
 
 	const ULivPluginSettings* PluginSettings = GetDefault<ULivPluginSettings>();
@@ -143,8 +143,11 @@ void ULivCaptureSingle::Capture(const FLivCaptureContext& Context)
 		const auto FloorClipPlaneRotation = FloorClipPlaneForward.Rotation();
 		const auto FloorClipPlaneScale = VROriginTransform.GetScale3D() * FloorClipPlaneMatrix.GetScaleVector();
 
-		FloorClipPlane->SetWorldLocationAndRotation(FloorClipPlanePosition, FloorClipPlaneRotation);
-		FloorClipPlane->SetWorldScale3D(FloorClipPlaneScale);
+		if (bUpdateClipPlaneTransforms)
+		{
+			FloorClipPlane->SetWorldLocationAndRotation(FloorClipPlanePosition, FloorClipPlaneRotation);
+			FloorClipPlane->SetWorldScale3D(FloorClipPlaneScale);
+		}
 		FloorClipPlane->SetHiddenInGame(false);
 
 		if (PluginSettings->bUseDebugFloorClipPlane)
@@ -157,6 +160,9 @@ void ULivCaptureSingle::Capture(const FLivCaptureContext& Context)
 		FloorClipPlane->SetHiddenInGame(true);
 	}
 
+	// one capture serves both layers, the extension skips segmentation without a foreground
+	SceneViewExtension->SetCaptureLayers_GameThread(ShouldCaptureBackground(), ShouldCaptureForeground(), ShouldUseCompositorSegmentation());
+
 	// Capture Background
 	PostProcessSettings = GetDefault<ULivPluginSettings>()->PostProcessSettings;
 	TextureTarget = BackgroundOutputRenderTarget;
@@ -1,10 +1,11 @@
 // Copyright 2021 LIV Inc. - MIT License
 #include "LivConversions.h"
-#include "dxgiformat.h"
 #include "RHI.h"
 
 #if PLATFORM_WINDOWS
 
+#include "dxgiformat.h"
+
 DXGI_FORMAT GetRenderTargetFormat(const EPixelFormat PixelFormat)
 {
 	DXGI_FORMAT	DXFormat = (DXGI_FORMAT)GPixelFormats[PixelFormat].PlatformFormat;
@@ -20,4 +21,4 @@ DXGI_FORMAT GetRenderTargetFormat(const EPixelFormat PixelFormat)
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -1,134 +1,265 @@
 // Copyright 2021 LIV Inc. - MIT License
 #pragma once
 
-#if PLATFORM_WINDOWS
+#include "LivSdk.h"
+
+#if LIV_CAPTURE_SUPPORTED
 
+#if PLATFORM_WINDOWS
 #include "Windows/AllowWindowsPlatformTypes.h"
 #include <dxgi.h>
-#include "LIV_BridgeDatastruct.h"
 #include "Windows/HideWindowsPlatformTypes.h"
+#endif
 
+#include "CoreMinimal.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "PixelFormat.h"
 
+#if PLATFORM_WINDOWS
 /**
  * Copied from D3D11Viewport.h:45
  * (Not sure I want this plugin to list D3D11RHI as a module dependency).
  */
 DXGI_FORMAT GetRenderTargetFormat(const EPixelFormat PixelFormat);
+#endif
+
+/**
+ * Axis mapping between LIV (Unity) space and UE4 space, used by every conversion below.
+ * UE4 axis N is LIV axis UnrealFromLivAxis[N] and units go from metres to centimetres.
+ * UE4				Unity
+ * X		=		Z * 100
+ * Y		=		X * 100
+ * Z		=		Y * 100
+ * W is never remapped.
+ */
+namespace LivAxisMapping
+{
+	static constexpr int32 UnrealFromLivAxis[4] = { 2, 0, 1, 3 };
+	static constexpr int32 LivFromUnrealAxis[4] = { 1, 2, 0, 3 };
+
+	static constexpr float UnrealFromLivScale = 100.0f;
+	static constexpr float LivFromUnrealScale = 1.0f / 100.0f;
+
+	static_assert(
+		LivFromUnrealAxis[UnrealFromLivAxis[0]] == 0 &&
+		LivFromUnrealAxis[UnrealFromLivAxis[1]] == 1 &&
+		LivFromUnrealAxis[UnrealFromLivAxis[2]] == 2 &&
+		LivFromUnrealAxis[UnrealFromLivAxis[3]] == 3,
+		"LIV axis mappings must be inverses of each other.");
+
+	FORCEINLINE VectorRegister UnrealFromLiv(const VectorRegister& Vector)
+	{
+		return VectorSwizzle(Vector, UnrealFromLivAxis[0], UnrealFromLivAxis[1], UnrealFromLivAxis[2], UnrealFromLivAxis[3]);
+	}
 
+	FORCEINLINE VectorRegister LivFromUnreal(const VectorRegister& Vector)
+	{
+		return VectorSwizzle(Vector, LivFromUnrealAxis[0], LivFromUnrealAxis[1], LivFromUnrealAxis[2], LivFromUnrealAxis[3]);
+	}
+
+	FORCEINLINE void VectorTranspose4x4(VectorRegister& Row0, VectorRegister& Row1, VectorRegister& Row2, VectorRegister& Row3)
+	{
+		const VectorRegister Temp0 = VectorShuffle(Row0, Row1, 0, 1, 0, 1);
+		const VectorRegister Temp1 = VectorShuffle(Row0, Row1, 2, 3, 2, 3);
+		const VectorRegister Temp2 = VectorShuffle(Row2, Row3, 0, 1, 0, 1);
+		const VectorRegister Temp3 = VectorShuffle(Row2, Row3, 2, 3, 2, 3);
+
+		Row0 = VectorShuffle(Temp0, Temp2, 0, 2, 0, 2);
+		Row1 = VectorShuffle(Temp0, Temp2, 1, 3, 1, 3);
+		Row2 = VectorShuffle(Temp1, Temp3, 0, 2, 0, 2);
+		Row3 = VectorShuffle(Temp1, Temp3, 1, 3, 1, 3);
+	}
+}
+
+/**
+ * Batch conversion between a LIV type and a UE4 type, specialised below for every supported pair.
+ */
+template<typename FromType, typename ToType>
+struct TLivConversion
+{
+	static_assert(sizeof(FromType) == 0, "No LIV conversion between these types.");
+};
+
+/**
+ * Batch conversion of positions (scaled) between a LIV type and a UE4 type.
+ */
 template<typename FromType, typename ToType>
-inline ToType Convert(const FromType& From) {}
+struct TLivPositionConversion
+{
+	static_assert(sizeof(FromType) == 0, "No LIV position conversion between these types.");
+};
 
 /**
- * Convert Unity/Liv space matrix to UE4 space matrix
+ * Convert Unity/Liv space matrices to UE4 space matrices.
+ * The rotation part is swizzled and transposed, the translation scaled, the projective column copied.
  */
 template<>
-inline FMatrix Convert<LIV_Matrix4x4, FMatrix>(const LIV_Matrix4x4& LivMatrix)
+struct TLivConversion<LIV_Matrix4x4, FMatrix>
 {
-	FMatrix M(EForceInit::ForceInitToZero);
+	static void ConvertArray(const LIV_Matrix4x4* From, FMatrix* To, int32 Num)
+	{
+		using namespace LivAxisMapping;
 
-	M.M[0][0] = LivMatrix.m22;
-	M.M[0][1] = LivMatrix.m02;
-	M.M[0][2] = LivMatrix.m12;
-	M.M[0][3] = LivMatrix.m30;
+		const VectorRegister Scale = MakeVectorRegister(1.0f, 1.0f, 1.0f, UnrealFromLivScale);
 
-	M.M[1][0] = LivMatrix.m20;
-	M.M[1][1] = LivMatrix.m00;
-	M.M[1][2] = LivMatrix.m10;
-	M.M[1][3] = LivMatrix.m31;
+		for (int32 Idx = 0; Idx < Num; ++Idx)
+		{
+			const VectorRegister LivRows[4] =
+			{
+				VectorLoad(&From[Idx].vectors[0]),
+				VectorLoad(&From[Idx].vectors[1]),
+				VectorLoad(&From[Idx].vectors[2]),
+				VectorLoad(&From[Idx].vectors[3])
+			};
 
-	M.M[2][0] = LivMatrix.m21;
-	M.M[2][1] = LivMatrix.m01;
-	M.M[2][2] = LivMatrix.m11;
-	M.M[2][3] = LivMatrix.m32;
+			VectorRegister Row0 = VectorMultiply(UnrealFromLiv(LivRows[UnrealFromLivAxis[0]]), Scale);
+			VectorRegister Row1 = VectorMultiply(UnrealFromLiv(LivRows[UnrealFromLivAxis[1]]), Scale);
+			VectorRegister Row2 = VectorMultiply(UnrealFromLiv(LivRows[UnrealFromLivAxis[2]]), Scale);
+			VectorRegister Row3 = LivRows[3];
 
-	M.M[3][0] = LivMatrix.m23 * 100.0f;
-	M.M[3][1] = LivMatrix.m03 * 100.0f;
-	M.M[3][2] = LivMatrix.m13 * 100.0f;
-	M.M[3][3] = LivMatrix.m33;
+			VectorTranspose4x4(Row0, Row1, Row2, Row3);
 
-	return M;
-}
+			VectorStore(Row0, &To[Idx].M[0][0]);
+			VectorStore(Row1, &To[Idx].M[1][0]);
+			VectorStore(Row2, &To[Idx].M[2][0]);
+			VectorStore(Row3, &To[Idx].M[3][0]);
+		}
+	}
+};
 
 /**
- * Convert UE4 space matrix to Unity/Liv space matrix
+ * Convert UE4 space matrices to Unity/Liv space matrices
  */
 template<>
-inline LIV_Matrix4x4 Convert<FMatrix, LIV_Matrix4x4>(const FMatrix& Matrix)
+struct TLivConversion<FMatrix, LIV_Matrix4x4>
 {
-	LIV_Matrix4x4 M;
+	static void ConvertArray(const FMatrix* From, LIV_Matrix4x4* To, int32 Num)
+	{
+		using namespace LivAxisMapping;
 
-	M.m22 = Matrix.M[0][0];
-	M.m02 = Matrix.M[0][1];
-	M.m12 = Matrix.M[0][2];
-	M.m30 = Matrix.M[0][3];
+		const VectorRegister Scale = MakeVectorRegister(1.0f, 1.0f, 1.0f, LivFromUnrealScale);
 
-	M.m20 = Matrix.M[1][0];
-	M.m00 = Matrix.M[1][1];
-	M.m10 = Matrix.M[1][2];
-	M.m31 = Matrix.M[1][3];
+		for (int32 Idx = 0; Idx < Num; ++Idx)
+		{
+			VectorRegister Row0 = VectorLoad(&From[Idx].M[0][0]);
+			VectorRegister Row1 = VectorLoad(&From[Idx].M[1][0]);
+			VectorRegister Row2 = VectorLoad(&From[Idx].M[2][0]);
+			VectorRegister Row3 = VectorLoad(&From[Idx].M[3][0]);
 
-	M.m21 = Matrix.M[2][0];
-	M.m01 = Matrix.M[2][1];
-	M.m11 = Matrix.M[2][2];
-	M.m32 = Matrix.M[2][3];
+			VectorTranspose4x4(Row0, Row1, Row2, Row3);
 
-	M.m23 = Matrix.M[3][0] * (1.0f / 100.0f);
-	M.m03 = Matrix.M[3][1] * (1.0f / 100.0f);
-	M.m13 = Matrix.M[3][2] * (1.0f / 100.0f);
-	M.m33 = Matrix.M[3][3];
+			VectorStore(VectorMultiply(LivFromUnreal(Row0), Scale), &To[Idx].vectors[UnrealFromLivAxis[0]]);
+			VectorStore(VectorMultiply(LivFromUnreal(Row1), Scale), &To[Idx].vectors[UnrealFromLivAxis[1]]);
+			VectorStore(VectorMultiply(LivFromUnreal(Row2), Scale), &To[Idx].vectors[UnrealFromLivAxis[2]]);
+			VectorStore(Row3, &To[Idx].vectors[3]);
+		}
+	}
+};
 
-	return M;
-}
+/**
+ * Convert Unity/Liv space quaternions to UE4 space quaternions
+ */
+template<>
+struct TLivConversion<LIV_Quaternion, FQuat>
+{
+	static void ConvertArray(const LIV_Quaternion* From, FQuat* To, int32 Num)
+	{
+		for (int32 Idx = 0; Idx < Num; ++Idx)
+		{
+			VectorStore(LivAxisMapping::UnrealFromLiv(VectorLoad(&From[Idx])), &To[Idx]);
+		}
+	}
+};
 
 /**
- * Convert Unity/Liv space quaternion to UE4 space quaternion
+ * Convert UE4 space quaternions to LIV space quaternions
  */
 template<>
-inline FQuat Convert<LIV_Quaternion, FQuat>(const LIV_Quaternion& LivQuaternion)
+struct TLivConversion<FQuat, LIV_Quaternion>
 {
-	return FQuat(LivQuaternion.z, LivQuaternion.x, LivQuaternion.y, LivQuaternion.w);
-}
+	static void ConvertArray(const FQuat* From, LIV_Quaternion* To, int32 Num)
+	{
+		for (int32 Idx = 0; Idx < Num; ++Idx)
+		{
+			VectorStore(LivAxisMapping::LivFromUnreal(VectorLoad(&From[Idx])), &To[Idx]);
+		}
+	}
+};
 
 /**
- * Convert UE4 space quaternion to LIV space quaternion
+ * Convert Unity/Liv space positions to UE4 space positions
  */
 template<>
-inline LIV_Quaternion Convert<FQuat, LIV_Quaternion>(const FQuat& Quaternion)
+struct TLivPositionConversion<LIV_Vector3, FVector>
 {
-	return LIV_Quaternion{ { Quaternion.Y, Quaternion.Z, Quaternion.X, Quaternion.W } };
+	static void ConvertArray(const LIV_Vector3* From, FVector* To, int32 Num)
+	{
+		const VectorRegister Scale = VectorSetFloat1(LivAxisMapping::UnrealFromLivScale);
+
+		for (int32 Idx = 0; Idx < Num; ++Idx)
+		{
+			VectorStoreFloat3(VectorMultiply(LivAxisMapping::UnrealFromLiv(VectorLoadFloat3(&From[Idx])), Scale), &To[Idx]);
+		}
+	}
+};
+
+/**
+ * Convert UE4 space positions to Unity/Liv space positions
+ */
+template<>
+struct TLivPositionConversion<FVector, LIV_Vector3>
+{
+	static void ConvertArray(const FVector* From, LIV_Vector3* To, int32 Num)
+	{
+		const VectorRegister Scale = VectorSetFloat1(LivAxisMapping::LivFromUnrealScale);
+
+		for (int32 Idx = 0; Idx < Num; ++Idx)
+		{
+			VectorStoreFloat3(VectorMultiply(LivAxisMapping::LivFromUnreal(VectorLoadFloat3(&From[Idx])), Scale), &To[Idx]);
+		}
+	}
+};
+
+/**
+ * Convert between LIV and UE4 space (matrices and quaternions).
+ */
+template<typename FromType, typename ToType>
+inline ToType Convert(const FromType& From)
+{
+	ToType To;
+	TLivConversion<FromType, ToType>::ConvertArray(&From, &To, 1);
+	return To;
 }
 
+/**
+ * Convert arrays of matrices or quaternions between LIV and UE4 space in one call.
+ */
 template<typename FromType, typename ToType>
-inline ToType ConvertPosition(const FromType& From) {}
+inline void ConvertArray(TArrayView<const FromType> From, TArrayView<ToType> To)
+{
+	check(From.Num() == To.Num());
+	TLivConversion<FromType, ToType>::ConvertArray(From.GetData(), To.GetData(), From.Num());
+}
 
 /**
- * Convert Unity/Liv space position to UE4 space position
- * UE4				Unity
- * X		=		Z * 100
- * Y		=		X * 100
- * Z		=		Y * 100
+ * Convert a position between LIV and UE4 space.
  */
-template<>
-inline FVector ConvertPosition<LIV_Vector3, FVector>(const LIV_Vector3& LivVector)
+template<typename FromType, typename ToType>
+inline ToType ConvertPosition(const FromType& From)
 {
-	const float Scale = 100.0f;
-	return FVector(LivVector.z * Scale, LivVector.x * Scale, LivVector.y * Scale);
+	ToType To;
+	TLivPositionConversion<FromType, ToType>::ConvertArray(&From, &To, 1);
+	return To;
 }
 
 /**
- * Convert UE4 space position to Unity/Liv space position
- * Unity			UE4
- * X		=		Y / 100
- * Y		=		Z / 100
- * Z		=		X / 100
+ * Convert arrays of positions between LIV and UE4 space in one call.
  */
-template<>
-inline LIV_Vector3 ConvertPosition<FVector, LIV_Vector3>(const FVector& Vector)
+template<typename FromType, typename ToType>
+inline void ConvertPositionArray(TArrayView<const FromType> From, TArrayView<ToType> To)
 {
-	const float Scale = 1.0 / 100.0f;
-	return LIV_Vector3{{Vector.Y * Scale, Vector.Z * Scale, Vector.X * Scale }};
+	check(From.Num() == To.Num());
+	TLivPositionConversion<FromType, ToType>::ConvertArray(From.GetData(), To.GetData(), From.Num());
 }
 
 static inline float AspectRatio(const float Width, const float Height)
@@ -191,4 +322,4 @@ static LIV_Matrix4x4 CreateLivProjectionMatrix(const FIntPoint Resolution, const
 	return LivProjectionMatrix;
 }
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
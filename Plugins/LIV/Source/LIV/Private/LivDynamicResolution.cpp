@@ -0,0 +1,75 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#include "LivDynamicResolution.h"
+
+FLivDynamicResolution::FLivDynamicResolution()
+	: MinScale(2.0f / 3.0f)
+	, ScaleStep(1.0f / 6.0f)
+	, LowerThreshold(0.95f)
+	, LowerDelay(0.5)
+	, RaiseThreshold(0.75f)
+	, RaiseDelay(3.0)
+	, Cooldown(2.0)
+	, Scale(1.0f)
+	, OverBudgetTime(0.0)
+	, UnderBudgetTime(0.0)
+	, CooldownTime(0.0)
+{
+}
+
+bool FLivDynamicResolution::Update(double DeltaTime, float GPUFrameTimeMs, float FrameBudgetMs)
+{
+	if (FrameBudgetMs <= 0.0f || GPUFrameTimeMs <= 0.0f)
+	{
+		return false;
+	}
+
+	const float Load = GPUFrameTimeMs / FrameBudgetMs;
+
+	OverBudgetTime = Load > LowerThreshold ? OverBudgetTime + DeltaTime : 0.0;
+	UnderBudgetTime = Load < RaiseThreshold ? UnderBudgetTime + DeltaTime : 0.0;
+	CooldownTime = FMath::Max(CooldownTime - DeltaTime, 0.0);
+
+	if (CooldownTime > 0.0)
+	{
+		return false;
+	}
+
+	float NewScale = Scale;
+
+	if (OverBudgetTime >= LowerDelay)
+	{
+		NewScale = FMath::Max(Scale - ScaleStep, FMath::Min(MinScale, 1.0f));
+	}
+	else if (UnderBudgetTime >= RaiseDelay)
+	{
+		NewScale = FMath::Min(Scale + ScaleStep, 1.0f);
+	}
+
+	if (FMath::IsNearlyEqual(NewScale, Scale))
+	{
+		return false;
+	}
+
+	Scale = NewScale;
+	OverBudgetTime = 0.0;
+	UnderBudgetTime = 0.0;
+	CooldownTime = Cooldown;
+
+	return true;
+}
+
+void FLivDynamicResolution::Reset()
+{
+	Scale = 1.0f;
+	OverBudgetTime = 0.0;
+	UnderBudgetTime = 0.0;
+	CooldownTime = 0.0;
+}
+
+FIntPoint FLivDynamicResolution::GetResolution(const FIntPoint& NativeResolution) const
+{
+	return FIntPoint(
+		FMath::Max(FMath::RoundToInt(NativeResolution.X * Scale * 0.5f) * 2, 2),
+		FMath::Max(FMath::RoundToInt(NativeResolution.Y * Scale * 0.5f) * 2, 2));
+}
@@ -0,0 +1,112 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#include "LivForegroundCulling.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SceneCaptureComponent2D.h"
+#include "ConvexVolume.h"
+#include "Engine/World.h"
+#include "LivCaptureBase.h"
+#include "LivPrimitiveCache.h"
+#include "SceneManagement.h"
+
+FLivForegroundCulling::FLivForegroundCulling()
+	: LastFrame(MAX_uint64)
+	, LastClipPlane(ForceInitToZero)
+	, LastFOVAngle(0.0f)
+	, LastResolution(FIntPoint::ZeroValue)
+{
+}
+
+bool FLivForegroundCulling::IsVisible(const FBoxSphereBounds& Bounds, TArrayView<const FPlane> Planes, const FConvexVolume& Frustum)
+{
+	for (const FPlane& Plane : Planes)
+	{
+		// distance from the center to the box corner deepest into the negative side
+		const float PushOut = FMath::Abs(Plane.X * Bounds.BoxExtent.X)
+			+ FMath::Abs(Plane.Y * Bounds.BoxExtent.Y)
+			+ FMath::Abs(Plane.Z * Bounds.BoxExtent.Z);
+
+		if (Plane.PlaneDot(Bounds.Origin) < -PushOut)
+		{
+			return false;
+		}
+	}
+
+	return Frustum.IntersectBox(Bounds.Origin, Bounds.BoxExtent);
+}
+
+void FLivForegroundCulling::Update(const USceneCaptureComponent2D* SceneCaptureComponent, const FPlane& ClipPlane, const FIntPoint& Resolution)
+{
+	const FTransform CameraTransform = SceneCaptureComponent->GetComponentTransform();
+
+	const bool bReuse = LastFrame == GFrameCounter
+		&& LastClipPlane.Equals(ClipPlane)
+		&& LastCameraTransform.Equals(CameraTransform)
+		&& LastFOVAngle == SceneCaptureComponent->FOVAngle
+		&& LastResolution == Resolution;
+
+	if (!bReuse)
+	{
+		Classify(SceneCaptureComponent, ClipPlane, Resolution);
+
+		LastFrame = GFrameCounter;
+		LastClipPlane = ClipPlane;
+		LastCameraTransform = CameraTransform;
+		LastFOVAngle = SceneCaptureComponent->FOVAngle;
+		LastResolution = Resolution;
+	}
+}
+
+void FLivForegroundCulling::Apply(USceneCaptureComponent2D* SceneCaptureComponent, const FIntPoint& Resolution)
+{
+	// same plane as the scene capture renderer clips with
+	Update(SceneCaptureComponent, FPlane(SceneCaptureComponent->ClipPlaneBase, SceneCaptureComponent->ClipPlaneNormal.GetSafeNormal()), Resolution);
+
+	SceneCaptureComponent->PrimitiveRenderMode = ESceneCapturePrimitiveRenderMode::PRM_UseShowOnlyList;
+	SceneCaptureComponent->ShowOnlyComponents = VisiblePrimitives;
+}
+
+void FLivForegroundCulling::Restore(USceneCaptureComponent2D* SceneCaptureComponent)
+{
+	SceneCaptureComponent->PrimitiveRenderMode = ESceneCapturePrimitiveRenderMode::PRM_RenderScenePrimitives;
+	SceneCaptureComponent->ShowOnlyComponents.Reset();
+}
+
+void FLivForegroundCulling::Classify(const USceneCaptureComponent2D* SceneCaptureComponent, const FPlane& ClipPlane, const FIntPoint& Resolution)
+{
+	VisiblePrimitives.Reset();
+
+	UWorld* World = SceneCaptureComponent->GetWorld();
+
+	if (!World)
+	{
+		return;
+	}
+
+	const TArray<TWeakObjectPtr<UPrimitiveComponent>>& Candidates = FLivPrimitiveCache::Get(World).GetPrimitives();
+	const FLivPrimitiveCache::FHiddenPrimitives HiddenPrimitives(SceneCaptureComponent);
+
+	FConvexVolume ViewFrustum;
+	GetViewFrustumBounds(ViewFrustum, ULivCaptureBase::GetCaptureViewProjectionMatrix(SceneCaptureComponent, Resolution), false);
+
+	CandidateVisible.SetNumUninitialized(Candidates.Num(), false);
+
+	// the game thread waits here, nothing changes the components or the hide lists while the workers read them
+	ParallelFor(Candidates.Num(), [this, &Candidates, &ClipPlane, &ViewFrustum, &HiddenPrimitives](int32 Index)
+	{
+		const UPrimitiveComponent* PrimitiveComponent = Candidates[Index].Get();
+
+		CandidateVisible[Index] = !HiddenPrimitives.IsHidden(PrimitiveComponent)
+			&& IsVisible(PrimitiveComponent->Bounds, MakeArrayView(&ClipPlane, 1), ViewFrustum);
+	});
+
+	for (int32 Index = 0; Index < Candidates.Num(); ++Index)
+	{
+		if (CandidateVisible[Index])
+		{
+			VisiblePrimitives.Add(Candidates[Index]);
+		}
+	}
+}
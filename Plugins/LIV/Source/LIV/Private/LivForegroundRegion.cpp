@@ -0,0 +1,165 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#include "LivForegroundRegion.h"
+
+#include "Engine/Engine.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+// keep the part of a convex polygon on the positive side of a plane (Sutherland-Hodgman)
+static void ClipPolygon(TArray<FVector, TInlineAllocator<16>>& Polygon, const FPlane& Plane)
+{
+	TArray<FVector, TInlineAllocator<16>> Clipped;
+
+	for (int32 Index = 0; Index < Polygon.Num(); ++Index)
+	{
+		const FVector& Start = Polygon[Index];
+		const FVector& End = Polygon[(Index + 1) % Polygon.Num()];
+
+		const float StartDistance = Plane.PlaneDot(Start);
+		const float EndDistance = Plane.PlaneDot(End);
+
+		if (StartDistance >= 0.0f)
+		{
+			Clipped.Add(Start);
+		}
+
+		if ((StartDistance >= 0.0f) != (EndDistance >= 0.0f))
+		{
+			Clipped.Add(FMath::Lerp(Start, End, StartDistance / (StartDistance - EndDistance)));
+		}
+	}
+
+	Polygon = MoveTemp(Clipped);
+}
+
+FIntRect FLivForegroundRegion::Compute(const FBox& Bounds, TArrayView<const FPlane> Planes, const FMatrix& ViewProjectionMatrix, const FIntPoint& Resolution, int32 Padding)
+{
+	const FIntRect FullRect(FIntPoint::ZeroValue, Resolution);
+
+	if (!Bounds.IsValid)
+	{
+		return FIntRect();
+	}
+
+	// corner N takes Max for the axes of the bits set in N (X = 1, Y = 2, Z = 4)
+	FVector Corners[8];
+
+	for (int32 Index = 0; Index < 8; ++Index)
+	{
+		Corners[Index] = FVector(
+			(Index & 1) ? Bounds.Max.X : Bounds.Min.X,
+			(Index & 2) ? Bounds.Max.Y : Bounds.Min.Y,
+			(Index & 4) ? Bounds.Max.Z : Bounds.Min.Z);
+	}
+
+	static const int32 Faces[6][4] =
+	{
+		{ 0, 2, 6, 4 }, { 1, 3, 7, 5 }, // -X / +X
+		{ 0, 1, 5, 4 }, { 2, 3, 7, 6 }, // -Y / +Y
+		{ 0, 1, 3, 2 }, { 4, 5, 7, 6 }, // -Z / +Z
+	};
+
+	FVector2D Min(MAX_flt, MAX_flt);
+	FVector2D Max(-MAX_flt, -MAX_flt);
+	bool bAnyPoint = false;
+
+	// every vertex of the clipped box lies on a box face, clipping the faces finds them all
+	for (const int32 (&Face)[4] : Faces)
+	{
+		TArray<FVector, TInlineAllocator<16>> Polygon = { Corners[Face[0]], Corners[Face[1]], Corners[Face[2]], Corners[Face[3]] };
+
+		for (const FPlane& Plane : Planes)
+		{
+			ClipPolygon(Polygon, Plane);
+		}
+
+		for (const FVector& Point : Polygon)
+		{
+			const FVector4 ClipPosition = ViewProjectionMatrix.TransformFVector4(FVector4(Point, 1.0f));
+
+			// crosses the camera plane, the projection is unbounded
+			if (ClipPosition.W <= KINDA_SMALL_NUMBER)
+			{
+				return FullRect;
+			}
+
+			const FVector2D ScreenPosition(ClipPosition.X / ClipPosition.W, ClipPosition.Y / ClipPosition.W);
+
+			const FVector2D PixelPosition(
+				(ScreenPosition.X * 0.5f + 0.5f) * Resolution.X,
+				(0.5f - ScreenPosition.Y * 0.5f) * Resolution.Y);
+
+			Min = FVector2D::Min(Min, PixelPosition);
+			Max = FVector2D::Max(Max, PixelPosition);
+			bAnyPoint = true;
+		}
+	}
+
+	if (!bAnyPoint)
+	{
+		return FIntRect();
+	}
+
+	const FIntPoint RectMin(
+		FMath::Max(FMath::FloorToInt((Min.X - Padding) / Alignment) * Alignment, 0),
+		FMath::Max(FMath::FloorToInt((Min.Y - Padding) / Alignment) * Alignment, 0));
+
+	const FIntPoint RectMax(
+		FMath::Min(FMath::CeilToInt((Max.X + Padding) / Alignment) * Alignment, Resolution.X),
+		FMath::Min(FMath::CeilToInt((Max.Y + Padding) / Alignment) * Alignment, Resolution.Y));
+
+	if (RectMin.X >= RectMax.X || RectMin.Y >= RectMax.Y)
+	{
+		return FIntRect();
+	}
+
+	return FIntRect(RectMin, RectMax);
+}
+
+FMatrix FLivForegroundRegion::CropProjectionMatrix(const FMatrix& ProjectionMatrix, const FIntRect& Rect, const FIntPoint& Resolution)
+{
+	// rect in screen space, y up
+	const FVector2D ScreenMin(2.0f * Rect.Min.X / Resolution.X - 1.0f, 1.0f - 2.0f * Rect.Max.Y / Resolution.Y);
+	const FVector2D ScreenMax(2.0f * Rect.Max.X / Resolution.X - 1.0f, 1.0f - 2.0f * Rect.Min.Y / Resolution.Y);
+
+	const FVector2D Scale(2.0f / (ScreenMax.X - ScreenMin.X), 2.0f / (ScreenMax.Y - ScreenMin.Y));
+	const FVector2D Center = (ScreenMin + ScreenMax) * 0.5f;
+
+	// stretch the rect over the whole clip space
+	return ProjectionMatrix
+		* FScaleMatrix(FVector(Scale.X, Scale.Y, 1.0f))
+		* FTranslationMatrix(FVector(-Center.X * Scale.X, -Center.Y * Scale.Y, 0.0f));
+}
+
+FBox FLivForegroundRegion::GetPlayerBounds(const UWorld* World)
+{
+	FBox Bounds(ForceInit);
+
+	const ULocalPlayer* LocalPlayer = World ? GEngine->GetFirstGamePlayer(World) : nullptr;
+	const APlayerController* PlayerController = LocalPlayer ? LocalPlayer->GetPlayerController(World) : nullptr;
+	const APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+	if (!Pawn)
+	{
+		return Bounds;
+	}
+
+	Bounds += Pawn->GetComponentsBoundingBox(true, true);
+
+	// held items, attached avatars
+	TArray<AActor*> AttachedActors;
+	Pawn->GetAttachedActors(AttachedActors);
+
+	for (const AActor* AttachedActor : AttachedActors)
+	{
+		if (AttachedActor && !AttachedActor->IsHidden())
+		{
+			Bounds += AttachedActor->GetComponentsBoundingBox(true, true);
+		}
+	}
+
+	return Bounds;
+}
@@ -0,0 +1,240 @@
+// Copyright 2021 LIV Inc. - MIT License
+#include "LivInputFramePoller.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY(LogLivInputFramePoller);
+
+FLivInputFramePoller& FLivInputFramePoller::Get()
+{
+	static FLivInputFramePoller Instance;
+	return Instance;
+}
+
+FLivInputFramePoller::FLivInputFramePoller()
+	: Thread(nullptr)
+	, WakeEvent(nullptr)
+	, bStopping(false)
+	, bBridgeActive(false)
+	, bPollInputFrames(false)
+	, PollInterval(1.0f / 90.0f)
+{
+}
+
+FLivInputFramePoller::~FLivInputFramePoller()
+{
+	Shutdown();
+}
+
+void FLivInputFramePoller::Start(float InPollRate)
+{
+	check(IsInGameThread());
+
+	if (Thread)
+	{
+		return;
+	}
+
+	PollInterval = 1.0f / FMath::Max(InPollRate, 1.0f);
+	bStopping = false;
+	bPollInputFrames = false;
+
+	// so the first tick after starting sees the right state
+	bBridgeActive = FLivNativeWrapper::IsActive();
+
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("LivInputFramePoller"), 0, TPri_AboveNormal);
+
+	if (!Thread)
+	{
+		UE_LOG(LogLivInputFramePoller, Warning, TEXT("Failed to create LIV input frame polling thread, polling on the game thread."));
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+		return;
+	}
+
+	UE_LOG(LogLivInputFramePoller, Log, TEXT("Polling LIV input frames on a background thread at %.1f Hz."), 1.0f / PollInterval);
+}
+
+void FLivInputFramePoller::Shutdown()
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	Thread->Kill(true);
+	delete Thread;
+	Thread = nullptr;
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+
+	bBridgeActive = false;
+	bPollInputFrames = false;
+}
+
+void FLivInputFramePoller::SetPollInputFrames(bool bInPollInputFrames)
+{
+	bPollInputFrames = bInPollInputFrames;
+
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
+
+void FLivInputFramePoller::SetPoseRequest(const FLivInputFramePoseRequest* InPoseRequest)
+{
+	FPoseRequest& Request = PoseRequests.GetWriteBuffer();
+	Request.bValid = InPoseRequest != nullptr;
+
+	if (InPoseRequest)
+	{
+		Request.Pose = *InPoseRequest;
+	}
+
+	PoseRequests.SwapWriteBuffers();
+}
+
+bool FLivInputFramePoller::GetLatestInputFrame(FLivInputFrame& InOutInputFrame, uint64& InOutSequence)
+{
+	if (InputFrames.IsDirty())
+	{
+		InputFrames.SwapReadBuffers();
+	}
+
+	const FLivPolledInputFrame& Latest = InputFrames.Read();
+
+	if (Latest.Sequence <= InOutSequence)
+	{
+		InOutInputFrame.DirtyFields = ELivInputFrameFields::None;
+		return false;
+	}
+
+	ELivInputFrameFields DirtyFields = ELivInputFrameFields::None;
+
+	for (int32 Group = 0; Group < FLivPolledInputFrame::NumFieldGroups; ++Group)
+	{
+		if (Latest.ChangedSequence[Group] > InOutSequence)
+		{
+			DirtyFields |= static_cast<ELivInputFrameFields>(1 << Group);
+		}
+	}
+
+	InOutInputFrame = Latest.InputFrame;
+	InOutInputFrame.DirtyFields = InOutSequence == 0 ? ELivInputFrameFields::All : DirtyFields;
+	InOutSequence = Latest.Sequence;
+
+	return true;
+}
+
+bool FLivInputFramePoller::GetInputFrameNow(FLivInputFrame& OutInputFrame, uint64& OutSequence)
+{
+	FScopeLock Lock(&BridgeCriticalSection);
+
+	OutSequence = PolledInputFrame.Sequence;
+
+	return FLivNativeWrapper::GetInputFrame(OutInputFrame);
+}
+
+bool FLivInputFramePoller::GetLatestPose_RenderThread(FLivPolledPose& OutPose)
+{
+	check(IsInRenderingThread());
+
+	if (Poses.IsDirty())
+	{
+		Poses.SwapReadBuffers();
+	}
+
+	OutPose = Poses.Read();
+
+	return OutPose.Sequence > 0;
+}
+
+bool FLivInputFramePoller::Init()
+{
+	return true;
+}
+
+uint32 FLivInputFramePoller::Run()
+{
+	while (!bStopping)
+	{
+		const double PollStartTime = FPlatformTime::Seconds();
+
+		Poll();
+
+		const double RemainingTime = PollInterval - (FPlatformTime::Seconds() - PollStartTime);
+
+		if (RemainingTime > 0.0)
+		{
+			WakeEvent->Wait(FTimespan::FromSeconds(RemainingTime));
+		}
+	}
+
+	return 0;
+}
+
+void FLivInputFramePoller::Stop()
+{
+	bStopping = true;
+
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
+
+void FLivInputFramePoller::Poll()
+{
+	FScopeLock Lock(&BridgeCriticalSection);
+
+	bBridgeActive = FLivNativeWrapper::IsActive();
+
+	FLivInputFrame& InputFrame = PolledInputFrame.InputFrame;
+
+	if (!bBridgeActive || !bPollInputFrames)
+	{
+		// decode everything when polling resumes
+		InputFrame.bDecoded = false;
+		return;
+	}
+
+	if (PoseRequests.IsDirty())
+	{
+		PoseRequests.SwapReadBuffers();
+		PoseRequest = PoseRequests.Read();
+	}
+
+	const bool bSuccess = InputFrame.bDecoded
+		? FLivNativeWrapper::UpdateInputFrame(InputFrame, PoseRequest.bValid ? &PoseRequest.Pose : nullptr)
+		: FLivNativeWrapper::GetInputFrame(InputFrame);
+
+	if (!bSuccess)
+	{
+		return;
+	}
+
+	++PolledInputFrame.Sequence;
+
+	for (int32 Group = 0; Group < FLivPolledInputFrame::NumFieldGroups; ++Group)
+	{
+		if (InputFrame.IsDirty(static_cast<ELivInputFrameFields>(1 << Group)))
+		{
+			PolledInputFrame.ChangedSequence[Group] = PolledInputFrame.Sequence;
+		}
+	}
+
+	InputFrames.GetWriteBuffer() = PolledInputFrame;
+	InputFrames.SwapWriteBuffers();
+
+	FLivPolledPose& Pose = Poses.GetWriteBuffer();
+	Pose.Location = InputFrame.CameraLocation;
+	Pose.Rotation = InputFrame.CameraRotation;
+	Pose.Sequence = PolledInputFrame.Sequence;
+	Poses.SwapWriteBuffers();
+}
@@ -0,0 +1,137 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LivNativeWrapper.h"
+#include "Containers/TripleBuffer.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLivInputFramePoller, Log, All);
+
+/**
+ * An input frame published by the poller.
+ */
+struct FLivPolledInputFrame
+{
+	FLivInputFrame InputFrame;
+
+	/** Increments with every published frame, zero until the first one. */
+	uint64 Sequence = 0;
+
+	/** Pose, ClipPlanes, Resolution */
+	static constexpr int32 NumFieldGroups = 3;
+
+	/** Sequence of the last frame each group of fields changed in, indexed by ELivInputFrameFields bit. */
+	uint64 ChangedSequence[NumFieldGroups] = { 0, 0, 0 };
+};
+
+/**
+ * Camera pose published by the poller for late latching on the render thread.
+ */
+struct FLivPolledPose
+{
+	/** Relative to the tracking origin */
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+
+	uint64 Sequence = 0;
+};
+
+/**
+ * Polls the LIV bridge on a background thread so the game thread never calls into it per frame.
+ * Publishes the bridge activity and the latest converted input frame through a triple buffer.
+ *
+ * Started by the local player subsystem when ULivPluginSettings::bPollInputFramesOnThread
+ * or bLateLatchCameraPose is set.
+ */
+class FLivInputFramePoller : public FRunnable
+{
+public:
+
+	static FLivInputFramePoller& Get();
+
+	~FLivInputFramePoller();
+
+	void Start(float InPollRate);
+	void Shutdown();
+
+	bool IsRunning() const { return Thread != nullptr; }
+
+	/**
+	 * Last result of FLivNativeWrapper::IsActive seen by the poller.
+	 */
+	bool IsBridgeActive() const { return bBridgeActive; }
+
+	/**
+	 * Start or stop polling input frames (LIV activity is always polled), call once FLivNativeWrapper::Start has been called.
+	 */
+	void SetPollInputFrames(bool bInPollInputFrames);
+
+	/**
+	 * Pose to request from LIV on following polls, game thread only.
+	 */
+	void SetPoseRequest(const FLivInputFramePoseRequest* PoseRequest);
+
+	/**
+	 * Copy the latest published input frame if there is a newer one than InOutSequence, game thread only.
+	 * DirtyFields covers every change since InOutSequence, including in frames that were never read.
+	 * Returns false (and clears DirtyFields) if there is nothing new.
+	 */
+	bool GetLatestInputFrame(FLivInputFrame& InOutInputFrame, uint64& InOutSequence);
+
+	/**
+	 * Get an input frame from the bridge right away without racing the poller thread, game thread only.
+	 * OutSequence is the sequence of the latest published frame, pass it to GetLatestInputFrame to only
+	 * receive frames polled after this one.
+	 */
+	bool GetInputFrameNow(FLivInputFrame& OutInputFrame, uint64& OutSequence);
+
+	/**
+	 * Latest camera pose from LIV, render thread only.
+	 * Returns false if no pose has been published yet.
+	 */
+	bool GetLatestPose_RenderThread(FLivPolledPose& OutPose);
+
+	// FRunnable
+
+	virtual bool Init() override;
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+
+	FLivInputFramePoller();
+
+	void Poll();
+
+	struct FPoseRequest
+	{
+		FLivInputFramePoseRequest Pose;
+		bool bValid = false;
+	};
+
+	FRunnableThread* Thread;
+	FEvent* WakeEvent;
+	FThreadSafeBool bStopping;
+	FThreadSafeBool bBridgeActive;
+	FThreadSafeBool bPollInputFrames;
+	float PollInterval;
+
+	/** Game thread to poller. */
+	TTripleBuffer<FPoseRequest> PoseRequests;
+
+	/** Poller to game thread. */
+	TTripleBuffer<FLivPolledInputFrame> InputFrames;
+
+	/** Poller to render thread. */
+	TTripleBuffer<FLivPolledPose> Poses;
+
+	/** Held while calling into the bridge, the LIV SDK is not thread safe. */
+	FCriticalSection BridgeCriticalSection;
+
+	// poller thread only (or holding BridgeCriticalSection)
+
+	FLivPolledInputFrame PolledInputFrame;
+	FPoseRequest PoseRequest;
+};
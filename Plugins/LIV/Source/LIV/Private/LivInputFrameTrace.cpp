@@ -0,0 +1,324 @@
+// Copyright 2021 LIV Inc. - MIT License
+#include "LivInputFrameTrace.h"
+
+#if LIV_WITH_INPUT_FRAME_TRACE
+
+#include "LivLoopbackBridge.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY(LogLivInputFrameTrace);
+
+static TAutoConsoleVariable<bool> CVarLivTraceReplayTimed(TEXT("Liv.Trace.Replay.Timed"),
+	false,
+	TEXT("Replay input frames at the pace they were recorded rather than one record per frame."),
+	ECVF_Default);
+
+static FString GetTraceFilename(const FString& Filename)
+{
+	// relative paths are relative to Saved/Liv
+	return FPaths::IsRelative(Filename) ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Liv"), Filename) : Filename;
+}
+
+void LivInputFrameTrace::StartFromCommandLine()
+{
+	FString Filename;
+
+	if (FParse::Value(FCommandLine::Get(), TEXT("LivRecord="), Filename))
+	{
+		FLivInputFrameRecorder::Get().Start(Filename);
+	}
+
+#if LIV_WITH_LOOPBACK
+	if (FParse::Value(FCommandLine::Get(), TEXT("LivReplay="), Filename))
+	{
+		FLivInputFrameReplay::Get().Open(Filename);
+	}
+#endif
+}
+
+bool LivInputFrameTrace::IsReplayRequested()
+{
+	FString Filename;
+	return FParse::Value(FCommandLine::Get(), TEXT("LivReplay="), Filename);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+FLivInputFrameRecorder& FLivInputFrameRecorder::Get()
+{
+	static FLivInputFrameRecorder Instance;
+	return Instance;
+}
+
+bool FLivInputFrameRecorder::Start(const FString& Filename)
+{
+	Stop();
+
+	FScopeLock Lock(&CriticalSection);
+
+	const FString Path = GetTraceFilename(Filename);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Path));
+
+	FileHandle.Reset(PlatformFile.OpenWrite(*Path));
+
+	if (!FileHandle.IsValid())
+	{
+		UE_LOG(LogLivInputFrameTrace, Warning, TEXT("Failed to open input frame trace for writing: %s"), *Path);
+		return false;
+	}
+
+	const FLivInputFrameTraceHeader Header
+	{
+		FLivInputFrameTraceHeader::ExpectedMagic,
+		FLivInputFrameTraceHeader::ExpectedVersion,
+		sizeof(FLivInputFrameTraceRecord),
+		0
+	};
+
+	FileHandle->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+
+	StartTime = FPlatformTime::Seconds();
+	NumRecords = 0;
+
+	UE_LOG(LogLivInputFrameTrace, Log, TEXT("Recording input frames to: %s"), *Path);
+	return true;
+}
+
+void FLivInputFrameRecorder::Stop()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	if (FileHandle.IsValid())
+	{
+		FileHandle->Flush();
+		FileHandle.Reset();
+
+		UE_LOG(LogLivInputFrameTrace, Log, TEXT("Stopped recording input frames (%llu frames)."), NumRecords);
+	}
+}
+
+void FLivInputFrameRecorder::Record(const LIV_InputFrame& InputFrame)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	if (!FileHandle.IsValid())
+	{
+		return;
+	}
+
+	FLivInputFrameTraceRecord Record;
+	FMemory::Memzero(Record);
+
+	Record.Timestamp = FPlatformTime::Seconds() - StartTime;
+	Record.FrameId = InputFrame.frameid;
+	Record.Features = InputFrame.features;
+	Record.Pose = InputFrame.pose;
+	Record.ClipPlane = InputFrame.clipPlane;
+	Record.GroundPlane = InputFrame.GroundPlane;
+	Record.StageTransform = InputFrame.StageTransform;
+
+	FileHandle->Write(reinterpret_cast<const uint8*>(&Record), sizeof(Record));
+	++NumRecords;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+#if LIV_WITH_LOOPBACK
+
+FLivInputFrameReplay::~FLivInputFrameReplay()
+{
+	Close();
+}
+
+FLivInputFrameReplay& FLivInputFrameReplay::Get()
+{
+	static FLivInputFrameReplay Instance;
+	return Instance;
+}
+
+bool FLivInputFrameReplay::Open(const FString& Filename)
+{
+	Close();
+
+	const FString Path = GetTraceFilename(Filename);
+
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+
+	if (!MappedFile.IsValid() || MappedFile->GetFileSize() < static_cast<int64>(sizeof(FLivInputFrameTraceHeader)))
+	{
+		UE_LOG(LogLivInputFrameTrace, Warning, TEXT("Failed to map input frame trace: %s"), *Path);
+		Close();
+		return false;
+	}
+
+	MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+
+	if (!MappedRegion.IsValid())
+	{
+		UE_LOG(LogLivInputFrameTrace, Warning, TEXT("Failed to map input frame trace: %s"), *Path);
+		Close();
+		return false;
+	}
+
+	const FLivInputFrameTraceHeader* Header = reinterpret_cast<const FLivInputFrameTraceHeader*>(MappedRegion->GetMappedPtr());
+
+	if (Header->Magic != FLivInputFrameTraceHeader::ExpectedMagic
+		|| Header->Version != FLivInputFrameTraceHeader::ExpectedVersion
+		|| Header->RecordSize != sizeof(FLivInputFrameTraceRecord))
+	{
+		UE_LOG(LogLivInputFrameTrace, Warning, TEXT("Input frame trace is not compatible with this build: %s"), *Path);
+		Close();
+		return false;
+	}
+
+	const int64 RecordBytes = MappedRegion->GetMappedSize() - sizeof(FLivInputFrameTraceHeader);
+	const int64 NumRecordsInFile = RecordBytes / sizeof(FLivInputFrameTraceRecord);
+
+	if (NumRecordsInFile <= 0)
+	{
+		UE_LOG(LogLivInputFrameTrace, Warning, TEXT("Input frame trace is empty: %s"), *Path);
+		Close();
+		return false;
+	}
+
+	Records = reinterpret_cast<const FLivInputFrameTraceRecord*>(MappedRegion->GetMappedPtr() + sizeof(FLivInputFrameTraceHeader));
+	NumRecords = static_cast<int32>(FMath::Min<int64>(NumRecordsInFile, MAX_int32));
+
+	PlaybackStartTime = -1.0;
+
+	FLivLoopbackBridge::Get().SetInputFrameSource([this](uint64 FrameId, LIV_InputFrame& OutInputFrame)
+	{
+		if (!CVarLivTraceReplayTimed.GetValueOnAnyThread())
+		{
+			ToInputFrame(GetRecordForFrame(FrameId), OutInputFrame);
+			return;
+		}
+
+		const double Now = FPlatformTime::Seconds();
+
+		// start the clock on the first request so loading doesn't eat into the trace,
+		// frame ids restart from one when the bridge is reset
+		if (PlaybackStartTime < 0.0 || FrameId <= 1)
+		{
+			PlaybackStartTime = Now;
+		}
+
+		ToInputFrame(GetRecordAtTime(Now - PlaybackStartTime), OutInputFrame);
+	});
+
+	UE_LOG(LogLivInputFrameTrace, Log, TEXT("Replaying %d input frames (%.2fs) from: %s"), NumRecords, GetDuration(), *Path);
+	return true;
+}
+
+void FLivInputFrameReplay::Close()
+{
+	if (NumRecords > 0)
+	{
+		FLivLoopbackBridge::Get().SetInputFrameSource(nullptr);
+	}
+
+	Records = nullptr;
+	NumRecords = 0;
+	PlaybackStartTime = -1.0;
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+double FLivInputFrameReplay::GetDuration() const
+{
+	if (NumRecords < 2)
+	{
+		return 0.0;
+	}
+
+	const double Span = Records[NumRecords - 1].Timestamp - Records[0].Timestamp;
+	return FMath::Max(Span * NumRecords / (NumRecords - 1), 0.0);
+}
+
+const FLivInputFrameTraceRecord& FLivInputFrameReplay::GetRecordForFrame(uint64 FrameId) const
+{
+	check(IsOpen());
+
+	return Records[(FMath::Max<uint64>(FrameId, 1) - 1) % static_cast<uint64>(NumRecords)];
+}
+
+const FLivInputFrameTraceRecord& FLivInputFrameReplay::GetRecordAtTime(double Time) const
+{
+	check(IsOpen());
+
+	const double Duration = GetDuration();
+	const double TraceTime = Records[0].Timestamp + (Duration > 0.0 ? FMath::Fmod(FMath::Max(Time, 0.0), Duration) : 0.0);
+
+	// last record at or before the trace time, timestamps are in recording order
+	const int32 Index = Algo::UpperBoundBy(TArrayView<const FLivInputFrameTraceRecord>(Records, NumRecords), TraceTime, &FLivInputFrameTraceRecord::Timestamp) - 1;
+
+	return Records[FMath::Clamp(Index, 0, NumRecords - 1)];
+}
+
+void FLivInputFrameReplay::ToInputFrame(const FLivInputFrameTraceRecord& Record, LIV_InputFrame& OutInputFrame)
+{
+	OutInputFrame.pose = Record.Pose;
+	OutInputFrame.clipPlane = Record.ClipPlane;
+	OutInputFrame.GroundPlane = Record.GroundPlane;
+	OutInputFrame.StageTransform = Record.StageTransform;
+	OutInputFrame.features = Record.Features;
+}
+
+#endif // LIV_WITH_LOOPBACK
+
+///////////////////////////////////////////////////////////////////////
+
+static FAutoConsoleCommand LivTraceRecordCommand(
+	TEXT("Liv.Trace.Record"),
+	TEXT("Record LIV input frames to a trace file (relative to Saved/Liv). Usage: Liv.Trace.Record File"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() < 1)
+		{
+			UE_LOG(LogLivInputFrameTrace, Warning, TEXT("Usage: Liv.Trace.Record File"));
+			return;
+		}
+
+		FLivInputFrameRecorder::Get().Start(Args[0]);
+	}));
+
+static FAutoConsoleCommand LivTraceStopCommand(
+	TEXT("Liv.Trace.Stop"),
+	TEXT("Stop recording LIV input frames."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FLivInputFrameRecorder::Get().Stop();
+	}));
+
+#if LIV_WITH_LOOPBACK
+static FAutoConsoleCommand LivTraceReplayCommand(
+	TEXT("Liv.Trace.Replay"),
+	TEXT("Replay LIV input frames from a trace file through the loopback bridge (requires -LivLoopback). Usage: Liv.Trace.Replay File"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() < 1)
+		{
+			FLivInputFrameReplay::Get().Close();
+			return;
+		}
+
+		if (!FLivLoopbackBridge::IsRequested())
+		{
+			UE_LOG(LogLivInputFrameTrace, Warning, TEXT("Replaying input frames requires the loopback bridge (-LivLoopback)."));
+			return;
+		}
+
+		FLivLoopbackBridge::Get().Reset();
+		FLivInputFrameReplay::Get().Open(Args[0]);
+	}));
+#endif
+
+#endif
@@ -0,0 +1,142 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LivSdk.h"
+
+#if LIV_WITH_INPUT_FRAME_TRACE
+
+#include "Async/MappedFileHandle.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLivInputFrameTrace, Log, All);
+
+namespace LivInputFrameTrace
+{
+	/**
+	 * Start recording/replaying if requested with -LivRecord=<file> or -LivReplay=<file>.
+	 */
+	void StartFromCommandLine();
+
+	/**
+	 * Returns true if a replay was requested on the command line (requires the loopback bridge).
+	 */
+	bool IsReplayRequested();
+}
+
+/**
+ * Header at the start of every input frame trace file.
+ */
+struct FLivInputFrameTraceHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x5643544C; // "LTCV"
+	static constexpr uint32 ExpectedVersion = 1;
+
+	uint32 Magic;
+	uint32 Version;
+	uint32 RecordSize;
+	uint32 Reserved;
+};
+
+/**
+ * One fixed size record per input frame, written as-is so a trace can be memory mapped and indexed directly.
+ */
+struct FLivInputFrameTraceRecord
+{
+	/** Seconds since the recording started. */
+	double Timestamp;
+
+	uint64 FrameId;
+	LIV_FEATURES_ENUM Features;
+	LIV_Pose Pose;
+	LIV_ClipPlane ClipPlane;
+	LIV_ClipPlane GroundPlane;
+	LIV_Transform StageTransform;
+};
+
+/**
+ * Appends every input frame returned by the bridge to a trace file.
+ * Start with -LivRecord=<file> or Liv.Trace.Record <file>.
+ */
+class FLivInputFrameRecorder
+{
+public:
+
+	static FLivInputFrameRecorder& Get();
+
+	bool Start(const FString& Filename);
+	void Stop();
+
+	bool IsRecording() const { return FileHandle.IsValid(); }
+
+	/**
+	 * Called by FLivNativeWrapper for every input frame it receives (possibly from the polling thread).
+	 */
+	void Record(const LIV_InputFrame& InputFrame);
+
+private:
+
+	FCriticalSection CriticalSection;
+	TUniquePtr<IFileHandle> FileHandle;
+	double StartTime = 0.0;
+	uint64 NumRecords = 0;
+};
+
+#if LIV_WITH_LOOPBACK
+
+/**
+ * Memory maps a trace file and serves its input frames through the loopback bridge (looping). By default the
+ * bridge's frame N gets record (N - 1) % Num(), so every run (and every capture method) sees the same sequence
+ * of input frames whatever its frame rate, and resetting the bridge rewinds the trace.
+ * With Liv.Trace.Replay.Timed 1 frames are instead picked at the pace they were recorded, a fast game sees the
+ * same record more than once and a slow one skips records, as it would with the LIV App.
+ * Start with -LivReplay=<file> (implies -LivLoopback) or Liv.Trace.Replay <file>.
+ */
+class FLivInputFrameReplay
+{
+public:
+
+	~FLivInputFrameReplay();
+
+	static FLivInputFrameReplay& Get();
+
+	bool Open(const FString& Filename);
+	void Close();
+
+	bool IsOpen() const { return NumRecords > 0; }
+	int32 Num() const { return NumRecords; }
+
+	/**
+	 * Seconds the trace takes to play once, including the average frame interval so a loop doesn't repeat its last frame.
+	 */
+	double GetDuration() const;
+
+	/**
+	 * Record served for a loopback bridge frame id (starting at one), wrapping around at the end of the trace.
+	 */
+	const FLivInputFrameTraceRecord& GetRecordForFrame(uint64 FrameId) const;
+
+	/**
+	 * Most recent record at a time (seconds) since playback started, wrapping around at the end of the trace.
+	 */
+	const FLivInputFrameTraceRecord& GetRecordAtTime(double Time) const;
+
+	/**
+	 * Fill an input frame from a record, as the bridge would have returned it.
+	 */
+	static void ToInputFrame(const FLivInputFrameTraceRecord& Record, LIV_InputFrame& OutInputFrame);
+
+private:
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	const FLivInputFrameTraceRecord* Records = nullptr;
+	int32 NumRecords = 0;
+
+	/** FPlatformTime::Seconds() when the first frame was served in timed mode, restarts with the bridge's frame ids. */
+	double PlaybackStartTime = -1.0;
+};
+
+#endif // LIV_WITH_LOOPBACK
+
+#endif // LIV_WITH_INPUT_FRAME_TRACE
@@ -0,0 +1,254 @@
+// Copyright 2021 LIV Inc. - MIT License
+#include "LivLatencyTracker.h"
+
+#if LIV_WITH_LATENCY_TRACKING
+
+#include "LivNativeWrapper.h"
+#include "LivStats.h"
+#include "Misc/CoreDelegates.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "RenderingThread.h"
+
+static TAutoConsoleVariable<bool> CVarLivLatencyTrack(TEXT("Liv.Latency.Track"),
+	true,
+	TEXT("Time every capture from its LIV input frame to GPU completion (stat Liv, Liv CSV category)."),
+	ECVF_Default);
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input To Capture p50 (ms)"), STAT_LivInputToCaptureP50, STATGROUP_Liv);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input To Capture p95 (ms)"), STAT_LivInputToCaptureP95, STATGROUP_Liv);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Capture To Render p50 (ms)"), STAT_LivCaptureToRenderP50, STATGROUP_Liv);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Capture To Render p95 (ms)"), STAT_LivCaptureToRenderP95, STATGROUP_Liv);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Render To Submit p50 (ms)"), STAT_LivRenderToSubmitP50, STATGROUP_Liv);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Render To Submit p95 (ms)"), STAT_LivRenderToSubmitP95, STATGROUP_Liv);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Submit To GPU Complete p50 (ms)"), STAT_LivSubmitToGPUP50, STATGROUP_Liv);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Submit To GPU Complete p95 (ms)"), STAT_LivSubmitToGPUP95, STATGROUP_Liv);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input To Submit p50 (ms)"), STAT_LivInputToSubmitP50, STATGROUP_Liv);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input To Submit p95 (ms)"), STAT_LivInputToSubmitP95, STATGROUP_Liv);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input To GPU Complete p50 (ms)"), STAT_LivInputToGPUP50, STATGROUP_Liv);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input To GPU Complete p95 (ms)"), STAT_LivInputToGPUP95, STATGROUP_Liv);
+
+CSV_DEFINE_CATEGORY(Liv, true);
+
+DEFINE_LOG_CATEGORY_STATIC(LogLivLatency, Log, All);
+
+// percentiles are over this many of the most recent captures
+static constexpr int32 LivLatencyHistorySize = 120;
+
+// stop timing frames the GPU is this far behind on
+static constexpr int32 LivLatencyMaxInFlight = 8;
+
+static float GetSortedPercentile(const TArray<float>& SortedValues, float Percentile)
+{
+	if (SortedValues.Num() == 0)
+	{
+		return 0.0f;
+	}
+
+	const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1);
+	return SortedValues[Index];
+}
+
+FLivLatencyTracker& FLivLatencyTracker::Get()
+{
+	static FLivLatencyTracker Instance;
+	return Instance;
+}
+
+void FLivLatencyTracker::Startup()
+{
+	FLivLatencyTracker& Tracker = Get();
+
+	if (!Tracker.BeginFrameHandle.IsValid())
+	{
+		Tracker.BeginFrameHandle = FCoreDelegates::OnBeginFrameRT.AddRaw(&Tracker, &FLivLatencyTracker::OnBeginFrame_RenderThread);
+	}
+
+	if (!Tracker.EnginePreExitHandle.IsValid())
+	{
+		// modules shut down after the RHI, the fences must be gone by then
+		Tracker.EnginePreExitHandle = FCoreDelegates::OnEnginePreExit.AddStatic(&FLivLatencyTracker::Shutdown);
+	}
+}
+
+void FLivLatencyTracker::Shutdown()
+{
+	FLivLatencyTracker& Tracker = Get();
+
+	if (Tracker.EnginePreExitHandle.IsValid())
+	{
+		FCoreDelegates::OnEnginePreExit.Remove(Tracker.EnginePreExitHandle);
+		Tracker.EnginePreExitHandle.Reset();
+	}
+
+	if (!Tracker.BeginFrameHandle.IsValid())
+	{
+		return;
+	}
+
+	FCoreDelegates::OnBeginFrameRT.Remove(Tracker.BeginFrameHandle);
+	Tracker.BeginFrameHandle.Reset();
+
+	// render thread state, runs inline once the render thread has stopped
+	ENQUEUE_RENDER_COMMAND(LivLatencyShutdown)(
+		[&Tracker](FRHICommandListImmediate& RHICmdList)
+		{
+			Tracker.InFlightRecords.Empty();
+			Tracker.bHasPendingRecord = false;
+		});
+
+	FlushRenderingCommands();
+}
+
+void FLivLatencyTracker::OnCapture(const FLivInputFrame& InputFrame)
+{
+	// not started or already shut down
+	if (!BeginFrameHandle.IsValid() || !CVarLivLatencyTrack.GetValueOnGameThread())
+	{
+		return;
+	}
+
+	FLivLatencyRecord Record;
+	Record.InputFrameId = InputFrame.FrameId;
+	Record.InputFrameTime = InputFrame.Timestamp;
+	Record.CaptureTime = FPlatformTime::Seconds();
+
+	// ordered before the render commands of the capture itself
+	ENQUEUE_RENDER_COMMAND(LivLatencyCapture)(
+		[this, Record](FRHICommandListImmediate& RHICmdList)
+		{
+			PendingRecord = Record;
+			bHasPendingRecord = true;
+		});
+}
+
+void FLivLatencyTracker::OnSubmitBegin_RenderThread()
+{
+	if (bHasPendingRecord)
+	{
+		PendingRecord.RenderTime = FPlatformTime::Seconds();
+	}
+}
+
+void FLivLatencyTracker::OnSubmitEnd_RenderThread(FRHICommandList& RHICmdList)
+{
+	if (!bHasPendingRecord)
+	{
+		return;
+	}
+
+	bHasPendingRecord = false;
+	PendingRecord.SubmitTime = FPlatformTime::Seconds();
+
+	if (InFlightRecords.Num() >= LivLatencyMaxInFlight)
+	{
+		InFlightRecords.RemoveAt(0, 1, false);
+	}
+
+	FInFlightRecord& InFlightRecord = InFlightRecords.AddDefaulted_GetRef();
+	InFlightRecord.Record = PendingRecord;
+	InFlightRecord.Fence = RHICreateGPUFence(TEXT("LivLatency"));
+
+	RHICmdList.WriteGPUFence(InFlightRecord.Fence);
+}
+
+bool FLivLatencyTracker::TakePendingRecord_RenderThread(FLivLatencyRecord& OutRecord)
+{
+	if (!bHasPendingRecord)
+	{
+		return false;
+	}
+
+	bHasPendingRecord = false;
+	OutRecord = PendingRecord;
+	return true;
+}
+
+void FLivLatencyTracker::OnSubmitted_RenderThread(const FLivLatencyRecord& Record)
+{
+	// shut down while the submit thread had it
+	if (!BeginFrameHandle.IsValid())
+	{
+		return;
+	}
+
+	CompleteRecord_RenderThread(Record);
+}
+
+bool FLivLatencyTracker::GetLatestRecord(FLivLatencyRecord& OutRecord) const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	if (CompletedRecords.Num() == 0)
+	{
+		return false;
+	}
+
+	const int32 LatestIndex = (NextCompletedRecord + CompletedRecords.Num() - 1) % CompletedRecords.Num();
+	OutRecord = CompletedRecords[LatestIndex];
+	return true;
+}
+
+void FLivLatencyTracker::OnBeginFrame_RenderThread()
+{
+	// fences signal in the order they were written
+	while (InFlightRecords.Num() > 0 && InFlightRecords[0].Fence->Poll())
+	{
+		InFlightRecords[0].Record.GPUCompleteTime = FPlatformTime::Seconds();
+		CompleteRecord_RenderThread(InFlightRecords[0].Record);
+		InFlightRecords.RemoveAt(0, 1, false);
+	}
+}
+
+void FLivLatencyTracker::CompleteRecord_RenderThread(const FLivLatencyRecord& Record)
+{
+	UE_LOG(LogLivLatency, VeryVerbose, TEXT("Input frame %llu: input to capture %.2fms, to submit %.2fms, to GPU complete %.2fms."),
+		Record.InputFrameId,
+		(Record.CaptureTime - Record.InputFrameTime) * 1000.0,
+		(Record.SubmitTime - Record.InputFrameTime) * 1000.0,
+		(Record.GPUCompleteTime - Record.InputFrameTime) * 1000.0);
+
+	CSV_CUSTOM_STAT(Liv, InputToCaptureMs, static_cast<float>((Record.CaptureTime - Record.InputFrameTime) * 1000.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Liv, CaptureToRenderMs, static_cast<float>((Record.RenderTime - Record.CaptureTime) * 1000.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Liv, RenderToSubmitMs, static_cast<float>((Record.SubmitTime - Record.RenderTime) * 1000.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Liv, SubmitToGPUCompleteMs, static_cast<float>(FMath::Max(Record.GPUCompleteTime - Record.SubmitTime, 0.0) * 1000.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Liv, InputToGPUCompleteMs, static_cast<float>((Record.GPUCompleteTime - Record.InputFrameTime) * 1000.0), ECsvCustomStatOp::Set);
+
+	FScopeLock Lock(&CriticalSection);
+
+	if (CompletedRecords.Num() < LivLatencyHistorySize)
+	{
+		CompletedRecords.Add(Record);
+	}
+	else
+	{
+		CompletedRecords[NextCompletedRecord] = Record;
+	}
+
+	NextCompletedRecord = (NextCompletedRecord + 1) % LivLatencyHistorySize;
+
+#if STATS
+	TArray<float> Values;
+	Values.Reserve(CompletedRecords.Num());
+
+#define LIV_SET_LATENCY_STATS(Stage, From, To) \
+	Values.Reset(); \
+	for (const FLivLatencyRecord& Completed : CompletedRecords) \
+	{ \
+		Values.Add(static_cast<float>(FMath::Max(Completed.To - Completed.From, 0.0) * 1000.0)); \
+	} \
+	Values.Sort(); \
+	SET_FLOAT_STAT(STAT_Liv##Stage##P50, GetSortedPercentile(Values, 0.5f)); \
+	SET_FLOAT_STAT(STAT_Liv##Stage##P95, GetSortedPercentile(Values, 0.95f));
+
+	LIV_SET_LATENCY_STATS(InputToCapture, InputFrameTime, CaptureTime);
+	LIV_SET_LATENCY_STATS(CaptureToRender, CaptureTime, RenderTime);
+	LIV_SET_LATENCY_STATS(RenderToSubmit, RenderTime, SubmitTime);
+	LIV_SET_LATENCY_STATS(SubmitToGPU, SubmitTime, GPUCompleteTime);
+	LIV_SET_LATENCY_STATS(InputToSubmit, InputFrameTime, SubmitTime);
+	LIV_SET_LATENCY_STATS(InputToGPU, InputFrameTime, GPUCompleteTime);
+
+#undef LIV_SET_LATENCY_STATS
+#endif
+}
+
+#endif
@@ -0,0 +1,117 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LivSdk.h"
+
+#if LIV_WITH_LATENCY_TRACKING
+
+#include "RHI.h"
+#include "RHIResources.h"
+
+struct FLivInputFrame;
+
+/**
+ * Timestamps (FPlatformTime::Seconds()) of one captured frame on its way from a LIV input frame to the compositor.
+ */
+struct FLivLatencyRecord
+{
+	/** frameid of the LIV input frame the capture used. */
+	uint64 InputFrameId = 0;
+
+	/** Input frame received from LIV (on the game thread or the polling thread). */
+	double InputFrameTime = 0.0;
+
+	/** Game thread started the capture. */
+	double CaptureTime = 0.0;
+
+	/** Render graph executed the submit pass. */
+	double RenderTime = 0.0;
+
+	/** LIV_Submit returned. */
+	double SubmitTime = 0.0;
+
+	/**
+	 * Render thread saw the GPU pass the fence written after the submit, accurate to a render thread frame.
+	 * With Liv.SubmitThread the submit thread saw the fence it waits for before submitting, so this precedes SubmitTime.
+	 */
+	double GPUCompleteTime = 0.0;
+};
+
+/**
+ * Follows every capture from its input frame to GPU completion and publishes latency percentiles
+ * to "stat Liv" and, while a CSV capture is running (csvprofile start), to the Liv CSV category.
+ *
+ * Every completed frame is logged with its input frame id at VeryVerbose (log LogLivLatency VeryVerbose).
+ *
+ * Disable with Liv.Latency.Track 0.
+ */
+class FLivLatencyTracker
+{
+public:
+
+	static FLivLatencyTracker& Get();
+
+	static void Startup();
+
+	/**
+	 * Stop tracking and release the GPU fences, also called when the engine starts exiting (before the RHI is shut down).
+	 */
+	static void Shutdown();
+
+	/**
+	 * Game thread, when a capture has updated its input frame. Tags the next submit on the render thread.
+	 */
+	void OnCapture(const FLivInputFrame& InputFrame);
+
+	/**
+	 * Render thread, from the submit pass before any textures are added.
+	 */
+	void OnSubmitBegin_RenderThread();
+
+	/**
+	 * Render thread, from the submit pass after LIV_Submit, writes the fence used to time GPU completion.
+	 */
+	void OnSubmitEnd_RenderThread(FRHICommandList& RHICmdList);
+
+	/**
+	 * Render thread, from the submit pass instead of OnSubmitEnd_RenderThread when the submission is handed to the
+	 * submit thread. Returns false if the frame isn't being timed.
+	 */
+	bool TakePendingRecord_RenderThread(FLivLatencyRecord& OutRecord);
+
+	/**
+	 * Render thread, with a record taken by TakePendingRecord_RenderThread once the submit thread has submitted it
+	 * and stamped SubmitTime and GPUCompleteTime.
+	 */
+	void OnSubmitted_RenderThread(const FLivLatencyRecord& Record);
+
+	/**
+	 * Most recent frame that completed on the GPU, returns false if none has yet.
+	 */
+	bool GetLatestRecord(FLivLatencyRecord& OutRecord) const;
+
+private:
+
+	struct FInFlightRecord
+	{
+		FLivLatencyRecord Record;
+		FGPUFenceRHIRef Fence;
+	};
+
+	void OnBeginFrame_RenderThread();
+	void CompleteRecord_RenderThread(const FLivLatencyRecord& Record);
+
+	// render thread
+	FLivLatencyRecord PendingRecord;
+	bool bHasPendingRecord = false;
+	TArray<FInFlightRecord> InFlightRecords;
+	FDelegateHandle BeginFrameHandle;
+	FDelegateHandle EnginePreExitHandle;
+
+	mutable FCriticalSection CriticalSection;
+	TArray<FLivLatencyRecord> CompletedRecords;
+	int32 NextCompletedRecord = 0;
+};
+
+#endif
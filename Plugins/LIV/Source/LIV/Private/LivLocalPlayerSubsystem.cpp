@@ -1,6 +1,7 @@
 // Copyright 2021 LIV Inc. - MIT License
 #include "LivLocalPlayerSubsystem.h"
 #include "LivCaptureMeshClipPlaneNoPostProcess.h"
+#include "LivInputFramePoller.h"
 #include "LivPluginSettings.h"
 #include "LivModule.h"
 #include "LivWorldSubsystem.h"
@@ -14,6 +15,12 @@ DEFINE_LOG_CATEGORY(LogLivLocalPlayerSubsystem);
 
 static TWeakObjectPtr<ULivLocalPlayerSubsystem> MainLocalPlayerSubsystem { nullptr };
 
+static bool IsLivBridgeActive()
+{
+	const FLivInputFramePoller& Poller = FLivInputFramePoller::Get();
+	return Poller.IsRunning() ? Poller.IsBridgeActive() : FLivNativeWrapper::IsActive();
+}
+
 ULivLocalPlayerSubsystem::ULivLocalPlayerSubsystem()
 	: Super()
 {
@@ -49,6 +56,17 @@ void ULivLocalPlayerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 		TickHandle = FTicker::GetCoreTicker().AddTicker(
 			FTickerDelegate::CreateUObject(this, &ULivLocalPlayerSubsystem::Tick)
 		);
+
+		const ULivPluginSettings* Settings = GetDefault<ULivPluginSettings>();
+		if (Settings->bPollInputFramesOnThread || Settings->bLateLatchCameraPose)
+		{
+			if (!Settings->bPollInputFramesOnThread)
+			{
+				UE_LOG(LogLivLocalPlayerSubsystem, Log, TEXT("Late latching the LIV camera pose requires polling input frames on a background thread, starting the poller."));
+			}
+
+			FLivInputFramePoller::Get().Start(Settings->InputFramePollRate);
+		}
 	}
 }
 
@@ -69,6 +87,11 @@ void ULivLocalPlayerSubsystem::Deinitialize()
 	}
 	
 	LivCaptureDeactivated();
+
+	if (MainLocalPlayerSubsystem.Get() == this)
+	{
+		FLivInputFramePoller::Get().Shutdown();
+	}
 }
 
 ULivWorldSubsystem* ULivLocalPlayerSubsystem::GetLivWorldSubsystem() const
@@ -129,44 +152,52 @@ void ULivLocalPlayerSubsystem::ResetCapture()
 
 void ULivLocalPlayerSubsystem::HideComponent(UPrimitiveComponent* InComponent)
 {
-	if (InComponent)
-	{
-		CaptureContext.HiddenComponents.AddUnique(InComponent);
-	}
+	CaptureContext.HideComponents(MakeArrayView(&InComponent, 1));
 }
 
 void ULivLocalPlayerSubsystem::ShowComponent(UPrimitiveComponent* InComponent)
 {
-	if (InComponent)
-	{
-		CaptureContext.HiddenComponents.Remove(InComponent);
-	}
+	CaptureContext.ShowComponents(MakeArrayView(&InComponent, 1));
+}
+
+void ULivLocalPlayerSubsystem::HideComponents(const TArray<UPrimitiveComponent*>& InComponents)
+{
+	CaptureContext.HideComponents(InComponents);
+}
+
+void ULivLocalPlayerSubsystem::ShowComponents(const TArray<UPrimitiveComponent*>& InComponents)
+{
+	CaptureContext.ShowComponents(InComponents);
 }
 
 void ULivLocalPlayerSubsystem::ClearHiddenComponents()
 {
-	CaptureContext.HiddenComponents.Reset();
+	CaptureContext.ClearHiddenComponents();
 }
 
 void ULivLocalPlayerSubsystem::HideActor(AActor* InActor)
 {
-	if (InActor)
-	{
-		CaptureContext.HiddenActors.AddUnique(InActor);
-	}
+	CaptureContext.HideActors(MakeArrayView(&InActor, 1));
 }
 
 void ULivLocalPlayerSubsystem::ShowActor(AActor* InActor)
 {
-	if (InActor)
-	{
-		CaptureContext.HiddenActors.Remove(InActor);
-	}
+	CaptureContext.ShowActors(MakeArrayView(&InActor, 1));
+}
+
+void ULivLocalPlayerSubsystem::HideActors(const TArray<AActor*>& InActors)
+{
+	CaptureContext.HideActors(InActors);
+}
+
+void ULivLocalPlayerSubsystem::ShowActors(const TArray<AActor*>& InActors)
+{
+	CaptureContext.ShowActors(InActors);
 }
 
 void ULivLocalPlayerSubsystem::ClearHiddenActors()
 {
-	CaptureContext.HiddenActors.Reset();
+	CaptureContext.ClearHiddenActors();
 }
 
 FLivCaptureContext ULivLocalPlayerSubsystem::GetCaptureContext() const
@@ -178,7 +209,7 @@ void ULivLocalPlayerSubsystem::HandleLivConnection()
 {
 	if(!bLivActive)
 	{
-		if(FLivNativeWrapper::IsActive())
+		if(IsLivBridgeActive())
 		{
 			UE_LOG(LogLivLocalPlayerSubsystem, Log, TEXT("LIV capture started."));
 
@@ -188,7 +219,7 @@ void ULivLocalPlayerSubsystem::HandleLivConnection()
 	}
 	else
 	{
-		if (!FLivNativeWrapper::IsActive())
+		if (!IsLivBridgeActive())
 		{
 			UE_LOG(LogLivLocalPlayerSubsystem, Log, TEXT("LIV capture stopped."));
 
@@ -201,8 +232,15 @@ void ULivLocalPlayerSubsystem::HandleLivConnection()
 void ULivLocalPlayerSubsystem::LivCaptureActivated()
 {
 	FLivInputFrame InputFrame;
+	FLivInputFramePoller& Poller = FLivInputFramePoller::Get();
+	uint64 Sequence = 0;
+
+	// through the poller when it runs, it calls into the bridge too
+	const bool bSuccess = Poller.IsRunning()
+		? Poller.GetInputFrameNow(InputFrame, Sequence)
+		: FLivNativeWrapper::GetInputFrame(InputFrame);
 
-	if(!FLivNativeWrapper::GetInputFrame(InputFrame))
+	if(!bSuccess)
 	{
 		UE_LOG(LogLivLocalPlayerSubsystem, Warning, TEXT("LIV capture failed as unable to obtain input frame."));
 
@@ -221,6 +259,9 @@ void ULivLocalPlayerSubsystem::LivCaptureActivated()
 	// signal that we will be sending frames
 	FLivNativeWrapper::Start();
 
+	// hand input frames over to the polling thread (if running)
+	FLivInputFramePoller::Get().SetPollInputFrames(true);
+
 	// track LIV is active
 	bLivActive = true;
 
@@ -234,6 +275,8 @@ void ULivLocalPlayerSubsystem::LivCaptureActivated()
 
 void ULivLocalPlayerSubsystem::LivCaptureDeactivated()
 {
+	FLivInputFramePoller::Get().SetPollInputFrames(false);
+
 	// if there is a world sub system (should be), destroy the resources
 	if (ULivWorldSubsystem* LivWorldSubsystem = GetLivWorldSubsystem())
 	{
@@ -0,0 +1,349 @@
+// Copyright 2021 LIV Inc. - MIT License
+#include "LivLoopbackBridge.h"
+
+#if LIV_WITH_LOOPBACK
+
+#include "LivConversions.h"
+#include "LivInputFrameTrace.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY(LogLivLoopbackBridge);
+
+static TAutoConsoleVariable<bool> CVarLivLoopbackActive(TEXT("Liv.Loopback.Active"),
+	true,
+	TEXT("Whether the loopback bridge reports an active LIV capture (simulates the LIV App connecting/disconnecting).")
+);
+
+static TAutoConsoleVariable<int32> CVarLivLoopbackWidth(TEXT("Liv.Loopback.Width"),
+	1920,
+	TEXT("Width of the input frames served by the loopback bridge.")
+);
+
+static TAutoConsoleVariable<int32> CVarLivLoopbackHeight(TEXT("Liv.Loopback.Height"),
+	1080,
+	TEXT("Height of the input frames served by the loopback bridge.")
+);
+
+static TAutoConsoleVariable<float> CVarLivLoopbackFieldOfView(TEXT("Liv.Loopback.FieldOfView"),
+	90.0f,
+	TEXT("Horizontal field of view (degrees) of the default loopback camera.")
+);
+
+static TAutoConsoleVariable<float> CVarLivLoopbackOrbitRadius(TEXT("Liv.Loopback.OrbitRadius"),
+	300.0f,
+	TEXT("Distance (cm) of the default loopback camera from the tracking origin.")
+);
+
+static TAutoConsoleVariable<float> CVarLivLoopbackOrbitSpeed(TEXT("Liv.Loopback.OrbitSpeed"),
+	0.0f,
+	TEXT("Degrees the default loopback camera orbits the tracking origin per input frame, 0 is a static camera.")
+);
+
+static constexpr int32 LoopbackRecentSubmissionsCapacity = 64;
+
+bool FLivLoopbackBridge::IsRequested()
+{
+#if LIV_WITH_INPUT_FRAME_TRACE
+	// replaying a trace implies the loopback bridge
+	static const bool bRequested = FParse::Param(FCommandLine::Get(), TEXT("LivLoopback")) || LivInputFrameTrace::IsReplayRequested();
+#else
+	static const bool bRequested = FParse::Param(FCommandLine::Get(), TEXT("LivLoopback"));
+#endif
+	return bRequested;
+}
+
+FLivLoopbackBridge& FLivLoopbackBridge::Get()
+{
+	static FLivLoopbackBridge Instance;
+	return Instance;
+}
+
+FLivLoopbackBridge::FLivLoopbackBridge()
+	: NextFrameId(1)
+	, NumSubmissions(0)
+{
+	FMemory::Memzero(CurrentInputFrame);
+	FMemory::Memzero(SourceResolution);
+	RecentSubmissions.SetNum(LoopbackRecentSubmissionsCapacity);
+}
+
+bool FLivLoopbackBridge::IsActive() const
+{
+	return CVarLivLoopbackActive.GetValueOnAnyThread();
+}
+
+void FLivLoopbackBridge::Start()
+{
+	UE_LOG(LogLivLoopbackBridge, Log, TEXT("Loopback bridge started."));
+}
+
+void FLivLoopbackBridge::ClearInputFrame(LIV_InputFrame* InputFrame) const
+{
+	check(InputFrame);
+	FMemory::Memzero(*InputFrame);
+}
+
+bool FLivLoopbackBridge::GetInputFrame(LIV_InputFrame* OutInputFrame)
+{
+	check(OutInputFrame);
+
+	FScopeLock Lock(&CriticalSection);
+
+	if (CurrentInputFrame.frameid == 0)
+	{
+		// nothing served yet, behave as if this was the first update (critical section is re-entrant)
+		UpdateInputFrame(nullptr);
+	}
+
+	*OutInputFrame = CurrentInputFrame;
+	return true;
+}
+
+const LIV_InputFrame* FLivLoopbackBridge::UpdateInputFrame(const LIV_InputFrame* InputRequest)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	const LIV_InputFrame PreviousInputFrame = CurrentInputFrame;
+	const uint64 FrameId = NextFrameId++;
+
+	LIV_InputFrame NewInputFrame;
+	FMemory::Memzero(NewInputFrame);
+
+	if (InputFrameSource)
+	{
+		InputFrameSource(FrameId, NewInputFrame);
+	}
+	else
+	{
+		MakeDefaultInputFrame(FrameId, NewInputFrame);
+	}
+
+	SourceResolution.width = NewInputFrame.pose.width;
+	SourceResolution.height = NewInputFrame.pose.height;
+
+	if (InputRequest)
+	{
+		ApplyInputRequest(*InputRequest, NewInputFrame);
+	}
+
+	NewInputFrame.frameid = FrameId;
+
+	// report what changed since the previous frame the same way the LIV App does
+	const bool bFirstFrame = PreviousInputFrame.frameid == 0;
+	const bool bPoseChanged = bFirstFrame || FMemory::Memcmp(&PreviousInputFrame.pose, &NewInputFrame.pose, sizeof(LIV_Pose)) != 0;
+	const bool bClipPlaneChanged = bFirstFrame
+		|| FMemory::Memcmp(&PreviousInputFrame.clipPlane, &NewInputFrame.clipPlane, sizeof(LIV_ClipPlane)) != 0
+		|| FMemory::Memcmp(&PreviousInputFrame.GroundPlane, &NewInputFrame.GroundPlane, sizeof(LIV_ClipPlane)) != 0;
+	const bool bStageChanged = bFirstFrame || FMemory::Memcmp(&PreviousInputFrame.StageTransform, &NewInputFrame.StageTransform, sizeof(LIV_Transform)) != 0;
+	const bool bResolutionChanged = bFirstFrame
+		|| PreviousInputFrame.pose.width != NewInputFrame.pose.width
+		|| PreviousInputFrame.pose.height != NewInputFrame.pose.height;
+
+	NewInputFrame.features &= ~static_cast<LIV_FEATURES_ENUM>(LIV_FEATURES_POSE_UPDATED | LIV_FEATURES_CLIPPLANE_UPDATED | LIV_FEATURES_STAGE_UPDATED | LIV_FEATURES_RESOLUTION_UPDATED);
+	NewInputFrame.features |= bPoseChanged ? LIV_FEATURES_POSE_UPDATED : 0;
+	NewInputFrame.features |= bClipPlaneChanged ? LIV_FEATURES_CLIPPLANE_UPDATED : 0;
+	NewInputFrame.features |= bStageChanged ? LIV_FEATURES_STAGE_UPDATED : 0;
+	NewInputFrame.features |= bResolutionChanged ? LIV_FEATURES_RESOLUTION_UPDATED : 0;
+
+	CurrentInputFrame = NewInputFrame;
+
+	return &CurrentInputFrame;
+}
+
+void FLivLoopbackBridge::AddTexture(const LIV_Texture* Texture)
+{
+	check(Texture);
+
+	FScopeLock Lock(&CriticalSection);
+	PendingTextures.Add(*Texture);
+}
+
+void FLivLoopbackBridge::Submit()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	FLivLoopbackSubmission& Submission = RecentSubmissions[NumSubmissions % LoopbackRecentSubmissionsCapacity];
+	Submission.FrameId = CurrentInputFrame.frameid;
+	Submission.SubmitTime = FPlatformTime::Seconds();
+	Submission.Textures = MoveTemp(PendingTextures);
+
+	PendingTextures.Reset();
+	++NumSubmissions;
+}
+
+bool FLivLoopbackBridge::GetResolution(LIV_Resolution* OutResolution) const
+{
+	check(OutResolution);
+
+	FScopeLock Lock(&CriticalSection);
+
+	// not the served frame's, which carries the game's request once it was made
+	if (CurrentInputFrame.frameid != 0)
+	{
+		*OutResolution = SourceResolution;
+	}
+	else
+	{
+		OutResolution->width = CVarLivLoopbackWidth.GetValueOnAnyThread();
+		OutResolution->height = CVarLivLoopbackHeight.GetValueOnAnyThread();
+	}
+
+	return true;
+}
+
+void FLivLoopbackBridge::SetInputFrameSource(FInputFrameSource InInputFrameSource)
+{
+	FScopeLock Lock(&CriticalSection);
+	InputFrameSource = MoveTemp(InInputFrameSource);
+}
+
+uint64 FLivLoopbackBridge::GetNumSubmissions() const
+{
+	FScopeLock Lock(&CriticalSection);
+	return NumSubmissions;
+}
+
+TArray<FLivLoopbackSubmission> FLivLoopbackBridge::GetRecentSubmissions() const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	const uint64 NumRecent = FMath::Min<uint64>(NumSubmissions, LoopbackRecentSubmissionsCapacity);
+
+	TArray<FLivLoopbackSubmission> Result;
+	Result.Reserve(NumRecent);
+
+	for (uint64 Idx = NumSubmissions - NumRecent; Idx < NumSubmissions; ++Idx)
+	{
+		Result.Add(RecentSubmissions[Idx % LoopbackRecentSubmissionsCapacity]);
+	}
+
+	return Result;
+}
+
+void FLivLoopbackBridge::Reset()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	FMemory::Memzero(CurrentInputFrame);
+	FMemory::Memzero(SourceResolution);
+	NextFrameId = 1;
+	PendingTextures.Reset();
+	RecentSubmissions.Reset();
+	RecentSubmissions.SetNum(LoopbackRecentSubmissionsCapacity);
+	NumSubmissions = 0;
+}
+
+FLivLoopbackBridge::FState FLivLoopbackBridge::SaveState() const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	FState State;
+	State.InputFrameSource = InputFrameSource;
+	State.CurrentInputFrame = CurrentInputFrame;
+	State.SourceResolution = SourceResolution;
+	State.NextFrameId = NextFrameId;
+	State.PendingTextures = PendingTextures;
+	State.RecentSubmissions = RecentSubmissions;
+	State.NumSubmissions = NumSubmissions;
+	return State;
+}
+
+void FLivLoopbackBridge::RestoreState(FState State)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	InputFrameSource = MoveTemp(State.InputFrameSource);
+	CurrentInputFrame = State.CurrentInputFrame;
+	SourceResolution = State.SourceResolution;
+	NextFrameId = State.NextFrameId;
+	PendingTextures = MoveTemp(State.PendingTextures);
+	RecentSubmissions = MoveTemp(State.RecentSubmissions);
+	NumSubmissions = State.NumSubmissions;
+}
+
+void FLivLoopbackBridge::MakeDefaultInputFrame(uint64 FrameId, LIV_InputFrame& OutInputFrame)
+{
+	const FIntPoint Dimensions(
+		FMath::Max(CVarLivLoopbackWidth.GetValueOnAnyThread(), 1),
+		FMath::Max(CVarLivLoopbackHeight.GetValueOnAnyThread(), 1));
+
+	const float HorizontalFOV = FMath::Clamp(CVarLivLoopbackFieldOfView.GetValueOnAnyThread(), 1.0f, 170.0f);
+	const float OrbitRadius = FMath::Max(CVarLivLoopbackOrbitRadius.GetValueOnAnyThread(), 1.0f);
+	const float OrbitAngle = FMath::DegreesToRadians(FMath::Fmod(CVarLivLoopbackOrbitSpeed.GetValueOnAnyThread() * FrameId, 360.0f));
+
+	// camera at eye height looking at the player standing on the tracking origin
+	const FVector LookAt(0.0f, 0.0f, 100.0f);
+	const FVector CameraLocation(OrbitRadius * FMath::Cos(OrbitAngle), OrbitRadius * FMath::Sin(OrbitAngle), 160.0f);
+	const FQuat CameraRotation = (LookAt - CameraLocation).ToOrientationQuat();
+
+	OutInputFrame.pose.local_position = ConvertPosition<FVector, LIV_Vector3>(CameraLocation);
+	OutInputFrame.pose.local_rotation = Convert<FQuat, LIV_Quaternion>(CameraRotation);
+	OutInputFrame.pose.verticalFieldOfView = ConvertHorizontalFOVToVerticalFOV(HorizontalFOV, Dimensions.X, Dimensions.Y);
+	OutInputFrame.pose.nearClipPlane = 0.01f;
+	OutInputFrame.pose.farClipPlane = 1000.0f;
+	OutInputFrame.pose.width = Dimensions.X;
+	OutInputFrame.pose.height = Dimensions.Y;
+	OutInputFrame.pose.projectionMatrix = CreateLivProjectionMatrix(Dimensions, HorizontalFOV, OutInputFrame.pose.nearClipPlane);
+
+	// clip plane through the player facing away from the camera, floor plane at the tracking origin facing up
+	OutInputFrame.clipPlane.transform = Convert<FMatrix, LIV_Matrix4x4>(FTransform(CameraRotation, LookAt).ToMatrixWithScale());
+	OutInputFrame.clipPlane.width = 1;
+	OutInputFrame.clipPlane.height = 1;
+
+	OutInputFrame.GroundPlane.transform = Convert<FMatrix, LIV_Matrix4x4>(FTransform(FRotator(90.0f, 0.0f, 0.0f)).ToMatrixWithScale());
+	OutInputFrame.GroundPlane.width = 1;
+	OutInputFrame.GroundPlane.height = 1;
+
+	OutInputFrame.StageTransform.trackedSpaceStageRotation = LIV_Quaternion{ { 0.0f, 0.0f, 0.0f, 1.0f } };
+	OutInputFrame.StageTransform.trackedSpaceLocalScale = LIV_Vector3{ { 1.0f, 1.0f, 1.0f } };
+
+	OutInputFrame.features = LIV_FEATURES_BOTH_RENDER | LIV_FEATURES_GROUND_CLIP_PLANE;
+}
+
+void FLivLoopbackBridge::ApplyInputRequest(const LIV_InputFrame& InputRequest, LIV_InputFrame& InOutInputFrame)
+{
+	// the LIV App has no priority of its own here, any game request wins
+
+	if (InputRequest.pose_priority > 0)
+	{
+		const int32 Width = InOutInputFrame.pose.width;
+		const int32 Height = InOutInputFrame.pose.height;
+
+		InOutInputFrame.pose = InputRequest.pose;
+		InOutInputFrame.pose.width = Width;
+		InOutInputFrame.pose.height = Height;
+	}
+
+	if (InputRequest.resolution_priority > 0 && InputRequest.pose.width > 0 && InputRequest.pose.height > 0)
+	{
+		InOutInputFrame.pose.width = InputRequest.pose.width;
+		InOutInputFrame.pose.height = InputRequest.pose.height;
+	}
+
+	if (InputRequest.clipplane_priority > 0)
+	{
+		InOutInputFrame.clipPlane = InputRequest.clipPlane;
+	}
+
+	if (InputRequest.groundplane_priority > 0)
+	{
+		InOutInputFrame.GroundPlane = InputRequest.GroundPlane;
+	}
+
+	if (InputRequest.stage_priority > 0)
+	{
+		InOutInputFrame.StageTransform = InputRequest.StageTransform;
+	}
+
+	if (InputRequest.feature_priority > 0)
+	{
+		InOutInputFrame.features = InputRequest.features;
+	}
+
+	InOutInputFrame.priority = InputRequest.priority;
+}
+
+#endif
@@ -0,0 +1,126 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LivSdk.h"
+
+#if LIV_WITH_LOOPBACK
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLivLoopbackBridge, Log, All);
+
+/**
+ * Everything handed to the loopback bridge between two calls to LIV_Submit.
+ */
+struct FLivLoopbackSubmission
+{
+	/** frameid of the most recent input frame served when this was submitted. */
+	uint64 FrameId = 0;
+
+	/** FPlatformTime::Seconds() when this was submitted. */
+	double SubmitTime = 0.0;
+
+	TArray<LIV_Texture, TInlineAllocator<4>> Textures;
+};
+
+/**
+ * In-process stand-in for the LIV App implementing the parts of LIV_CAPI.h the plugin uses.
+ * Serves scripted input frames and records submitted textures so that every capture method can
+ * run (and be measured) without the LIV App, including on platforms the LIV SDK does not ship for.
+ *
+ * Selected at module startup by passing -LivLoopback (or -LivReplay=<file>) on the command line.
+ * FLivNativeWrapper routes all bridge calls here when it is enabled.
+ */
+class FLivLoopbackBridge
+{
+public:
+
+	/**
+	 * Produces the input frame served for a given frame id.
+	 */
+	using FInputFrameSource = TFunction<void(uint64 FrameId, LIV_InputFrame& OutInputFrame)>;
+
+	/**
+	 * Returns true if the loopback bridge was requested on the command line.
+	 */
+	static bool IsRequested();
+
+	static FLivLoopbackBridge& Get();
+
+	// LIV_CAPI.h
+
+	bool IsActive() const;
+	void Start();
+	void ClearInputFrame(LIV_InputFrame* InputFrame) const;
+	bool GetInputFrame(LIV_InputFrame* OutInputFrame);
+	const LIV_InputFrame* UpdateInputFrame(const LIV_InputFrame* InputRequest);
+	void AddTexture(const LIV_Texture* Texture);
+	void Submit();
+	bool GetResolution(LIV_Resolution* OutResolution) const;
+
+	// Scripting and inspection
+
+	/**
+	 * Replace the source of served input frames, an unbound source restores the default camera (see Liv.Loopback.* cvars).
+	 */
+	void SetInputFrameSource(FInputFrameSource InInputFrameSource);
+
+	/**
+	 * Number of times LIV_Submit has been called since startup.
+	 */
+	uint64 GetNumSubmissions() const;
+
+	/**
+	 * Copy of the most recent submissions, oldest first.
+	 */
+	TArray<FLivLoopbackSubmission> GetRecentSubmissions() const;
+
+	/**
+	 * Forget all recorded submissions and restart frame ids from one.
+	 */
+	void Reset();
+
+	/**
+	 * Everything scripting can change, so a test can put the bridge back the way it found it.
+	 */
+	struct FState
+	{
+		FInputFrameSource InputFrameSource;
+		LIV_InputFrame CurrentInputFrame;
+		LIV_Resolution SourceResolution;
+		uint64 NextFrameId = 1;
+		TArray<LIV_Texture, TInlineAllocator<4>> PendingTextures;
+		TArray<FLivLoopbackSubmission> RecentSubmissions;
+		uint64 NumSubmissions = 0;
+	};
+
+	FState SaveState() const;
+	void RestoreState(FState State);
+
+private:
+
+	FLivLoopbackBridge();
+
+	/** Default scripted camera, orbiting the tracking origin with the clip plane on the point it looks at. */
+	static void MakeDefaultInputFrame(uint64 FrameId, LIV_InputFrame& OutInputFrame);
+
+	/** Apply the parts of a game request that outrank the bridge, as the LIV App would. */
+	static void ApplyInputRequest(const LIV_InputFrame& InputRequest, LIV_InputFrame& InOutInputFrame);
+
+	mutable FCriticalSection CriticalSection;
+
+	FInputFrameSource InputFrameSource;
+	LIV_InputFrame CurrentInputFrame;
+
+	/** Resolution of the current input frame before the game's request, what LIV itself wants (LIV_GetResolution). */
+	LIV_Resolution SourceResolution;
+
+	uint64 NextFrameId;
+
+	TArray<LIV_Texture, TInlineAllocator<4>> PendingTextures;
+
+	/** Ring of recent submissions, NumSubmissions % capacity is the next slot. */
+	TArray<FLivLoopbackSubmission> RecentSubmissions;
+	uint64 NumSubmissions;
+};
+
+#endif
@@ -20,9 +20,12 @@
 #endif
 
 #include "LivCaptureBase.h"
+#include "LivLatencyTracker.h"
 #include "LivLocalPlayerSubsystem.h"
 #include "LivNativeWrapper.h"
 #include "LivPluginSettings.h"
+#include "LivPrimitiveCache.h"
+#include "LivSubmitThread.h"
 
 #if WITH_EDITOR
 #include "ISettingsModule.h"
@@ -64,12 +67,28 @@ void FLivModule::StartupModule()
 	EnsureSdkIdentifier();
 
 	bLivSDKLoaded = FLivNativeWrapper::StartUp();
+
+#if LIV_WITH_LATENCY_TRACKING
+	FLivLatencyTracker::Startup();
+#endif
 	
 	StartupConsoleCommands();
 }
 
 void FLivModule::ShutdownModule()
 {
+#if LIV_WITH_LATENCY_TRACKING
+	// started whether or not the SDK loaded
+	FLivLatencyTracker::Shutdown();
+#endif
+
+#if LIV_CAPTURE_SUPPORTED
+	// nothing may call into the bridge once it is shut down, the loopback bridge runs without the SDK
+	FLivSubmitThread::Get().Shutdown();
+#endif
+
+	FLivPrimitiveCache::Shutdown();
+
 	if (!bLivSDKLoaded)
 	{
 		return;
@@ -192,17 +211,7 @@ struct FLivConsoleCommands
 
 	static TArray<TSubclassOf<ULivCaptureBase>> GetLivCaptureClasses()
 	{
-		TArray<TSubclassOf<ULivCaptureBase>> Classes;
-		// should be at least 4 non abstract capture classes
-		Classes.Reserve(4);
-		for (TObjectIterator<UClass> It; It; ++It)
-		{
-			if (!It->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated) && It->IsChildOf<ULivCaptureBase>())
-			{
-				Classes.Add(*It);
-			}
-		}
-		return Classes;
+		return ULivCaptureBase::GetCaptureClasses();
 	}
 
 	void PrintCaptureClasses()
@@ -5,8 +5,11 @@
 #include "GeneralProjectSettings.h"
 #include "IXRTrackingSystem.h"
 #include "LivConversions.h"
+#include "LivInputFrameTrace.h"
+#include "LivLoopbackBridge.h"
 #include "LivPluginSettings.h"
 #include "Components/SceneCaptureComponent2D.h"
+#include "HAL/IConsoleManager.h"
 #include "Interfaces/IPluginManager.h"
 #include "Launch/Resources/Version.h"
 #include "Engine/Engine.h"
@@ -27,15 +30,32 @@
 #include "Windows/HideWindowsPlatformTypes.h"
 #endif
 
+// there is a bridge to talk to: the LIV App or the loopback stand-in
+#if (defined(LIV_SUPPORTED) && LIV_SUPPORTED) || (defined(LIV_WITH_LOOPBACK) && LIV_WITH_LOOPBACK)
+#define LIV_HAS_BRIDGE 1
+#else
+#define LIV_HAS_BRIDGE 0
+#endif
+
 
 DEFINE_LOG_CATEGORY(LogLivNativeWrapper);
 
 static const FString RHID3D11("D3D11");
 static const FString RHIOpenGL("OpenGL");
 
+static TAutoConsoleVariable<bool> CVarLivIncrementalInputFrame(TEXT("Liv.IncrementalInputFrame"),
+	true,
+	TEXT("Only decode the parts of the LIV input frame that LIV reports as changed."),
+	ECVF_Default);
+
+// what the game asks LIV for with every input frame update, resolution is zero when LIV decides
+static FCriticalSection GLivInputRequestCriticalSection;
+static FIntPoint GLivRequestedResolution = FIntPoint::ZeroValue;
+static bool GLivRequestedBackgroundDepth = false;
+
 float FLivInputFrame::GetHorizontalFieldOfView() const
 {
-#if LIV_SUPPORTED
+#if LIV_HAS_BRIDGE
 	return ConvertVerticalFOVToHorizontalFOV(HorizontalFieldOfView, Dimensions.X, Dimensions.Y);
 #else
 	return 0.0f;
@@ -44,17 +64,166 @@ float FLivInputFrame::GetHorizontalFieldOfView() const
 
 ///////////////////////////////////////////////////////////////////////
 
+/**
+ * Dispatches the LIV_CAPI.h calls the plugin makes to either the LIV App or the loopback bridge.
+ */
+namespace LivBridge
+{
+	static bool UseLoopback()
+	{
+#if LIV_WITH_LOOPBACK
+		return FLivLoopbackBridge::IsRequested();
+#else
+		return false;
+#endif
+	}
+
+#if LIV_HAS_BRIDGE
+
+	static bool IsActive()
+	{
+#if LIV_WITH_LOOPBACK
+		if (UseLoopback())
+		{
+			return FLivLoopbackBridge::Get().IsActive();
+		}
+#endif
+#if LIV_SUPPORTED
+		return LIV_IsActive();
+#else
+		return false;
+#endif
+	}
+
+	static void Start()
+	{
+#if LIV_WITH_LOOPBACK
+		if (UseLoopback())
+		{
+			FLivLoopbackBridge::Get().Start();
+			return;
+		}
+#endif
+#if LIV_SUPPORTED
+		LIV_Start();
+#endif
+	}
+
+	static void ClearInputFrame(LIV_InputFrame* InputFrame)
+	{
+#if LIV_WITH_LOOPBACK
+		if (UseLoopback())
+		{
+			FLivLoopbackBridge::Get().ClearInputFrame(InputFrame);
+			return;
+		}
+#endif
+#if LIV_SUPPORTED
+		LIV_ClearInputFrame(InputFrame);
+#endif
+	}
+
+	static bool GetInputFrame(LIV_InputFrame* OutInputFrame)
+	{
+#if LIV_WITH_LOOPBACK
+		if (UseLoopback())
+		{
+			return FLivLoopbackBridge::Get().GetInputFrame(OutInputFrame);
+		}
+#endif
+#if LIV_SUPPORTED
+		return LIV_GetInputFrame(OutInputFrame);
+#else
+		return false;
+#endif
+	}
+
+	static const LIV_InputFrame* UpdateInputFrame(const LIV_InputFrame* InputRequest)
+	{
+#if LIV_WITH_LOOPBACK
+		if (UseLoopback())
+		{
+			return FLivLoopbackBridge::Get().UpdateInputFrame(InputRequest);
+		}
+#endif
+#if LIV_SUPPORTED
+		return LIV_UpdateInputFrame(InputRequest);
+#else
+		return nullptr;
+#endif
+	}
+
+	static void AddTexture(LIV_Texture* Texture)
+	{
+#if LIV_WITH_LOOPBACK
+		if (UseLoopback())
+		{
+			FLivLoopbackBridge::Get().AddTexture(Texture);
+			return;
+		}
+#endif
+#if LIV_SUPPORTED
+		LIV_AddTexture(Texture);
+#endif
+	}
+
+	static void Submit()
+	{
+#if LIV_WITH_LOOPBACK
+		if (UseLoopback())
+		{
+			FLivLoopbackBridge::Get().Submit();
+			return;
+		}
+#endif
+#if LIV_SUPPORTED
+		LIV_Submit();
+#endif
+	}
+
+	static bool GetResolution(LIV_Resolution* OutResolution)
+	{
+#if LIV_WITH_LOOPBACK
+		if (UseLoopback())
+		{
+			return FLivLoopbackBridge::Get().GetResolution(OutResolution);
+		}
+#endif
+#if LIV_SUPPORTED
+		return LIV_GetResolution(OutResolution);
+#else
+		return false;
+#endif
+	}
+
+#endif // LIV_HAS_BRIDGE
+}
+
+///////////////////////////////////////////////////////////////////////
+
 bool FLivNativeWrapper::IsSupported()
 {
 #if LIV_SUPPORTED
 	return true;
 #else
-	return false;
+	return LivBridge::UseLoopback();
 #endif
 }
 
 bool FLivNativeWrapper::StartUp()
 {
+#if LIV_WITH_INPUT_FRAME_TRACE
+	LivInputFrameTrace::StartFromCommandLine();
+#endif
+
+#if LIV_WITH_LOOPBACK
+	if (LivBridge::UseLoopback())
+	{
+		UE_LOG(LogLivNativeWrapper, Log, TEXT("Using LIV loopback bridge (-LivLoopback), the LIV App will not be loaded. RHI: %s"), GDynamicRHI ? GDynamicRHI->GetName() : TEXT("None"));
+		return true;
+	}
+#endif
+
 #if LIV_SUPPORTED
 
 	if(!IsSupported())
@@ -115,15 +284,22 @@ bool FLivNativeWrapper::StartUp()
 
 void FLivNativeWrapper::Shutdown()
 {
+#if LIV_WITH_INPUT_FRAME_TRACE
+	FLivInputFrameRecorder::Get().Stop();
+#endif
+
 #if LIV_SUPPORTED
-	LIV_Unload();
+	if (!LivBridge::UseLoopback())
+	{
+		LIV_Unload();
+	}
 #endif
 }
 
 bool FLivNativeWrapper::IsActive()
 {
-#if LIV_SUPPORTED
-	return LIV_IsActive();
+#if LIV_HAS_BRIDGE
+	return LivBridge::IsActive();
 #else
 	return false;
 #endif
@@ -131,14 +307,64 @@ bool FLivNativeWrapper::IsActive()
 
 void FLivNativeWrapper::Start()
 {
-#if LIV_SUPPORTED
-	LIV_Start();
+#if LIV_HAS_BRIDGE
+	LivBridge::Start();
 	SubmitApplicationInformation();
 #endif
 }
 
+void FLivNativeWrapper::AddTexture(LIV_Texture* Texture)
+{
+#if LIV_HAS_BRIDGE
+	LivBridge::AddTexture(Texture);
+#endif
+}
+
+void FLivNativeWrapper::Submit()
+{
+#if LIV_HAS_BRIDGE
+	LivBridge::Submit();
+#endif
+}
+
+void FLivNativeWrapper::SetRequestedResolution(const FIntPoint& Resolution)
+{
+	FScopeLock Lock(&GLivInputRequestCriticalSection);
+	GLivRequestedResolution = Resolution;
+}
+
+void FLivNativeWrapper::SetRequestedBackgroundDepth(bool bRequested)
+{
+	FScopeLock Lock(&GLivInputRequestCriticalSection);
+	GLivRequestedBackgroundDepth = bRequested;
+}
+
+bool FLivNativeWrapper::GetResolution(FIntPoint& OutResolution)
+{
+#if LIV_HAS_BRIDGE
+	LIV_Resolution Resolution{};
+
+	if (!LivBridge::GetResolution(&Resolution))
+	{
+		return false;
+	}
+
+	OutResolution = FIntPoint(Resolution.width, Resolution.height);
+	return true;
+#else
+	return false;
+#endif
+}
+
 FString FLivNativeWrapper::GetVersionString()
 {
+#if LIV_WITH_LOOPBACK
+	if (LivBridge::UseLoopback())
+	{
+		return FString(TEXT("Loopback"));
+	}
+#endif
+
 #if LIV_SUPPORTED
 	return FString(ANSI_TO_TCHAR(LIV_GetCSDKVersion()));
 	#else
@@ -146,30 +372,107 @@ FString FLivNativeWrapper::GetVersionString()
 #endif
 }
 
-#if LIV_SUPPORTED
+#if LIV_HAS_BRIDGE
+/**
+ * Convert the requested groups of fields from a LIV input frame.
+ */
+static void DecodeInputFrameFields(const LIV_InputFrame& LivInputFrame, FLivInputFrame& InOutInputFrame, ELivInputFrameFields Fields)
+{
+	if (EnumHasAnyFlags(Fields, ELivInputFrameFields::Pose))
+	{
+		InOutInputFrame.CameraLocation = ConvertPosition<LIV_Vector3, FVector>(LivInputFrame.pose.local_position);
+		InOutInputFrame.CameraRotation = Convert<LIV_Quaternion, FQuat>(LivInputFrame.pose.local_rotation);
+	}
+
+	if (EnumHasAnyFlags(Fields, ELivInputFrameFields::Resolution))
+	{
+		InOutInputFrame.Dimensions = FIntPoint(LivInputFrame.pose.width, LivInputFrame.pose.height);
+	}
+
+	// field of view depends on both the pose and the aspect ratio
+	if (EnumHasAnyFlags(Fields, ELivInputFrameFields::Pose | ELivInputFrameFields::Resolution))
+	{
+		InOutInputFrame.HorizontalFieldOfView = ConvertVerticalFOVToHorizontalFOV(LivInputFrame.pose.verticalFieldOfView, LivInputFrame.pose.width, LivInputFrame.pose.height);
+	}
+
+	if (EnumHasAnyFlags(Fields, ELivInputFrameFields::ClipPlanes))
+	{
+		InOutInputFrame.CameraClipPlaneMatrix = Convert<LIV_Matrix4x4, FMatrix>(LivInputFrame.clipPlane.transform);
+		InOutInputFrame.FloorClipPlaneMatrix = Convert<LIV_Matrix4x4, FMatrix>(LivInputFrame.GroundPlane.transform);
+	}
+
+	InOutInputFrame.bFloorClipPlaneEnabled = LivInputFrame.features & LIV_FEATURES::LIV_FEATURES_GROUND_CLIP_PLANE;
+
+	// bridges that don't report layers want both
+	const bool bReportsLayers = (LivInputFrame.features & LIV_FEATURES::LIV_FEATURES_BOTH_RENDER) != 0;
+	InOutInputFrame.bBackgroundEnabled = !bReportsLayers || (LivInputFrame.features & LIV_FEATURES::LIV_FEATURES_BACKGROUND_RENDER);
+	InOutInputFrame.bForegroundEnabled = !bReportsLayers || (LivInputFrame.features & LIV_FEATURES::LIV_FEATURES_FOREGROUND_RENDER);
+	InOutInputFrame.bBackgroundDepthEnabled = (LivInputFrame.features & LIV_FEATURES::LIV_FEATURES_BACKGROUND_DEPTH_RENDER) != 0;
+	InOutInputFrame.Features = LivInputFrame.features;
+
+	InOutInputFrame.DirtyFields = Fields;
+	InOutInputFrame.bDecoded = true;
+	InOutInputFrame.Timestamp = FPlatformTime::Seconds();
+	InOutInputFrame.FrameId = LivInputFrame.frameid;
+}
+
+/**
+ * Map the *_UPDATED feature bits of a LIV input frame to the fields that need decoding.
+ */
+static ELivInputFrameFields GetUpdatedInputFrameFields(const LIV_InputFrame& LivInputFrame, const FLivInputFrame& PreviousInputFrame)
+{
+	ELivInputFrameFields Fields = ELivInputFrameFields::None;
+
+	if (LivInputFrame.features & LIV_FEATURES::LIV_FEATURES_POSE_UPDATED)
+	{
+		Fields |= ELivInputFrameFields::Pose;
+	}
+
+	// the clip plane transforms are relative to the stage
+	if (LivInputFrame.features & (LIV_FEATURES::LIV_FEATURES_CLIPPLANE_UPDATED | LIV_FEATURES::LIV_FEATURES_STAGE_UPDATED))
+	{
+		Fields |= ELivInputFrameFields::ClipPlanes;
+	}
+
+	if (PreviousInputFrame.bFloorClipPlaneEnabled != static_cast<bool>(LivInputFrame.features & LIV_FEATURES::LIV_FEATURES_GROUND_CLIP_PLANE))
+	{
+		Fields |= ELivInputFrameFields::ClipPlanes;
+	}
+
+	if (LivInputFrame.features & LIV_FEATURES::LIV_FEATURES_RESOLUTION_UPDATED)
+	{
+		Fields |= ELivInputFrameFields::Resolution;
+	}
+
+	return Fields;
+}
+
 bool FLivNativeWrapper::GetInputFrame(FLivInputFrame& OutInputFrame)
 {
 	LIV_InputFrame LivInputFrame;
 
 	// try to get input frame, else tear down
-	if (!LIV_GetInputFrame(&LivInputFrame))
+	if (!LivBridge::GetInputFrame(&LivInputFrame))
 	{
 		UE_LOG(LogLivNativeWrapper, Warning, TEXT("LIV capture failed as unable to obtain input frame."));
 		return false;
 	}
 	
-	OutInputFrame.CameraLocation = ConvertPosition<LIV_Vector3, FVector>(LivInputFrame.pose.local_position);
-	OutInputFrame.CameraRotation = Convert<LIV_Quaternion, FQuat>(LivInputFrame.pose.local_rotation);
+	DecodeInputFrameFields(LivInputFrame, OutInputFrame, ELivInputFrameFields::All);
 
-	OutInputFrame.Dimensions = FIntPoint(LivInputFrame.pose.width, LivInputFrame.pose.height);
-	OutInputFrame.HorizontalFieldOfView = ConvertVerticalFOVToHorizontalFOV(LivInputFrame.pose.verticalFieldOfView, LivInputFrame.pose.width, LivInputFrame.pose.height);
+	return true;
+}
 
-	OutInputFrame.CameraClipPlaneMatrix = Convert<LIV_Matrix4x4, FMatrix>(LivInputFrame.clipPlane.transform);
-	OutInputFrame.FloorClipPlaneMatrix = Convert<LIV_Matrix4x4, FMatrix>(LivInputFrame.GroundPlane.transform);
+void FLivNativeWrapper::DecodeInputFrame(const LIV_InputFrame& LivInputFrame, FLivInputFrame& InOutInputFrame, ELivInputFrameFields ForcedFields)
+{
+	ELivInputFrameFields Fields = ELivInputFrameFields::All;
 
-	OutInputFrame.bFloorClipPlaneEnabled = LivInputFrame.features & LIV_FEATURES::LIV_FEATURES_GROUND_CLIP_PLANE;
+	if (InOutInputFrame.bDecoded && CVarLivIncrementalInputFrame.GetValueOnAnyThread())
+	{
+		Fields = GetUpdatedInputFrameFields(LivInputFrame, InOutInputFrame) | ForcedFields;
+	}
 
-	return true;
+	DecodeInputFrameFields(LivInputFrame, InOutInputFrame, Fields);
 }
 #else
 bool FLivNativeWrapper::GetInputFrame(FLivInputFrame& OutInputFrame)
@@ -179,11 +482,32 @@ bool FLivNativeWrapper::GetInputFrame(FLivInputFrame& OutInputFrame)
 #endif
 
 
-#if LIV_SUPPORTED
+FLivInputFramePoseRequest::FLivInputFramePoseRequest(const USceneCaptureComponent2D* SceneCaptureComponent)
+	: Location(SceneCaptureComponent->GetRelativeLocation())
+	, Rotation(SceneCaptureComponent->GetRelativeRotation().Quaternion())
+	, HorizontalFieldOfView(SceneCaptureComponent->FOVAngle)
+	, NearClipPlane(SceneCaptureComponent->bOverride_CustomNearClippingPlane ? SceneCaptureComponent->CustomNearClippingPlane : GNearClippingPlane)
+{
+}
+
 bool FLivNativeWrapper::UpdateInputFrame(
 	FLivInputFrame& InOutInputFrame,
 	USceneCaptureComponent2D* OverridingSceneCaptureComponent)
 {
+	if (OverridingSceneCaptureComponent)
+	{
+		const FLivInputFramePoseRequest PoseRequest(OverridingSceneCaptureComponent);
+		return UpdateInputFrame(InOutInputFrame, &PoseRequest);
+	}
+
+	return UpdateInputFrame(InOutInputFrame, static_cast<const FLivInputFramePoseRequest*>(nullptr));
+}
+
+#if LIV_HAS_BRIDGE
+bool FLivNativeWrapper::UpdateInputFrame(
+	FLivInputFrame& InOutInputFrame,
+	const FLivInputFramePoseRequest* PoseRequest)
+{
 
 #if UE_BUILD_DEBUG
 	check(InOutInputFrame.Dimensions.X > 0);
@@ -191,36 +515,68 @@ bool FLivNativeWrapper::UpdateInputFrame(
 #endif
 
 	LIV_InputFrame LivInputFrame;
-	LIV_ClearInputFrame(&LivInputFrame);
+	LivBridge::ClearInputFrame(&LivInputFrame);
 
-	// if the component is provided then we want to override
-	if(OverridingSceneCaptureComponent)
+	// if a pose is provided then we want to override
+	if(PoseRequest)
 	{
 		LivInputFrame.pose_priority = LIV_GAME_PRIORITY;
-		LivInputFrame.pose.local_position = ConvertPosition<FVector, LIV_Vector3>(OverridingSceneCaptureComponent->GetRelativeLocation());
-		LivInputFrame.pose.local_rotation = Convert<FQuat, LIV_Quaternion>(OverridingSceneCaptureComponent->GetRelativeRotation().Quaternion());
+		LivInputFrame.pose.local_position = ConvertPosition<FVector, LIV_Vector3>(PoseRequest->Location);
+		LivInputFrame.pose.local_rotation = Convert<FQuat, LIV_Quaternion>(PoseRequest->Rotation);
 		LivInputFrame.pose.verticalFieldOfView = ConvertHorizontalFOVToVerticalFOV(
-			OverridingSceneCaptureComponent->FOVAngle,
+			PoseRequest->HorizontalFieldOfView,
 			InOutInputFrame.Dimensions.X,
 			InOutInputFrame.Dimensions.Y);
 
-		const float NearClippingPlane = (OverridingSceneCaptureComponent->bOverride_CustomNearClippingPlane) ? OverridingSceneCaptureComponent->CustomNearClippingPlane : GNearClippingPlane;
-		LivInputFrame.pose.projectionMatrix = CreateLivProjectionMatrix(InOutInputFrame.Dimensions, OverridingSceneCaptureComponent->FOVAngle, NearClippingPlane);
+		LivInputFrame.pose.projectionMatrix = CreateLivProjectionMatrix(InOutInputFrame.Dimensions, PoseRequest->HorizontalFieldOfView, PoseRequest->NearClipPlane);
 	}
 
-	const LIV_InputFrame* NewLivInputFrame = LIV_UpdateInputFrame(&LivInputFrame);
+	FIntPoint RequestedResolution;
+	bool bRequestedBackgroundDepth;
+	{
+		FScopeLock Lock(&GLivInputRequestCriticalSection);
+		RequestedResolution = GLivRequestedResolution;
+		bRequestedBackgroundDepth = GLivRequestedBackgroundDepth;
+	}
+
+	if (RequestedResolution.X > 0 && RequestedResolution.Y > 0)
+	{
+		LivInputFrame.resolution_priority = LIV_GAME_PRIORITY;
+		LivInputFrame.pose.width = RequestedResolution.X;
+		LivInputFrame.pose.height = RequestedResolution.Y;
+	}
+	else
+	{
+		RequestedResolution = FIntPoint::ZeroValue;
+	}
+
+	// the request replaces all feature bits, so keep the ones LIV sent last
+	if (bRequestedBackgroundDepth && InOutInputFrame.bDecoded)
+	{
+		constexpr LIV_FEATURES_ENUM UpdateFeatures = LIV_FEATURES_UPDATE_ALL
+			| LIV_FEATURES_POSE_UPDATED | LIV_FEATURES_CLIPPLANE_UPDATED | LIV_FEATURES_STAGE_UPDATED | LIV_FEATURES_RESOLUTION_UPDATED;
+
+		LivInputFrame.feature_priority = LIV_GAME_PRIORITY;
+		LivInputFrame.features = (InOutInputFrame.Features & ~UpdateFeatures) | LIV_FEATURES_BACKGROUND_DEPTH_RENDER;
+	}
+
+	const LIV_InputFrame* NewLivInputFrame = LivBridge::UpdateInputFrame(&LivInputFrame);
 
 	if(NewLivInputFrame == nullptr)
 	{
 		return false;
 	}
 
+#if LIV_WITH_INPUT_FRAME_TRACE
+	FLivInputFrameRecorder::Get().Record(*NewLivInputFrame);
+#endif
+
 #if UE_BUILD_DEBUG
 
 	// In debug if we requested our camera pose and LIV acquiesced
 	// Then check the data returned is the same (within a tolerance)
 
-	if ((OverridingSceneCaptureComponent != nullptr) && LivInputFrame.pose_priority == LIV_GAME_PRIORITY)
+	if ((PoseRequest != nullptr) && LivInputFrame.pose_priority == LIV_GAME_PRIORITY)
 	{
 		for (int32 Idx{ 0 }; Idx < 16; ++Idx)
 		{
@@ -242,23 +598,16 @@ bool FLivNativeWrapper::UpdateInputFrame(
 
 #endif
 
-	InOutInputFrame.CameraLocation = ConvertPosition<LIV_Vector3, FVector>(NewLivInputFrame->pose.local_position);
-	InOutInputFrame.CameraRotation = Convert<LIV_Quaternion, FQuat>(NewLivInputFrame->pose.local_rotation);
-
-	InOutInputFrame.Dimensions = FIntPoint(NewLivInputFrame->pose.width, NewLivInputFrame->pose.height);
-	InOutInputFrame.HorizontalFieldOfView = ConvertVerticalFOVToHorizontalFOV(NewLivInputFrame->pose.verticalFieldOfView, NewLivInputFrame->pose.width, NewLivInputFrame->pose.height);
-
-	InOutInputFrame.CameraClipPlaneMatrix = Convert<LIV_Matrix4x4, FMatrix>(NewLivInputFrame->clipPlane.transform);
-	InOutInputFrame.FloorClipPlaneMatrix = Convert<LIV_Matrix4x4, FMatrix>(NewLivInputFrame->GroundPlane.transform);
-
-	InOutInputFrame.bFloorClipPlaneEnabled = NewLivInputFrame->features & LIV_FEATURES::LIV_FEATURES_GROUND_CLIP_PLANE;
+	// our own pose request is applied every frame
+	DecodeInputFrame(*NewLivInputFrame, InOutInputFrame, PoseRequest ? ELivInputFrameFields::Pose : ELivInputFrameFields::None);
+	InOutInputFrame.RequestedResolution = RequestedResolution;
 
 	return true;
 }
 #else
 bool FLivNativeWrapper::UpdateInputFrame(
 	FLivInputFrame& InOutInputFrame,
-	USceneCaptureComponent2D* OverridingSceneCaptureComponent)
+	const FLivInputFramePoseRequest* PoseRequest)
 {
 	return false;
 }
@@ -267,6 +616,10 @@ bool FLivNativeWrapper::UpdateInputFrame(
 void FLivNativeWrapper::SubmitApplicationInformation()
 {
 #if LIV_SUPPORTED
+	if (LivBridge::UseLoopback())
+	{
+		return;
+	}
 
 	const auto LivPlugin = IPluginManager::Get().FindPlugin(TEXT("Liv"));
 
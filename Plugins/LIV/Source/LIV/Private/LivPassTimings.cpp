@@ -0,0 +1,162 @@
+// Copyright 2021 LIV Inc. - MIT License
+#include "LivPassTimings.h"
+
+#if LIV_CAPTURE_SUPPORTED
+
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "RenderGraphUtils.h"
+
+DEFINE_GPU_STAT(LivPasses);
+
+CSV_DEFINE_CATEGORY(LivPasses, true);
+
+// give up on intervals the GPU is this far behind on
+static constexpr int32 LivPassTimingsMaxIntervals = 32;
+
+static TGlobalResource<FLivPassTimings> GLivPassTimings;
+
+FLivPassTimings& FLivPassTimings::Get()
+{
+	return GLivPassTimings;
+}
+
+void FLivPassTimings::InitDynamicRHI()
+{
+	if (GSupportsTimestampRenderQueries)
+	{
+		QueryPool = RHICreateRenderQueryPool(RQT_AbsoluteTime);
+	}
+}
+
+void FLivPassTimings::ReleaseDynamicRHI()
+{
+	// queries go back to the pool before it is released
+	Intervals.Empty();
+	CurrentInterval = nullptr;
+	QueryPool.SafeRelease();
+}
+
+void FLivPassTimings::AddBeginPass(FRDGBuilder& GraphBuilder)
+{
+	check(IsInRenderingThread());
+
+	Resolve_RenderThread();
+
+	if (Intervals.Num() >= LivPassTimingsMaxIntervals)
+	{
+		Intervals.RemoveAt(0);
+		bAccumulating = false;
+	}
+
+	TUniquePtr<FInterval>& Interval = Intervals.Add_GetRef(MakeUnique<FInterval>());
+	Interval->FrameNumber = GFrameNumberRenderThread;
+
+	if (QueryPool.IsValid())
+	{
+		Interval->BeginQuery = QueryPool->AllocateQuery();
+		Interval->EndQuery = QueryPool->AllocateQuery();
+	}
+
+	CurrentInterval = Interval.Get();
+
+	GraphBuilder.AddPass(
+		RDG_EVENT_NAME("Liv Pass Timings Begin"),
+		GraphBuilder.AllocParameters<FEmptyShaderParameters>(),
+		ERDGPassFlags::Copy | ERDGPassFlags::NeverCull,
+		[Interval = CurrentInterval](FRHICommandList& RHICmdList)
+		{
+			Interval->BeginTime = FPlatformTime::Seconds();
+
+			if (Interval->BeginQuery.GetQuery())
+			{
+				RHICmdList.EndRenderQuery(Interval->BeginQuery.GetQuery());
+			}
+		});
+}
+
+void FLivPassTimings::AddEndPass(FRDGBuilder& GraphBuilder)
+{
+	check(IsInRenderingThread());
+
+	if (!CurrentInterval)
+	{
+		return;
+	}
+
+	GraphBuilder.AddPass(
+		RDG_EVENT_NAME("Liv Pass Timings End"),
+		GraphBuilder.AllocParameters<FEmptyShaderParameters>(),
+		ERDGPassFlags::Copy | ERDGPassFlags::NeverCull,
+		[Interval = CurrentInterval](FRHICommandList& RHICmdList)
+		{
+			if (Interval->EndQuery.GetQuery())
+			{
+				RHICmdList.EndRenderQuery(Interval->EndQuery.GetQuery());
+			}
+
+			Interval->EndTime = FPlatformTime::Seconds();
+			Interval->bEnded = true;
+		});
+
+	CurrentInterval = nullptr;
+}
+
+bool FLivPassTimings::GetLatestFrame(float& OutRenderThreadMs, float& OutGPUMs) const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	OutRenderThreadMs = LatestRenderThreadMs;
+	OutGPUMs = LatestGPUMs;
+
+	return bHasLatestFrame;
+}
+
+void FLivPassTimings::Resolve_RenderThread()
+{
+	while (Intervals.Num() > 0 && Intervals[0].Get() != CurrentInterval && Intervals[0]->bEnded)
+	{
+		FInterval& Interval = *Intervals[0];
+
+		uint64 BeginMicroseconds = 0;
+		uint64 EndMicroseconds = 0;
+
+		if (Interval.BeginQuery.GetQuery()
+			&& (!RHIGetRenderQueryResult(Interval.BeginQuery.GetQuery(), BeginMicroseconds, false)
+				|| !RHIGetRenderQueryResult(Interval.EndQuery.GetQuery(), EndMicroseconds, false)))
+		{
+			// not on the GPU yet, neither is anything after it
+			break;
+		}
+
+		// the first interval of a newer frame completes the frame before it
+		if (bAccumulating && Interval.FrameNumber != AccumulatedFrameNumber)
+		{
+			{
+				FScopeLock Lock(&CriticalSection);
+				LatestRenderThreadMs = AccumulatedRenderThreadMs;
+				LatestGPUMs = AccumulatedGPUMs;
+				bHasLatestFrame = true;
+			}
+
+			CSV_CUSTOM_STAT(LivPasses, RenderThreadMs, AccumulatedRenderThreadMs, ECsvCustomStatOp::Set);
+			CSV_CUSTOM_STAT(LivPasses, GPUMs, AccumulatedGPUMs, ECsvCustomStatOp::Set);
+
+			bAccumulating = false;
+		}
+
+		if (!bAccumulating)
+		{
+			AccumulatedFrameNumber = Interval.FrameNumber;
+			AccumulatedRenderThreadMs = 0.0f;
+			AccumulatedGPUMs = 0.0f;
+			bAccumulating = true;
+		}
+
+		AccumulatedRenderThreadMs += static_cast<float>((Interval.EndTime - Interval.BeginTime) * 1000.0);
+		AccumulatedGPUMs += EndMicroseconds > BeginMicroseconds ? (EndMicroseconds - BeginMicroseconds) / 1000.0f : 0.0f;
+
+		Intervals.RemoveAt(0);
+	}
+}
+
+#endif
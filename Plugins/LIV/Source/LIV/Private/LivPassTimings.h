@@ -0,0 +1,107 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LivSdk.h"
+
+#if LIV_CAPTURE_SUPPORTED
+
+#include "ProfilingDebugging/RealtimeGPUProfiler.h"
+#include "RenderGraphBuilder.h"
+#include "RenderResource.h"
+
+// "stat GPU" and the GPU CSV category (r.GPUCsvStatsEnabled 1)
+DECLARE_GPU_STAT_NAMED_EXTERN(LivPasses, TEXT("LIV Passes"));
+
+/**
+ * Render thread and GPU time spent in LIV's own passes, summed per frame, so benchmarks (see LivPerfTests.cpp)
+ * can tell them apart from the rest of the game. Each timed group of passes is bracketed by two passes that
+ * record the render thread time they execute at and write a GPU timestamp query, read back once resolved.
+ *
+ * Use LIV_PASS_TIMINGS_SCOPE around the passes a capture adds to a graph.
+ */
+class FLivPassTimings : public FRenderResource
+{
+public:
+
+	static FLivPassTimings& Get();
+
+	/**
+	 * Render thread. Start timing the passes added to the graph until the matching AddEndPass.
+	 */
+	void AddBeginPass(FRDGBuilder& GraphBuilder);
+
+	/**
+	 * Render thread. Stop timing, the interval is resolved once the GPU has written its queries.
+	 */
+	void AddEndPass(FRDGBuilder& GraphBuilder);
+
+	/**
+	 * Time spent in LIV passes during the most recent frame whose queries have resolved, GPU time is zero
+	 * without timestamp query support. Any thread.
+	 */
+	bool GetLatestFrame(float& OutRenderThreadMs, float& OutGPUMs) const;
+
+	virtual void InitDynamicRHI() override;
+	virtual void ReleaseDynamicRHI() override;
+
+private:
+
+	struct FInterval
+	{
+		uint32 FrameNumber = 0;
+		double BeginTime = 0.0;
+		double EndTime = 0.0;
+		bool bEnded = false;
+		FRHIPooledRenderQuery BeginQuery;
+		FRHIPooledRenderQuery EndQuery;
+	};
+
+	/** Fold finished intervals into their frame, oldest first, and publish frames once all their intervals are in. */
+	void Resolve_RenderThread();
+
+	FRenderQueryPoolRHIRef QueryPool;
+
+	// render thread
+	TArray<TUniquePtr<FInterval>> Intervals;
+	FInterval* CurrentInterval = nullptr;
+	uint32 AccumulatedFrameNumber = 0;
+	float AccumulatedRenderThreadMs = 0.0f;
+	float AccumulatedGPUMs = 0.0f;
+	bool bAccumulating = false;
+
+	mutable FCriticalSection CriticalSection;
+	float LatestRenderThreadMs = 0.0f;
+	float LatestGPUMs = 0.0f;
+	bool bHasLatestFrame = false;
+};
+
+/**
+ * Brackets the passes added to a graph in its scope with FLivPassTimings.
+ */
+class FLivPassTimingsScope
+{
+public:
+
+	explicit FLivPassTimingsScope(FRDGBuilder& InGraphBuilder)
+		: GraphBuilder(InGraphBuilder)
+	{
+		FLivPassTimings::Get().AddBeginPass(GraphBuilder);
+	}
+
+	~FLivPassTimingsScope()
+	{
+		FLivPassTimings::Get().AddEndPass(GraphBuilder);
+	}
+
+private:
+
+	FRDGBuilder& GraphBuilder;
+};
+
+/** Time the LIV passes added to GraphBuilder in the enclosing scope, must be declared before they are added. */
+#define LIV_PASS_TIMINGS_SCOPE(GraphBuilder) \
+	RDG_GPU_STAT_SCOPE(GraphBuilder, LivPasses); \
+	FLivPassTimingsScope PREPROCESSOR_JOIN(LivPassTimingsScope, __LINE__)(GraphBuilder)
+
+#endif
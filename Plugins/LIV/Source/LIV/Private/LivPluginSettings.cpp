@@ -15,8 +15,25 @@
 ULivPluginSettings::ULivPluginSettings()
 	: CaptureMethod(ULivCaptureSingle::StaticClass())
 	, bBackgroundOnly(false)
+	, bCompositorSegmentation(false)
 	, bTransparency(false)
 	, PreExposure(1.0f)
+	, CaptureRate(0.0f)
+	, bDynamicResolution(false)
+	, DynamicResolutionFrameBudget(11.1f)
+	, DynamicResolutionMinScale(2.0f / 3.0f)
+	, bPollInputFramesOnThread(false)
+	, InputFramePollRate(120.0f)
+	, bLateLatchCameraPose(false)
+	, bPredictCameraPose(false)
+	, CameraPosePredictionTime(22.0f)
+	, bReusePreviousCaptureLighting(true)
+	, bReuseBackground(false)
+	, BackgroundMaxAge(1.0f)
+	, bLimitForegroundToPlayer(false)
+	, ForegroundRegionPadding(32)
+	, bCullForegroundPrimitives(false)
+	, bSkipEmptyForeground(false)
 	, bUseDebugCamera(false)
 	, DebugCameraHorizontalFOV(90.0f)
 	, bUseDebugCameraClipPlane(false)
@@ -0,0 +1,91 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#include "LivPosePredictor.h"
+
+static constexpr uint32 LivPosePredictorCapacity = 32;
+
+FLivPosePredictor::FLivPosePredictor()
+	: HistoryWindow(0.1)
+	, MaxPredictionTime(0.1)
+	, Samples(LivPosePredictorCapacity)
+	, NewestIndex(0)
+	, NumSamples(0)
+{
+}
+
+void FLivPosePredictor::AddSample(double Timestamp, const FVector& Location, const FQuat& Rotation)
+{
+	if (NumSamples > 0 && Timestamp < GetSample(0).Timestamp)
+	{
+		// out of order, start again rather than extrapolate backwards
+		Reset();
+	}
+
+	NewestIndex = Samples.GetNextIndex(NewestIndex);
+	Samples[NewestIndex] = FSample{ Timestamp, Location, Rotation };
+	NumSamples = FMath::Min<int32>(NumSamples + 1, Samples.Capacity());
+}
+
+void FLivPosePredictor::RepeatNewestSample(double Timestamp)
+{
+	if (NumSamples > 0)
+	{
+		const FSample Newest = GetSample(0);
+		AddSample(Timestamp, Newest.Location, Newest.Rotation);
+	}
+}
+
+bool FLivPosePredictor::Predict(double TargetTime, FVector& OutLocation, FQuat& OutRotation) const
+{
+	if (NumSamples == 0)
+	{
+		return false;
+	}
+
+	const FSample& Newest = GetSample(0);
+
+	OutLocation = Newest.Location;
+	OutRotation = Newest.Rotation;
+
+	// oldest sample still inside the history window
+	int32 OldestAge = 0;
+	while (OldestAge + 1 < NumSamples && Newest.Timestamp - GetSample(OldestAge + 1).Timestamp <= HistoryWindow)
+	{
+		++OldestAge;
+	}
+
+	const FSample& Oldest = GetSample(OldestAge);
+	const double SampleDeltaTime = Newest.Timestamp - Oldest.Timestamp;
+	const double PredictionTime = FMath::Clamp(TargetTime - Newest.Timestamp, 0.0, MaxPredictionTime);
+
+	if (OldestAge == 0 || SampleDeltaTime <= SMALL_NUMBER || PredictionTime <= 0.0)
+	{
+		return true;
+	}
+
+	const float Scale = static_cast<float>(PredictionTime / SampleDeltaTime);
+
+	// constant velocity
+	OutLocation = Newest.Location + (Newest.Location - Oldest.Location) * Scale;
+
+	// constant angular velocity, shortest arc
+	FQuat DeltaRotation = Newest.Rotation * Oldest.Rotation.Inverse();
+	if (DeltaRotation.W < 0.0f)
+	{
+		DeltaRotation = DeltaRotation * -1.0f;
+	}
+
+	FVector Axis;
+	float Angle;
+	DeltaRotation.ToAxisAndAngle(Axis, Angle);
+
+	OutRotation = FQuat(Axis, Angle * Scale) * Newest.Rotation;
+	OutRotation.Normalize();
+
+	return true;
+}
+
+void FLivPosePredictor::Reset()
+{
+	NumSamples = 0;
+}
@@ -0,0 +1,209 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#include "LivPrimitiveCache.h"
+
+#include "Components/ModelComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SceneCaptureComponent2D.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarLivPrimitiveCacheRefreshInterval(TEXT("Liv.PrimitiveCache.RefreshInterval"),
+	10.0f,
+	TEXT("Seconds after which the world's primitives are gathered again regardless, catches primitives without collision registered on existing actors and mobility changes. Zero (or less) only gathers on changes."),
+	ECVF_Default);
+
+static TMap<TObjectKey<UWorld>, TUniquePtr<FLivPrimitiveCache>> GLivPrimitiveCaches;
+static FDelegateHandle GLivPrimitiveCacheWorldCleanupHandle;
+
+FLivPrimitiveCache::FHiddenPrimitives::FHiddenPrimitives(const USceneCaptureComponent2D* SceneCaptureComponent)
+{
+	Actors.Reserve(SceneCaptureComponent->HiddenActors.Num());
+
+	for (const AActor* HiddenActor : SceneCaptureComponent->HiddenActors)
+	{
+		Actors.Add(HiddenActor);
+	}
+
+	Components.Reserve(SceneCaptureComponent->HiddenComponents.Num());
+
+	for (const TWeakObjectPtr<UPrimitiveComponent>& HiddenComponent : SceneCaptureComponent->HiddenComponents)
+	{
+		Components.Add(HiddenComponent.Get());
+	}
+}
+
+bool FLivPrimitiveCache::FHiddenPrimitives::IsHidden(const UPrimitiveComponent* PrimitiveComponent) const
+{
+	if (!PrimitiveComponent
+		|| !PrimitiveComponent->IsRegistered()
+		|| !PrimitiveComponent->IsVisible()
+		|| Components.Contains(PrimitiveComponent))
+	{
+		return true;
+	}
+
+	// level BSP has no owner
+	const AActor* Actor = PrimitiveComponent->GetOwner();
+	return Actor && (Actor->IsHidden() || Actors.Contains(Actor));
+}
+
+FLivPrimitiveCache& FLivPrimitiveCache::Get(UWorld* World)
+{
+	check(IsInGameThread());
+	check(World);
+
+	if (!GLivPrimitiveCacheWorldCleanupHandle.IsValid())
+	{
+		GLivPrimitiveCacheWorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&FLivPrimitiveCache::OnWorldCleanup);
+	}
+
+	TUniquePtr<FLivPrimitiveCache>& Cache = GLivPrimitiveCaches.FindOrAdd(World);
+
+	if (!Cache)
+	{
+		Cache = TUniquePtr<FLivPrimitiveCache>(new FLivPrimitiveCache(World));
+	}
+
+	return *Cache;
+}
+
+void FLivPrimitiveCache::Shutdown()
+{
+	GLivPrimitiveCaches.Empty();
+
+	FWorldDelegates::OnWorldCleanup.Remove(GLivPrimitiveCacheWorldCleanupHandle);
+	GLivPrimitiveCacheWorldCleanupHandle.Reset();
+}
+
+void FLivPrimitiveCache::OnWorldCleanup(UWorld* InWorld, bool bSessionEnded, bool bCleanupResources)
+{
+	GLivPrimitiveCaches.Remove(InWorld);
+}
+
+FLivPrimitiveCache::FLivPrimitiveCache(UWorld* InWorld)
+	: World(InWorld)
+	, bDirty(true)
+	, LastGatherTime(0.0)
+{
+	ActorSpawnedHandle = InWorld->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateRaw(this, &FLivPrimitiveCache::OnActorSpawned));
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FLivPrimitiveCache::OnLevelChanged);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FLivPrimitiveCache::OnLevelChanged);
+	CreatePhysicsStateHandle = UActorComponent::GlobalCreatePhysicsDelegate.AddRaw(this, &FLivPrimitiveCache::OnComponentCreatePhysicsState);
+}
+
+FLivPrimitiveCache::~FLivPrimitiveCache()
+{
+	if (UWorld* BoundWorld = World.Get())
+	{
+		BoundWorld->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	UActorComponent::GlobalCreatePhysicsDelegate.Remove(CreatePhysicsStateHandle);
+}
+
+const TArray<TWeakObjectPtr<UPrimitiveComponent>>& FLivPrimitiveCache::GetPrimitives()
+{
+	UpdateIfNeeded();
+	return Primitives;
+}
+
+const TArray<TWeakObjectPtr<UPrimitiveComponent>>& FLivPrimitiveCache::GetMovablePrimitives()
+{
+	UpdateIfNeeded();
+	return MovablePrimitives;
+}
+
+void FLivPrimitiveCache::UpdateIfNeeded()
+{
+	const double Time = FPlatformTime::Seconds();
+	const float RefreshInterval = CVarLivPrimitiveCacheRefreshInterval.GetValueOnGameThread();
+
+	if (bDirty || (RefreshInterval > 0.0f && Time - LastGatherTime >= RefreshInterval))
+	{
+		Gather();
+		LastGatherTime = Time;
+	}
+}
+
+void FLivPrimitiveCache::Gather()
+{
+	bDirty = false;
+	Primitives.Reset();
+	MovablePrimitives.Reset();
+	GatheredPrimitives.Reset();
+
+	UWorld* BoundWorld = World.Get();
+
+	if (!BoundWorld)
+	{
+		return;
+	}
+
+	for (TActorIterator<AActor> ActorIt(BoundWorld); ActorIt; ++ActorIt)
+	{
+		for (UActorComponent* Component : ActorIt->GetComponents())
+		{
+			if (UPrimitiveComponent* PrimitiveComponent = Cast<UPrimitiveComponent>(Component))
+			{
+				AddPrimitive(PrimitiveComponent);
+			}
+		}
+	}
+
+	// BSP belongs to the level, not an actor
+	for (const ULevel* Level : BoundWorld->GetLevels())
+	{
+		if (!Level)
+		{
+			continue;
+		}
+
+		for (UModelComponent* ModelComponent : Level->ModelComponents)
+		{
+			if (ModelComponent)
+			{
+				AddPrimitive(ModelComponent);
+			}
+		}
+	}
+}
+
+void FLivPrimitiveCache::AddPrimitive(UPrimitiveComponent* PrimitiveComponent)
+{
+	Primitives.Add(PrimitiveComponent);
+	GatheredPrimitives.Add(PrimitiveComponent);
+
+	if (PrimitiveComponent->Mobility == EComponentMobility::Movable)
+	{
+		MovablePrimitives.Add(PrimitiveComponent);
+	}
+}
+
+void FLivPrimitiveCache::OnActorSpawned(AActor* Actor)
+{
+	bDirty = true;
+}
+
+void FLivPrimitiveCache::OnLevelChanged(ULevel* Level, UWorld* InWorld)
+{
+	if (InWorld == World.Get())
+	{
+		bDirty = true;
+	}
+}
+
+void FLivPrimitiveCache::OnComponentCreatePhysicsState(UActorComponent* Component)
+{
+	// also fires when a primitive recreates its physics state, only new primitives of this world matter
+	if (bDirty || !Component->IsA<UPrimitiveComponent>() || Component->GetWorld() != World.Get())
+	{
+		return;
+	}
+
+	bDirty = !GatheredPrimitives.Contains(Cast<UPrimitiveComponent>(Component));
+}
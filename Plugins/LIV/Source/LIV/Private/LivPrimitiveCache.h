@@ -0,0 +1,90 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class AActor;
+class UActorComponent;
+class ULevel;
+class UPrimitiveComponent;
+class USceneCaptureComponent2D;
+class UWorld;
+
+/**
+ * The primitive components of a world, shared by everything that scans them every capture (FLivBackgroundReuse,
+ * FLivForegroundCulling) so the world is walked once for all of them and only when it changed: after an actor
+ * spawns, a level is added to or removed from the world or a primitive on an existing actor creates its physics
+ * state, which registering a primitive with collision does. Includes the BSP of every level (ULevel::ModelComponents).
+ *
+ * A primitive without collision registered on an existing actor is picked up by the next gather,
+ * Liv.PrimitiveCache.RefreshInterval bounds how long that takes.
+ */
+class FLivPrimitiveCache
+{
+public:
+
+	/**
+	 * Sets of what a scene capture hides, its hide lists are arrays.
+	 */
+	struct FHiddenPrimitives
+	{
+		explicit FHiddenPrimitives(const USceneCaptureComponent2D* SceneCaptureComponent);
+
+		/** Whether the scene capture doesn't render the primitive (also when it isn't registered or visible). Any thread. */
+		bool IsHidden(const UPrimitiveComponent* PrimitiveComponent) const;
+
+		TSet<const AActor*> Actors;
+		TSet<const UPrimitiveComponent*> Components;
+	};
+
+	/**
+	 * The cache of World, created on first use and released with the world. Game thread.
+	 */
+	static FLivPrimitiveCache& Get(UWorld* World);
+
+	/**
+	 * Release every cache, from module shutdown.
+	 */
+	static void Shutdown();
+
+	~FLivPrimitiveCache();
+
+	/** Every primitive in the world, gathered again first if it changed. Entries may have been destroyed since. */
+	const TArray<TWeakObjectPtr<UPrimitiveComponent>>& GetPrimitives();
+
+	/** Every movable primitive in the world, see GetPrimitives. */
+	const TArray<TWeakObjectPtr<UPrimitiveComponent>>& GetMovablePrimitives();
+
+	/** Gather again on next use. */
+	void Invalidate() { bDirty = true; }
+
+private:
+
+	explicit FLivPrimitiveCache(UWorld* InWorld);
+
+	void UpdateIfNeeded();
+	void Gather();
+
+	void AddPrimitive(UPrimitiveComponent* PrimitiveComponent);
+
+	void OnActorSpawned(AActor* Actor);
+	void OnLevelChanged(ULevel* Level, UWorld* InWorld);
+	void OnComponentCreatePhysicsState(UActorComponent* Component);
+
+	static void OnWorldCleanup(UWorld* InWorld, bool bSessionEnded, bool bCleanupResources);
+
+	TWeakObjectPtr<UWorld> World;
+
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> Primitives;
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> MovablePrimitives;
+	TSet<TObjectKey<UPrimitiveComponent>> GatheredPrimitives;
+
+	bool bDirty;
+	double LastGatherTime;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+	FDelegateHandle CreatePhysicsStateHandle;
+};
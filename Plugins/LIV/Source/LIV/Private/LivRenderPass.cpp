@@ -1,17 +1,18 @@
 // Copyright 2021 LIV Inc. - MIT License
 #include "LivRenderPass.h"
 
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
 
+#include "RenderGraphUtils.h"
 #include "ScreenPass.h"
 #include "SceneFilterRendering.h"
 #include "LivConversions.h"
-#include "LivShaders.h"
-
-#include "Windows/AllowWindowsPlatformTypes.h"
-#include "LIV.h"
+#include "LivLatencyTracker.h"
+#include "LivNativeWrapper.h"
 #include "LivPluginSettings.h"
-#include "Windows/HideWindowsPlatformTypes.h"
+#include "LivShaders.h"
+#include "LivSubmitTextureRing.h"
+#include "LivSubmitThread.h"
 
 void FLivRenderPass::InitLivPassPipelineState(FRHICommandList& RHICmdList, 
 	const FScreenPassTextureViewport& Viewport,
@@ -48,6 +49,106 @@ void FLivRenderPass::DrawLivPass(FRHICommandList& RHICmdList,
 }
 
 
+LIV_Texture FLivRenderPass::CreateLivTexture(FRHITexture2D* TextureRHI, const LIV_TEXTURE_ID_ENUM Id, const LIV_TEXTURE_TYPE_ENUM Type)
+{
+	LIV_Texture LivTexture{};
+	LivTexture.type = Type;
+	LivTexture.id = Id;
+#if PLATFORM_WINDOWS
+	LivTexture.dxgi_pixelFormat = GetRenderTargetFormat(TextureRHI->GetFormat());
+	LivTexture.d3d11_texturePtr = static_cast<ID3D11Texture2D*>(TextureRHI->GetNativeResource());
+#else
+	// no DXGI outside of Windows, only the loopback bridge reads these
+	LivTexture.dxgi_pixelFormat = static_cast<unsigned int>(TextureRHI->GetFormat());
+	LivTexture.d3d11_texturePtr = reinterpret_cast<uintptr_t>(TextureRHI->GetNativeResource());
+#endif
+	LivTexture.width = static_cast<int>(TextureRHI->GetSizeX());
+	LivTexture.height = -static_cast<int>(TextureRHI->GetSizeY());
+	LivTexture.colorSpace = Type == LIV_TEXTURE_TYPE_COLOR_BUFFER ? LIV_TEXTURE_COLOR_SPACE_SRGB : LIV_TEXTURE_COLOR_SPACE_LINEAR;
+
+	return LivTexture;
+}
+
+/**
+ * Describe a submit pass texture for LIV, ring textures reuse the description made when they were created.
+ */
+static LIV_Texture CreateLivTexture(FRDGTextureRef Texture, const LIV_TEXTURE_ID_ENUM Id, const LIV_TEXTURE_TYPE_ENUM Type = LIV_TEXTURE_TYPE_COLOR_BUFFER)
+{
+	LIV_Texture LivTexture;
+
+	if (!FLivSubmitTextureRing::Get().FindLivTexture(Texture, LivTexture))
+	{
+		const auto PooledRenderTarget = Texture->GetPooledRenderTarget();
+		LivTexture = FLivRenderPass::CreateLivTexture(PooledRenderTarget->GetRenderTargetItem().ShaderResourceTexture->GetTexture2D(), Id, Type);
+	}
+
+	return LivTexture;
+}
+
+FRDGTextureRef FLivRenderPass::CreateSubmitTexture(FRDGBuilder& GraphBuilder, const FRDGTextureDesc& Desc, const LIV_TEXTURE_ID_ENUM Id, const TCHAR* DebugName)
+{
+	if (FLivSubmitTextureRing::IsEnabled())
+	{
+		return FLivSubmitTextureRing::Get().CreateTexture(GraphBuilder, Desc, Id, LIV_TEXTURE_TYPE_COLOR_BUFFER, DebugName);
+	}
+
+	return GraphBuilder.CreateTexture(Desc, DebugName, ERDGTextureFlags::None);
+}
+
+FRDGTextureRef FLivRenderPass::CreateIntermediateTexture(FRDGBuilder& GraphBuilder, const FIntPoint& Extent, const LIV_TEXTURE_ID_ENUM Id, const TCHAR* DebugName)
+{
+	const FRDGTextureDesc Desc = FRDGTextureDesc::Create2D(Extent, EPixelFormat::PF_B8G8R8A8, FClearValueBinding::Black, TexCreate_RenderTargetable | TexCreate_ShaderResource | TexCreate_SRGB);
+
+	return CreateSubmitTexture(GraphBuilder, Desc, Id, DebugName);
+}
+
+/**
+ * Render target behind FLivRenderPass::GetTransparentTexture, released with the RHI.
+ */
+class FLivTransparentTexture : public FRenderResource
+{
+public:
+
+	virtual void ReleaseDynamicRHI() override
+	{
+		RenderTarget.SafeRelease();
+	}
+
+	TRefCountPtr<IPooledRenderTarget> RenderTarget;
+};
+
+static TGlobalResource<FLivTransparentTexture> GLivTransparentTexture;
+
+FRDGTextureRef FLivRenderPass::GetTransparentTexture(FRDGBuilder& GraphBuilder, const FIntPoint& Extent)
+{
+	TRefCountPtr<IPooledRenderTarget>& RenderTarget = GLivTransparentTexture.RenderTarget;
+
+	if (RenderTarget.IsValid() && RenderTarget->GetDesc().Extent == Extent)
+	{
+		return GraphBuilder.RegisterExternalTexture(RenderTarget, TEXT("LivTransparent"));
+	}
+
+	const FRDGTextureDesc Desc = FRDGTextureDesc::Create2D(Extent, EPixelFormat::PF_B8G8R8A8, FClearValueBinding::Transparent, TexCreate_RenderTargetable | TexCreate_ShaderResource | TexCreate_SRGB);
+	const FRDGTextureRef Texture = GraphBuilder.CreateTexture(Desc, TEXT("LivTransparent"), ERDGTextureFlags::None);
+
+	AddClearRenderTargetPass(GraphBuilder, Texture, FLinearColor::Transparent);
+	GraphBuilder.QueueTextureExtraction(Texture, &RenderTarget);
+
+	return Texture;
+}
+
+void FLivRenderPass::AddExtractPass(FRDGBuilder& GraphBuilder, FRDGTextureRef Texture, const FTextureResource* DebugResource)
+{
+	if (!Texture || !DebugResource)
+	{
+		return;
+	}
+
+	const FRDGTextureRef DebugTexture = CreateRDGTextureFromRenderTarget(GraphBuilder, DebugResource, TEXT("LivExtracted"));
+
+	AddCopyTexturePass(GraphBuilder, Texture, DebugTexture);
+}
+
 void FLivRenderPass::AddSubmitPass(FRDGBuilder& GraphBuilder, FLivSubmitParameters* Parameters)
 {
 	GraphBuilder.AddPass(
@@ -56,43 +157,98 @@ void FLivRenderPass::AddSubmitPass(FRDGBuilder& GraphBuilder, FLivSubmitParamete
 		ERDGPassFlags::Copy | ERDGPassFlags::NeverCull,
 		[Parameters](FRHICommandList& InRHICmdList)
 		{
-			const auto OutForegroundPRT = Parameters->ForegroundTexture->GetPooledRenderTarget();
-			const auto OutForegroundRHI = OutForegroundPRT->GetRenderTargetItem().ShaderResourceTexture->GetTexture2D();
-			const auto ForegroundNativeTexture = static_cast<ID3D11Texture2D*>(OutForegroundRHI->GetNativeResource());
-
-			LIV_Texture LivForegroundTexture{};
-			LivForegroundTexture.type = LIV_TEXTURE_TYPE_COLOR_BUFFER;
-			LivForegroundTexture.id = LIV_TEXTURE_FOREGROUND_COLOR_BUFFER_ID;
-			LivForegroundTexture.dxgi_pixelFormat = GetRenderTargetFormat(OutForegroundRHI->GetFormat());
-			LivForegroundTexture.d3d11_texturePtr = ForegroundNativeTexture;
-			LivForegroundTexture.width = static_cast<int>(OutForegroundRHI->GetSizeX());
-			LivForegroundTexture.height = -static_cast<int>(OutForegroundRHI->GetSizeY());
-			LivForegroundTexture.colorSpace = LIV_TEXTURE_COLOR_SPACE_SRGB;
-
-			const auto OutBackgroundPRT = Parameters->BackgroundTexture->GetPooledRenderTarget();
-			const auto OutBackgroundRHI = OutBackgroundPRT->GetRenderTargetItem().ShaderResourceTexture->GetTexture2D();
-			const auto BackgroundNativeTexture = static_cast<ID3D11Texture2D*>(OutBackgroundRHI->GetNativeResource());
-
-			LIV_Texture LivBackgroundTexture{};
-			LivBackgroundTexture.type = LIV_TEXTURE_TYPE_COLOR_BUFFER;
-			LivBackgroundTexture.id = LIV_TEXTURE_BACKGROUND_COLOR_BUFFER_ID;
-			LivBackgroundTexture.dxgi_pixelFormat = GetRenderTargetFormat(OutBackgroundRHI->GetFormat());
-			LivBackgroundTexture.d3d11_texturePtr = BackgroundNativeTexture;
-			LivBackgroundTexture.width = static_cast<int>(OutBackgroundRHI->GetSizeX());
-			LivBackgroundTexture.height = -static_cast<int>(OutBackgroundRHI->GetSizeY());
-			LivBackgroundTexture.colorSpace = LIV_TEXTURE_COLOR_SPACE_SRGB;
-
-			LIV_AddTexture(&LivForegroundTexture);
-			Parameters->ForegroundTexture->MarkResourceAsUsed();
-
-			LIV_AddTexture(&LivBackgroundTexture);
-			Parameters->BackgroundTexture->MarkResourceAsUsed();
-
-			LIV_Submit();
+#if LIV_WITH_LATENCY_TRACKING
+			FLivLatencyTracker::Get().OnSubmitBegin_RenderThread();
+#endif
+
+			TUniquePtr<FLivSubmitItem> Item = MakeUnique<FLivSubmitItem>();
+
+			const auto AddTexture = [&Item](FRDGTextureRef Texture, const LIV_TEXTURE_ID_ENUM Id, const LIV_TEXTURE_TYPE_ENUM Type)
+			{
+				Item->Textures[Item->NumTextures++] = CreateLivTexture(Texture, Id, Type);
+				Item->RenderTargets.Add(Texture->GetPooledRenderTarget());
+				Texture->MarkResourceAsUsed();
+			};
+
+			if (Parameters->ForegroundTexture)
+			{
+				AddTexture(Parameters->ForegroundTexture, LIV_TEXTURE_FOREGROUND_COLOR_BUFFER_ID, LIV_TEXTURE_TYPE_COLOR_BUFFER);
+			}
+
+			if (Parameters->BackgroundTexture)
+			{
+				AddTexture(Parameters->BackgroundTexture, LIV_TEXTURE_BACKGROUND_COLOR_BUFFER_ID, LIV_TEXTURE_TYPE_COLOR_BUFFER);
+			}
+
+			if (Parameters->BackgroundDepthTexture)
+			{
+				AddTexture(Parameters->BackgroundDepthTexture, LIV_TEXTURE_BACKGROUND_DEPTH_BUFFER_ID, LIV_TEXTURE_TYPE_DEPTH_BUFFER);
+			}
+
+			// without shareable handles the bridge would copy on the immediate context from the submit thread
+			if (FLivSubmitThread::IsEnabled() && Item->HasShareableHandles() && FLivSubmitThread::Get().Start_RenderThread())
+			{
+#if LIV_WITH_LATENCY_TRACKING
+				// timed by the submit thread rather than when this pass queues it
+				Item->bHasLatencyRecord = FLivLatencyTracker::Get().TakePendingRecord_RenderThread(Item->LatencyRecord);
+#endif
+
+				// the submit thread hands the textures over once the GPU has passed this fence
+				Item->Fence = RHICreateGPUFence(TEXT("LivSubmit"));
+				InRHICmdList.WriteGPUFence(Item->Fence);
+				FLivSubmitThread::Get().Enqueue_RenderThread(MoveTemp(Item));
+			}
+			else
+			{
+				for (int32 Index = 0; Index < Item->NumTextures; ++Index)
+				{
+					FLivNativeWrapper::AddTexture(&Item->Textures[Index]);
+				}
+
+				FLivNativeWrapper::Submit();
+			}
+
+#if LIV_WITH_LATENCY_TRACKING
+			// nothing left to time once the record went with the item
+			FLivLatencyTracker::Get().OnSubmitEnd_RenderThread(InRHICmdList);
+#endif
 		}
 	);
 }
 
+FRDGTextureRef FLivRenderPass::AddCopyBackgroundDepthPass(FRDGBuilder& GraphBuilder, const FSceneView& View)
+{
+	RDG_EVENT_SCOPE(GraphBuilder, "Liv Copy Background Depth");
+
+	const FRDGTextureDesc DepthDesc = FRDGTextureDesc::Create2D(View.Family->RenderTarget->GetSizeXY(), EPixelFormat::PF_R32_FLOAT, FClearValueBinding::Black, TexCreate_RenderTargetable | TexCreate_ShaderResource);
+	const FRDGTextureRef DepthTexture = GraphBuilder.CreateTexture(DepthDesc, TEXT("LivBackgroundDepth"), ERDGTextureFlags::None);
+
+	const auto GlobalShaderMap = GetGlobalShaderMap(View.GetFeatureLevel());
+
+	const TShaderMapRef<FLivRDGScreenPassVS> VertexShader(GlobalShaderMap);
+	const TShaderMapRef<FLivRDGCopyBackgroundDepthPS> PixelShader(GlobalShaderMap);
+
+	FLivRDGCopyBackgroundDepthPS::FParameters* Parameters = GraphBuilder.AllocParameters<FLivRDGCopyBackgroundDepthPS::FParameters>();
+	Parameters->DepthScale = LivAxisMapping::LivFromUnrealScale;
+	Parameters->View = View.ViewUniformBuffer;
+	Parameters->SceneTextures = CreateSceneTextureShaderParameters(GraphBuilder, View.GetFeatureLevel(), ESceneTextureSetupMode::SceneDepth);
+	Parameters->RenderTargets[0] = FRenderTargetBinding(DepthTexture, ERenderTargetLoadAction::ENoAction);
+
+	const FScreenPassTextureViewport ScreenPassTextureViewport(DepthTexture);
+	const FScreenPassPipelineState PipelineState(VertexShader, PixelShader);
+
+	AddLivPass(
+		GraphBuilder,
+		RDG_EVENT_NAME("Liv RDG Copy Background Depth Pass"),
+		ScreenPassTextureViewport,
+		PipelineState,
+		PixelShader,
+		Parameters
+	);
+
+	return DepthTexture;
+}
+
 
 FRDGTextureRef FLivRenderPass::CreateRDGTextureFromRenderTarget(
 	FRDGBuilder& GraphBuilder,
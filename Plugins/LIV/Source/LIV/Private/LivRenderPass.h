@@ -5,8 +5,9 @@
 #include "RenderGraphEvent.h"
 #include "PixelShaderUtils.h"
 #include "RenderGraphBuilder.h"
+#include "LivSdk.h"
 
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
 
 // Only use by name in this header, we use private includes
 // to access their definitions, should not leak into public
@@ -14,6 +15,7 @@ class FScreenPassTextureViewport;
 struct FScreenPassPipelineState;
 class FRenderTarget;
 class FTextureResource;
+class FSceneView;
 
 struct LIV_API FLivRenderPass
 {
@@ -51,10 +53,45 @@ struct LIV_API FLivRenderPass
 		);
 	}
 
+	/**
+	 * Describe a texture for FLivNativeWrapper::AddTexture.
+	 */
+	static LIV_Texture CreateLivTexture(FRHITexture2D* TextureRHI, const LIV_TEXTURE_ID_ENUM Id, const LIV_TEXTURE_TYPE_ENUM Type = LIV_TEXTURE_TYPE_COLOR_BUFFER);
+
+	/**
+	 * Create a texture a layer is rendered into before it's submitted, a slot of the submit texture ring when it's enabled.
+	 */
+	static FRDGTextureRef CreateSubmitTexture(FRDGBuilder& GraphBuilder, const FRDGTextureDesc& Desc, const LIV_TEXTURE_ID_ENUM Id, const TCHAR* DebugName);
+
+	/**
+	 * Create the 8bpc texture a capture composites a layer into before it's submitted, the same format as an
+	 * RTF_RGBA8_SRGB render target. It only lives in the graph, use AddExtractPass to keep a copy.
+	 */
+	static FRDGTextureRef CreateIntermediateTexture(FRDGBuilder& GraphBuilder, const FIntPoint& Extent, const LIV_TEXTURE_ID_ENUM Id, const TCHAR* DebugName);
+
+	/**
+	 * A transparent texture in the intermediate texture's format, submitted as a foreground known to be empty.
+	 * Cleared once and kept until the extent changes.
+	 */
+	static FRDGTextureRef GetTransparentTexture(FRDGBuilder& GraphBuilder, const FIntPoint& Extent);
+
+	/**
+	 * Copy an intermediate texture to a render target for the debugging tab, does nothing without one.
+	 */
+	static void AddExtractPass(FRDGBuilder& GraphBuilder, FRDGTextureRef Texture, const FTextureResource* DebugResource);
+
+	/**
+	 * Submit the textures set in Parameters to LIV, textures left null are not submitted.
+	 */
 	static void AddSubmitPass(class FRDGBuilder& GraphBuilder, class FLivSubmitParameters* Parameters);
 
+	/**
+	 * Copy the view's scene depth (in LIV units) so LIV can separate the foreground in the compositor.
+	 */
+	static FRDGTextureRef AddCopyBackgroundDepthPass(FRDGBuilder& GraphBuilder, const FSceneView& View);
+
 	static FRDGTextureRef CreateRDGTextureFromRenderTarget(FRDGBuilder& GraphBuilder, const FRenderTarget* RenderTarget, const TCHAR* DebugName = nullptr);
 	static FRDGTextureRef CreateRDGTextureFromRenderTarget(FRDGBuilder& GraphBuilder, const FTextureResource* TextureResource, const TCHAR* DebugName = nullptr);
 };
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -0,0 +1,114 @@
+// Copyright 2021 LIV Inc. - MIT License
+#include "LivRenderTargetPool.h"
+
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY(LogLivRenderTargetPool);
+
+static TAutoConsoleVariable<int32> CVarLivRenderTargetPoolMaxIdle(TEXT("Liv.RenderTargetPool.MaxIdle"),
+	12,
+	TEXT("Render targets kept for reuse once a capture has released them, the least recently used are freed beyond this."),
+	ECVF_Default);
+
+ULivRenderTargetPool* ULivRenderTargetPool::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<ULivRenderTargetPool>() : nullptr;
+}
+
+void ULivRenderTargetPool::Deinitialize()
+{
+	Empty();
+}
+
+UTextureRenderTarget2D* ULivRenderTargetPool::Acquire(int32 Width,
+	int32 Height,
+	FName Name,
+	ETextureRenderTargetFormat Format,
+	bool bForceLinearGamma,
+	FLinearColor ClearColor,
+	float TargetGamma)
+{
+	if (Width <= 0 || Height <= 0)
+	{
+		return nullptr;
+	}
+
+	// most recently returned first, most likely to be the same capture coming back
+	for (int32 Index = IdleRenderTargets.Num() - 1; Index >= 0; --Index)
+	{
+		UTextureRenderTarget2D* RenderTarget = IdleRenderTargets[Index];
+
+		if (RenderTarget
+			&& RenderTarget->SizeX == Width
+			&& RenderTarget->SizeY == Height
+			&& RenderTarget->RenderTargetFormat == Format
+			&& RenderTarget->bForceLinearGamma == bForceLinearGamma)
+		{
+			IdleRenderTargets.RemoveAt(Index);
+
+			RenderTarget->ClearColor = ClearColor;
+			RenderTarget->TargetGamma = TargetGamma;
+
+			// don't hand the previous user's last frame to the new one
+			RenderTarget->UpdateResourceImmediate(true);
+
+			return RenderTarget;
+		}
+	}
+
+	// captures share names, reusing one would replace a render target that is still in use
+	const FName UniqueName = MakeUniqueObjectName(GetTransientPackage(), UTextureRenderTarget2D::StaticClass(), Name);
+
+	UTextureRenderTarget2D* NewRenderTarget2D = NewObject<UTextureRenderTarget2D>(GetTransientPackage(), UniqueName);
+	check(NewRenderTarget2D);
+	NewRenderTarget2D->RenderTargetFormat = Format;
+	NewRenderTarget2D->ClearColor = ClearColor;
+	NewRenderTarget2D->bAutoGenerateMips = false;
+	NewRenderTarget2D->TargetGamma = TargetGamma;
+	NewRenderTarget2D->bForceLinearGamma = bForceLinearGamma;
+
+	// creates the resource on the render thread, the clear is queued behind it
+	NewRenderTarget2D->InitAutoFormat(Width, Height);
+	NewRenderTarget2D->UpdateResourceImmediate(true);
+
+	UE_LOG(LogLivRenderTargetPool, Verbose, TEXT("Created %s (%dx%d), %d idle."), *UniqueName.ToString(), Width, Height, IdleRenderTargets.Num());
+
+	return NewRenderTarget2D;
+}
+
+void ULivRenderTargetPool::Release(UTextureRenderTarget2D* RenderTarget)
+{
+	if (!RenderTarget)
+	{
+		return;
+	}
+
+	IdleRenderTargets.AddUnique(RenderTarget);
+
+	const int32 MaxIdle = FMath::Max(CVarLivRenderTargetPoolMaxIdle.GetValueOnGameThread(), 0);
+
+	while (IdleRenderTargets.Num() > MaxIdle)
+	{
+		if (IdleRenderTargets[0])
+		{
+			IdleRenderTargets[0]->ReleaseResource();
+		}
+
+		IdleRenderTargets.RemoveAt(0);
+	}
+}
+
+void ULivRenderTargetPool::Empty()
+{
+	for (UTextureRenderTarget2D* RenderTarget : IdleRenderTargets)
+	{
+		if (RenderTarget)
+		{
+			RenderTarget->ReleaseResource();
+		}
+	}
+
+	IdleRenderTargets.Empty();
+}
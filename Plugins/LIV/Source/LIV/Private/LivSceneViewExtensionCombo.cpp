@@ -6,6 +6,7 @@
 #include "ClipPlaneMeshPassProcessor.h"
 #include "LivConversions.h"
 #include "LivCustomClipPlane.h"
+#include "LivPassTimings.h"
 #include "LivPluginSettings.h"
 #include "LivRenderPass.h"
 #include "LivShaders.h"
@@ -50,6 +51,10 @@ void FLivSceneViewExtensionCombo::SubscribeToPostProcessingPass(
 		{
 			InOutPassCallbacks.Add(FAfterPassCallbackDelegate::CreateRaw(this, &FLivSceneViewExtensionCombo::PostProcessPassAfterFXAABackgroundOnly_RenderThread));
 		}
+		else if(bCompositorSegmentation_RenderThread)
+		{
+			InOutPassCallbacks.Add(FAfterPassCallbackDelegate::CreateRaw(this, &FLivSceneViewExtensionCombo::PostProcessPassAfterFXAACompositorSegmentation_RenderThread));
+		}
 		else if(bTransparency)
 		{
 			InOutPassCallbacks.Add(FAfterPassCallbackDelegate::CreateRaw(this, &FLivSceneViewExtensionCombo::PostProcessPassAfterFXAATransparency_RenderThread));
@@ -63,6 +68,11 @@ void FLivSceneViewExtensionCombo::SubscribeToPostProcessingPass(
 
 bool FLivSceneViewExtensionCombo::IsReadyForSubmit() const
 {
+	if (!bCaptureBackground_RenderThread)
+	{
+		return ForegroundRenderTarget2D.IsValid();
+	}
+
 	return ForegroundRenderTarget2D.IsValid() && BackgroundRenderTarget2D.IsValid()
 		&& ForegroundFrameNumber == BackgroundFrameNumber;
 }
@@ -71,17 +81,31 @@ bool FLivSceneViewExtensionCombo::IsReadyForSubmit() const
 // ReSharper disable once CppMemberFunctionMayBeConst
 FScreenPassTexture FLivSceneViewExtensionCombo::PostProcessPassAfterFXAA_RenderThread(FRDGBuilder& GraphBuilder, const FSceneView& View, const FPostProcessMaterialInputs& InOutInputs)
 {
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
+	LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
 	//check(View.bIsSceneCapture);
 
 	if (IsBackgroundCapture(*View.Family))
 	{
 		BackgroundFrameNumber = View.Family->FrameNumber;
+
+		// no foreground capture to wait for
+		if (!bCaptureForeground_RenderThread)
+		{
+			RDG_EVENT_SCOPE(GraphBuilder, "Liv Submit");
+
+			const FScreenPassTexture& SceneColor = InOutInputs.Textures[static_cast<uint32>(EPostProcessMaterialInput::SceneColor)];
+
+			FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
+			Parameters->BackgroundTexture = SceneColor.Texture;
+
+			FLivRenderPass::AddSubmitPass(GraphBuilder, Parameters);
+		}
 	}
 	else
 	{
 		const FRDGTextureDesc SceneColorDesc = FRDGTextureDesc::Create2D(View.Family->RenderTarget->GetSizeXY(), EPixelFormat::PF_B8G8R8A8, FClearValueBinding::Black, TexCreate_RenderTargetable);
-		const FRDGTextureRef LivForegroundTexture = GraphBuilder.CreateTexture(SceneColorDesc, GLivForegroundName, ERDGTextureFlags::None);
+		const FRDGTextureRef LivForegroundTexture = FLivRenderPass::CreateSubmitTexture(GraphBuilder, SceneColorDesc, LIV_TEXTURE_FOREGROUND_COLOR_BUFFER_ID, GLivForegroundName);
 
 		if (IsForegroundCapture(*View.Family))
 		{
@@ -109,6 +133,11 @@ FScreenPassTexture FLivSceneViewExtensionCombo::PostProcessPassAfterFXAA_RenderT
 				Parameters
 			);
 
+			if (ForegroundOutputRenderTarget2D.IsValid())
+			{
+				FLivRenderPass::AddExtractPass(GraphBuilder, LivForegroundTexture, ForegroundOutputRenderTarget2D->GetRenderTargetResource());
+			}
+
 			ForegroundFrameNumber = View.Family->FrameNumber;
 		}
 
@@ -116,22 +145,25 @@ FScreenPassTexture FLivSceneViewExtensionCombo::PostProcessPassAfterFXAA_RenderT
 		{
 			RDG_EVENT_SCOPE(GraphBuilder, "Liv Submit");
 
-			check(BackgroundRenderTarget2D.IsValid());
-			check(BackgroundRenderTarget2D->Resource);
-			check(BackgroundRenderTarget2D->GetRenderTargetResource());
-			// @TODO: remove this
-			check(BackgroundRenderTarget2D->GetFormat() == PF_B8G8R8A8);
+			FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
+			Parameters->ForegroundTexture = LivForegroundTexture;
 
+			if (bCaptureBackground_RenderThread)
+			{
+				check(BackgroundRenderTarget2D.IsValid());
+				check(BackgroundRenderTarget2D->Resource);
+				check(BackgroundRenderTarget2D->GetRenderTargetResource());
+				// @TODO: remove this
+				check(BackgroundRenderTarget2D->GetFormat() == PF_B8G8R8A8);
 
-			const FTextureResource* BackgroundResource = static_cast<FTextureResource*>(BackgroundRenderTarget2D->GetRenderTargetResource());
+				const FTextureResource* BackgroundResource = static_cast<FTextureResource*>(BackgroundRenderTarget2D->GetRenderTargetResource());
 
-			FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
-			Parameters->ForegroundTexture = LivForegroundTexture;
-			Parameters->BackgroundTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(
-				GraphBuilder,
-				BackgroundResource,
-				GLivBackgroundName
-			);
+				Parameters->BackgroundTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(
+					GraphBuilder,
+					BackgroundResource,
+					GLivBackgroundName
+				);
+			}
 
 			FLivRenderPass::AddSubmitPass(GraphBuilder, Parameters);
 		}
@@ -146,7 +178,8 @@ FScreenPassTexture FLivSceneViewExtensionCombo::PostProcessPassAfterFXAABackgrou
 	const FSceneView& View, 
 	const FPostProcessMaterialInputs& InOutInputs)
 {
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
+	LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
 	{
 		RDG_EVENT_SCOPE(GraphBuilder, "Liv Submit");
 
@@ -167,6 +200,31 @@ FScreenPassTexture FLivSceneViewExtensionCombo::PostProcessPassAfterFXAABackgrou
 	return AddCopyPassIfLastPass(GraphBuilder, View, InOutInputs);
 }
 
+FScreenPassTexture FLivSceneViewExtensionCombo::PostProcessPassAfterFXAACompositorSegmentation_RenderThread(
+	FRDGBuilder& GraphBuilder,
+	const FSceneView& View,
+	const FPostProcessMaterialInputs& InOutInputs)
+{
+#if LIV_CAPTURE_SUPPORTED
+	LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
+	// only the background is captured, LIV separates the foreground using its depth
+	if (IsBackgroundCapture(*View.Family))
+	{
+		RDG_EVENT_SCOPE(GraphBuilder, "Liv Submit");
+
+		const FScreenPassTexture& SceneColor = InOutInputs.Textures[static_cast<uint32>(EPostProcessMaterialInput::SceneColor)];
+
+		FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
+		Parameters->BackgroundTexture = SceneColor.Texture;
+		Parameters->BackgroundDepthTexture = FLivRenderPass::AddCopyBackgroundDepthPass(GraphBuilder, View);
+
+		FLivRenderPass::AddSubmitPass(GraphBuilder, Parameters);
+	}
+#endif
+
+	return AddCopyPassIfLastPass(GraphBuilder, View, InOutInputs);
+}
+
 FScreenPassTexture FLivSceneViewExtensionCombo::PostProcessPassAfterFXAATransparency_RenderThread(
 	FRDGBuilder& GraphBuilder, 
 	const FSceneView& View, 
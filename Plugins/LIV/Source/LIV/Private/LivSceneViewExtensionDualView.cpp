@@ -0,0 +1,98 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#include "LivSceneViewExtensionDualView.h"
+
+#include "LivPassTimings.h"
+#include "LivRenderPass.h"
+#include "PostProcessing.h"
+#include "SceneRendering.h"
+
+FLivSceneViewExtensionDualView::FLivSceneViewExtensionDualView(const FAutoRegister& AutoRegister, FViewportClient* AssociatedViewportClient)
+	: FLivSceneViewExtensionBase(AutoRegister, AssociatedViewportClient)
+{
+}
+
+void FLivSceneViewExtensionDualView::PrePostProcessPass_RenderThread(
+	FRDGBuilder& GraphBuilder,
+	const FSceneView& View,
+	const FPostProcessingInputs& Inputs)
+{
+#if LIV_CAPTURE_SUPPORTED
+	if (!IsValidForBoundRenderTarget(*View.Family) || !IsForegroundView(View) || !ForegroundOpacityRenderTarget2D.IsValid())
+	{
+		return;
+	}
+
+	LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
+
+	const FTextureResource* OpacityResource = ForegroundOpacityRenderTarget2D->Resource;
+
+	if (!OpacityResource)
+	{
+		return;
+	}
+
+	RDG_EVENT_SCOPE(GraphBuilder, "Liv Copy Foreground Opacity");
+
+	check(View.bIsViewInfo);
+	const FViewInfo& ViewInfo = static_cast<const FViewInfo&>(View);
+
+	const FRDGTextureRef OpacityTexture = FLivRenderPass::CreateRDGTextureFromRenderTarget(
+		GraphBuilder,
+		OpacityResource,
+		TEXT("LivForegroundOpacity")
+	);
+
+	// the views share the scene textures, copy just the foreground's rect, the foreground is
+	// the right half of the family and may be cropped to the player's region
+	AddDrawTexturePass(
+		GraphBuilder,
+		ViewInfo,
+		(*Inputs.SceneTextures)->SceneColorTexture,
+		OpacityTexture,
+		ViewInfo.ViewRect.Min,
+		ViewInfo.ViewRect.Min - FIntPoint(OpacityResource->GetSizeX(), 0),
+		ViewInfo.ViewRect.Size());
+
+#endif
+}
+
+#if WITH_EYE_ADAPTATION_CALLBACK
+void FLivSceneViewExtensionDualView::PostEyeAdaptation_RenderThread(FRDGBuilder& GraphBuilder, const FSceneView& View, FRDGTextureRef EyeAdaptationTexture)
+{
+	FLivSceneViewExtensionBase::PostEyeAdaptation_RenderThread(GraphBuilder, View, EyeAdaptationTexture);
+
+	if (!IsValidForBoundRenderTarget(*View.Family))
+	{
+		return;
+	}
+
+	if (!IsForegroundView(View))
+	{
+		BackgroundGraphBuilder = &GraphBuilder;
+		BackgroundEyeAdaptationTexture = EyeAdaptationTexture;
+		BackgroundFrameNumber = GFrameNumberRenderThread;
+		return;
+	}
+
+	// only if the background was rendered by this graph, i.e. in the same family this frame
+	if (BackgroundGraphBuilder != &GraphBuilder || BackgroundFrameNumber != GFrameNumberRenderThread || !BackgroundEyeAdaptationTexture)
+	{
+		return;
+	}
+
+	RDG_EVENT_SCOPE(GraphBuilder, "Liv Share Eye Adaptation (Foreground)");
+
+	AddDrawTexturePass(
+		GraphBuilder,
+		static_cast<const FViewInfo&>(View),
+		BackgroundEyeAdaptationTexture,
+		EyeAdaptationTexture,
+		FIntPoint::ZeroValue,
+		FIntPoint::ZeroValue,
+		EyeAdaptationTexture->Desc.Extent);
+
+	BackgroundGraphBuilder = nullptr;
+	BackgroundEyeAdaptationTexture = nullptr;
+}
+#endif
@@ -0,0 +1,103 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#include "LivSceneViewExtensionLateLatch.h"
+
+#include "LivInputFramePoller.h"
+#include "Components/SceneCaptureComponent.h"
+#include "RenderingThread.h"
+
+static TAutoConsoleVariable<bool> CVarLivLateLatch(TEXT("Liv.LateLatch"),
+	true,
+	TEXT("Late update LIV capture views with the newest camera pose on the render thread (requires Late Latch Camera Pose in the LIV settings)."),
+	ECVF_RenderThreadSafe);
+
+FLivSceneViewExtensionLateLatch::FLivSceneViewExtensionLateLatch(const FAutoRegister& AutoRegister, FViewportClient* AssociatedViewportClient)
+	: FLivSceneViewExtensionBase(AutoRegister, AssociatedViewportClient)
+{
+}
+
+void FLivSceneViewExtensionLateLatch::SetCaptureView_GameThread(USceneCaptureComponent* CaptureComponent, int32 NumViews)
+{
+	check(IsInGameThread());
+
+	const USceneComponent* Parent = CaptureComponent->GetAttachParent();
+
+	// views are recognised by their view state, which only exists while rendering state is persisted
+	CaptureComponent->bAlwaysPersistRenderingState = true;
+
+	FCaptureView CaptureView;
+
+	for (int32 ViewIndex = 0; ViewIndex < FMath::Clamp(NumViews, 1, MaxViewsPerCapture); ++ViewIndex)
+	{
+		CaptureView.ViewStates.Add(CaptureComponent->GetViewState(ViewIndex));
+	}
+
+	CaptureView.TrackingToWorld = Parent ? Parent->GetComponentTransform() : FTransform::Identity;
+
+	// queued ahead of the capture's own render commands, keep the extension alive until then
+	ENQUEUE_RENDER_COMMAND(LivSetCaptureView)(
+		[this, Self = AsShared(), Key = static_cast<const void*>(CaptureComponent), CaptureView](FRHICommandListImmediate& RHICmdList)
+		{
+			CaptureViews.Add(Key, CaptureView);
+		});
+}
+
+void FLivSceneViewExtensionLateLatch::ClearCaptureView_GameThread(const USceneCaptureComponent* CaptureComponent)
+{
+	check(IsInGameThread());
+
+	ENQUEUE_RENDER_COMMAND(LivClearCaptureView)(
+		[this, Self = AsShared(), Key = static_cast<const void*>(CaptureComponent)](FRHICommandListImmediate& RHICmdList)
+		{
+			CaptureViews.Remove(Key);
+		});
+}
+
+void FLivSceneViewExtensionLateLatch::PreRenderView_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneView& InView)
+{
+	FLivSceneViewExtensionBase::PreRenderView_RenderThread(RHICmdList, InView);
+
+	if (CaptureViews.Num() == 0 || !CVarLivLateLatch.GetValueOnRenderThread())
+	{
+		return;
+	}
+
+	// latch once per frame so background and foreground captures agree
+	if (LatchedFrameNumber != GFrameNumberRenderThread)
+	{
+		LatchedFrameNumber = GFrameNumberRenderThread;
+
+		FLivPolledPose Pose;
+		bHasLatchedPose = FLivInputFramePoller::Get().GetLatestPose_RenderThread(Pose);
+		LatchedPose = FTransform(Pose.Rotation, Pose.Location);
+	}
+
+	if (!bHasLatchedPose)
+	{
+		return;
+	}
+
+	// scene captures the game renders itself have no view state or a different one
+	if (!InView.State)
+	{
+		return;
+	}
+
+	for (const TPair<const void*, FCaptureView>& Pair : CaptureViews)
+	{
+		const FCaptureView& CaptureView = Pair.Value;
+
+		// only views rendered by a LIV capture
+		if (!CaptureView.ViewStates.Contains(InView.State))
+		{
+			continue;
+		}
+
+		const FTransform LatchedViewTransform = LatchedPose * CaptureView.TrackingToWorld;
+
+		InView.ViewLocation = LatchedViewTransform.GetLocation();
+		InView.ViewRotation = LatchedViewTransform.Rotator();
+		InView.UpdateViewMatrix();
+		return;
+	}
+}
@@ -7,6 +7,7 @@
 #include "EngineModule.h"
 #include "LivConversions.h"
 #include "LivCustomClipPlane.h"
+#include "LivPassTimings.h"
 #include "LivPluginSettings.h"
 #include "LivRenderPass.h"
 #include "LivShaders.h"
@@ -252,7 +253,8 @@ FScreenPassTexture FLivSceneViewExtensionMulti::PostProcessPassAfterFXAA_RenderT
 	// @todo: this doesn't trigger in 4.26 but does in 4.27? Won't make much of a difference buts odd
 	// check(View.bIsSceneCapture);
 
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
+	LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
 	
 	if (IsBackgroundCapture(*View.Family))
 	{
@@ -269,10 +271,10 @@ FScreenPassTexture FLivSceneViewExtensionMulti::PostProcessPassAfterFXAA_RenderT
 			const TShaderMapRef<FLivRDGScreenPassVS> VertexShader(GlobalShaderMap);
 			const TShaderMapRef<FLivRDGCopyFullSceneColorPS> PixelShader(GlobalShaderMap);
 
-			const FTextureResource* BackgroundOutputResource = static_cast<FTextureResource*>(BackgroundOutputRenderTarget->GetRenderTargetResource());
-			const FRDGTextureRef BackgroundOutput = FLivRenderPass::CreateRDGTextureFromRenderTarget(
+			const FRDGTextureRef BackgroundOutput = FLivRenderPass::CreateIntermediateTexture(
 				GraphBuilder,
-				BackgroundOutputResource,
+				View.Family->RenderTarget->GetSizeXY(),
+				LIV_TEXTURE_BACKGROUND_COLOR_BUFFER_ID,
 				GBackgroundName
 			);
 
@@ -295,6 +297,27 @@ FScreenPassTexture FLivSceneViewExtensionMulti::PostProcessPassAfterFXAA_RenderT
 				PixelShader,
 				Parameters
 			);
+
+			if (BackgroundOutputRenderTarget.IsValid())
+			{
+				FLivRenderPass::AddExtractPass(GraphBuilder, BackgroundOutput, BackgroundOutputRenderTarget->GetRenderTargetResource());
+			}
+
+			// no foreground capture to wait for
+			if (!bCaptureForeground_RenderThread)
+			{
+				RDG_EVENT_SCOPE(GraphBuilder, "Liv Submit");
+
+				FLivSubmitParameters* SubmitParameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
+				SubmitParameters->BackgroundTexture = BackgroundOutput;
+
+				FLivRenderPass::AddSubmitPass(GraphBuilder, SubmitParameters);
+			}
+			else
+			{
+				// submitted from the foreground capture's graph
+				GraphBuilder.QueueTextureExtraction(BackgroundOutput, &BackgroundOutputTexture);
+			}
 		}
 
 		ensure(InOutInputs.OverrideOutput.IsValid());
@@ -304,7 +327,7 @@ FScreenPassTexture FLivSceneViewExtensionMulti::PostProcessPassAfterFXAA_RenderT
 		ensure(InOutInputs.OverrideOutput.IsValid());
 
 		const FRDGTextureDesc SceneColorDesc = FRDGTextureDesc::Create2D(View.Family->RenderTarget->GetSizeXY(), EPixelFormat::PF_B8G8R8A8, FClearValueBinding::Black, TexCreate_RenderTargetable | TexCreate_SRGB);
-		const FRDGTextureRef LivForegroundTexture = GraphBuilder.CreateTexture(SceneColorDesc, GForegroundName, ERDGTextureFlags::None);
+		const FRDGTextureRef LivForegroundTexture = FLivRenderPass::CreateSubmitTexture(GraphBuilder, SceneColorDesc, LIV_TEXTURE_FOREGROUND_COLOR_BUFFER_ID, GForegroundName);
 		
 		{
 			RDG_EVENT_SCOPE(GraphBuilder, "Liv Copy Full Scene Color (FG)");
@@ -336,6 +359,11 @@ FScreenPassTexture FLivSceneViewExtensionMulti::PostProcessPassAfterFXAA_RenderT
 				PixelShader,
 				Parameters
 			);
+
+			if (ForegroundOutputRenderTarget2D.IsValid())
+			{
+				FLivRenderPass::AddExtractPass(GraphBuilder, LivForegroundTexture, ForegroundOutputRenderTarget2D->GetRenderTargetResource());
+			}
 		}
 
 		ForegroundFrameNumber = View.Family->FrameNumber;
@@ -349,21 +377,17 @@ FScreenPassTexture FLivSceneViewExtensionMulti::PostProcessPassAfterFXAA_RenderT
 			{
 				RDG_EVENT_SCOPE(GraphBuilder, "Liv Submit");
 
-				ensure(BackgroundRenderTarget2D.IsValid());
-				// @TODO: this has triggered (moving windows around) so instead just bail. but for now its handy to use the check
-				ensure(BackgroundRenderTarget2D->GetRenderTargetResource());
-
-				const FTextureResource* BackgroundOutputResource = static_cast<FTextureResource*>(BackgroundOutputRenderTarget->GetRenderTargetResource());
-				const FRDGTextureRef Background = FLivRenderPass::CreateRDGTextureFromRenderTarget(
-					GraphBuilder,
-					BackgroundOutputResource,
-					GBackgroundName
-				);
-
 				FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
 
 				Parameters->ForegroundTexture = LivForegroundTexture;
-				Parameters->BackgroundTexture = Background;
+
+				// background is still captured for eye adaptation, only the submit is skipped
+				if (bCaptureBackground_RenderThread && ensure(BackgroundOutputTexture.IsValid()))
+				{
+					Parameters->BackgroundTexture = GraphBuilder.RegisterExternalTexture(BackgroundOutputTexture, GBackgroundName);
+				}
+
+				BackgroundOutputTexture.SafeRelease();
 
 				FLivRenderPass::AddSubmitPass(GraphBuilder, Parameters);
 			}
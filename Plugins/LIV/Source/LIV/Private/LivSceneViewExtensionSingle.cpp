@@ -4,6 +4,7 @@
 
 #include "LivConversions.h"
 #include "LivCustomClipPlane.h"
+#include "LivPassTimings.h"
 #include "LivPluginSettings.h"
 #include "LivRenderPass.h"
 #include "LivShaders.h"
@@ -21,7 +22,7 @@ TAutoConsoleVariable<bool> CVarRenderClipPlanes(TEXT("Liv.Debug.RenderClipPlanes
                                                 TEXT("Debug disable render clip plane pass in scene view extension.")
 );
 
-#if PLATFORM_WINDOWS
+#if LIV_CAPTURE_SUPPORTED
 
 static FRDGTextureRef CreateRDGTextureFromRenderTarget(
 	FRDGBuilder& GraphBuilder,
@@ -68,15 +69,16 @@ void ProcessLivPasses_RenderThread(
 	const FSceneView& View,
 	FRDGTextureRef SceneColorTexture,
 	FRDGTextureRef SceneDepthTexture,
-	const TArray<ULivCustomClipPlane*>& ClipPlanes
+	const TArray<ULivCustomClipPlane*>& ClipPlanes,
+	bool bSubmitBackground
 )
 {
 	FRDGTextureDesc SceneColorDesc = SceneColorTexture->Desc;
 	SceneColorDesc.Format = EPixelFormat::PF_B8G8R8A8;
 	//SceneColorDesc.Flags |= TexCreate_RenderTargetable;
 	SceneColorDesc.Extent = View.Family->RenderTarget->GetSizeXY();
-	const FRDGTextureRef LivBackgroundTexture = GraphBuilder.CreateTexture(SceneColorDesc, TEXT("LivBackground"), ERDGTextureFlags::None);
-	const FRDGTextureRef LivForegroundTexture = GraphBuilder.CreateTexture(SceneColorDesc, TEXT("LivForeground"), ERDGTextureFlags::None);
+	const FRDGTextureRef LivBackgroundTexture = FLivRenderPass::CreateSubmitTexture(GraphBuilder, SceneColorDesc, LIV_TEXTURE_BACKGROUND_COLOR_BUFFER_ID, TEXT("LivBackground"));
+	const FRDGTextureRef LivForegroundTexture = FLivRenderPass::CreateSubmitTexture(GraphBuilder, SceneColorDesc, LIV_TEXTURE_FOREGROUND_COLOR_BUFFER_ID, TEXT("LivForeground"));
 	const FRDGTextureRef LivBackgroundCopyTexture = GraphBuilder.CreateTexture(SceneColorDesc, TEXT("LivBackgroundCopy"), ERDGTextureFlags::None);
 
 	//
@@ -243,7 +245,21 @@ void ProcessLivPasses_RenderThread(
 
 		FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
 		Parameters->ForegroundTexture = LivForegroundTexture;
-		Parameters->BackgroundTexture = LivBackgroundTexture;
+		Parameters->BackgroundTexture = bSubmitBackground ? LivBackgroundTexture : nullptr;
+
+		FLivRenderPass::AddSubmitPass(GraphBuilder, Parameters);
+	}
+}
+
+void ProcessLivCompositorSegmentation_RenderThread(FRDGBuilder& GraphBuilder, const FSceneView& View, FRDGTextureRef SceneColorTexture)
+{
+	{
+		RDG_EVENT_SCOPE(GraphBuilder, "Liv Submit");
+
+		FLivSubmitParameters* Parameters = GraphBuilder.AllocParameters<FLivSubmitParameters>();
+
+		Parameters->BackgroundTexture = SceneColorTexture;
+		Parameters->BackgroundDepthTexture = FLivRenderPass::AddCopyBackgroundDepthPass(GraphBuilder, View);
 
 		FLivRenderPass::AddSubmitPass(GraphBuilder, Parameters);
 	}
@@ -368,19 +384,20 @@ void FLivSceneViewExtensionSingle::PrePostProcessPass_RenderThread(
 	const FSceneView& View,
 	const FPostProcessingInputs& Inputs)
 {
-#if PLATFORM_WINDOWS
-
+#if LIV_CAPTURE_SUPPORTED
 	if(!IsValidForBoundRenderTarget(*View.Family))
 	{
 		return;
 	}
 
+	LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
+
 	// @NOTE: this path will not yield any post processing like anti-aliasing and tonemapping
 	// so we'd have to live without or add it back manually
 	// OR just do some processing here like rendering depth and capture later on (though may as well just do it all later?)
 	if (GetDefault<ULivPluginSettings>()->SceneViewExtensionCaptureStage == ELivSceneViewExtensionCaptureStage::PrePostProcess)
 	{
-		ProcessLivPasses_RenderThread<false>(GraphBuilder, View, (*Inputs.SceneTextures)->SceneColorTexture, (*Inputs.SceneTextures)->SceneDepthTexture, ClipPlanes);
+		ProcessLivPasses_RenderThread<false>(GraphBuilder, View, (*Inputs.SceneTextures)->SceneColorTexture, (*Inputs.SceneTextures)->SceneDepthTexture, ClipPlanes, bCaptureBackground_RenderThread);
 	}
 
 #endif
@@ -392,21 +409,27 @@ FScreenPassTexture FLivSceneViewExtensionSingle::PostProcessPassAfterTonemap_Ren
 {
 	//check(View.bIsSceneCapture);
 
-#if PLATFORM_WINDOWS
-
+#if LIV_CAPTURE_SUPPORTED
 	if (IsValidForBoundRenderTarget(*View.Family))
 	{
-		if (GetDefault<ULivPluginSettings>()->bBackgroundOnly)
+		LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
+
+		if (!bCaptureForeground_RenderThread)
 		{
 			ProcessLivBackgroundOnly_RenderThread(GraphBuilder, View);
 		}
+		else if (bCompositorSegmentation_RenderThread)
+		{
+			const FScreenPassTexture& SceneColor = InOutInputs.Textures[static_cast<uint32>(EPostProcessMaterialInput::SceneColor)];
+			ProcessLivCompositorSegmentation_RenderThread(GraphBuilder, View, SceneColor.Texture);
+		}
 		else
 		{
 			const FScreenPassTexture& SceneColor = InOutInputs.Textures[static_cast<uint32>(EPostProcessMaterialInput::SceneColor)];
 			const FScreenPassRenderTarget SceneColorRenderTarget(SceneColor, ERenderTargetLoadAction::ELoad);
 
 			const TRDGUniformBufferRef<FSceneTextureUniformParameters> SceneTextures = CreateSceneTextureUniformBuffer(GraphBuilder, View.GetFeatureLevel(), ESceneTextureSetupMode::All);
-			ProcessLivPasses_RenderThread<true>(GraphBuilder, View, SceneColorRenderTarget.Texture, (*SceneTextures)->SceneDepthTexture, ClipPlanes);
+			ProcessLivPasses_RenderThread<true>(GraphBuilder, View, SceneColorRenderTarget.Texture, (*SceneTextures)->SceneDepthTexture, ClipPlanes, bCaptureBackground_RenderThread);
 		}
 	}
 
@@ -421,21 +444,27 @@ FScreenPassTexture FLivSceneViewExtensionSingle::PostProcessPassAfterFXAA_Render
 {
 	//check(View.bIsSceneCapture);
 
-#if PLATFORM_WINDOWS
-
+#if LIV_CAPTURE_SUPPORTED
 	if (IsValidForBoundRenderTarget(*View.Family))
 	{
-		if (GetDefault<ULivPluginSettings>()->bBackgroundOnly)
+		LIV_PASS_TIMINGS_SCOPE(GraphBuilder);
+
+		if (!bCaptureForeground_RenderThread)
 		{
 			ProcessLivBackgroundOnly_RenderThread(GraphBuilder, View);
 		}
+		else if (bCompositorSegmentation_RenderThread)
+		{
+			const FScreenPassTexture& SceneColor = InOutInputs.Textures[static_cast<uint32>(EPostProcessMaterialInput::SceneColor)];
+			ProcessLivCompositorSegmentation_RenderThread(GraphBuilder, View, SceneColor.Texture);
+		}
 		else
 		{
 			const FScreenPassTexture& SceneColor = InOutInputs.Textures[static_cast<uint32>(EPostProcessMaterialInput::SceneColor)];
 			const FScreenPassRenderTarget SceneColorRenderTarget(SceneColor, ERenderTargetLoadAction::ELoad);
 
 			const TRDGUniformBufferRef<FSceneTextureUniformParameters> SceneTextures = CreateSceneTextureUniformBuffer(GraphBuilder, View.GetFeatureLevel(), ESceneTextureSetupMode::All);
-			ProcessLivPasses_RenderThread<true>(GraphBuilder, View, SceneColorRenderTarget.Texture, (*SceneTextures)->SceneDepthTexture, ClipPlanes);
+			ProcessLivPasses_RenderThread<true>(GraphBuilder, View, SceneColorRenderTarget.Texture, (*SceneTextures)->SceneDepthTexture, ClipPlanes, bCaptureBackground_RenderThread);
 		}
 	}
 
@@ -3,6 +3,7 @@
 #include "LivSceneViewExtensionsCommon.h"
 #include "ScreenPass.h"
 #include "PostProcess/PostProcessMaterial.h"
+#include "RenderingThread.h"
 
 FLivSceneViewExtensionBase::FLivSceneViewExtensionBase(
 	const FAutoRegister& AutoRegister,
@@ -19,6 +20,19 @@ bool FLivSceneViewExtensionBase::IsActiveThisFrameInContext(FSceneViewExtensionC
 	return Context.Viewport == nullptr;
 }
 
+void FLivSceneViewExtensionBase::SetCaptureLayers_GameThread(bool bInCaptureBackground, bool bInCaptureForeground, bool bInCompositorSegmentation)
+{
+	check(IsInGameThread());
+
+	ENQUEUE_RENDER_COMMAND(LivSetCaptureLayers)(
+		[this, Self = AsShared(), bInCaptureBackground, bInCaptureForeground, bInCompositorSegmentation](FRHICommandListImmediate& RHICmdList)
+		{
+			bCaptureBackground_RenderThread = bInCaptureBackground;
+			bCaptureForeground_RenderThread = bInCaptureForeground;
+			bCompositorSegmentation_RenderThread = bInCompositorSegmentation;
+		});
+}
+
 FScreenPassTexture FLivSceneViewExtensionBase::AddCopyPassIfLastPass(FRDGBuilder& GraphBuilder, const FSceneView& View, const FPostProcessMaterialInputs& InOutInputs) const
 {
 	const FScreenPassTexture& SceneColor = InOutInputs.Textures[static_cast<uint32>(EPostProcessMaterialInput::SceneColor)];
@@ -0,0 +1,40 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * The loopback bridge (see LivLoopbackBridge.h) is an in-process stand-in for the LIV App.
+ * It is compiled into every non-shipping build and only used when requested with -LivLoopback.
+ */
+#if !defined(LIV_WITH_LOOPBACK)
+#define LIV_WITH_LOOPBACK !UE_BUILD_SHIPPING
+#endif
+
+/**
+ * Capture and submit code paths are compiled wherever there is a bridge to submit to:
+ * the LIV App (Windows only) or the loopback bridge.
+ */
+#define LIV_CAPTURE_SUPPORTED (PLATFORM_WINDOWS || LIV_WITH_LOOPBACK)
+
+/**
+ * Recording input frames to disk and replaying them through the loopback bridge (see LivInputFrameTrace.h).
+ */
+#if !defined(LIV_WITH_INPUT_FRAME_TRACE)
+#define LIV_WITH_INPUT_FRAME_TRACE (LIV_CAPTURE_SUPPORTED && !UE_BUILD_SHIPPING)
+#endif
+
+/**
+ * Timing captures from their input frame to GPU completion (see LivLatencyTracker.h).
+ */
+#if !defined(LIV_WITH_LATENCY_TRACKING)
+#define LIV_WITH_LATENCY_TRACKING (LIV_CAPTURE_SUPPORTED && !UE_BUILD_SHIPPING)
+#endif
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include "LIV_BridgeDatastruct.h"
+#include "Windows/HideWindowsPlatformTypes.h"
+#else
+#include "LIV_BridgeDatastruct.h"
+#endif
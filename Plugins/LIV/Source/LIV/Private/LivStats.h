@@ -0,0 +1,8 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+// "stat Liv"
+DECLARE_STATS_GROUP(TEXT("LIV"), STATGROUP_Liv, STATCAT_Advanced);
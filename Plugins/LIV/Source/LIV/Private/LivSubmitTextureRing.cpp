@@ -0,0 +1,132 @@
+// Copyright 2021 LIV Inc. - MIT License
+#include "LivSubmitTextureRing.h"
+
+#if LIV_CAPTURE_SUPPORTED
+
+#include "LivRenderPass.h"
+#include "LivSubmitThread.h"
+#include "RenderGraphBuilder.h"
+#include "RenderTargetPool.h"
+
+static TAutoConsoleVariable<int32> CVarLivSubmitTextureRing(TEXT("Liv.SubmitTextureRing"),
+	3,
+	TEXT("Number of persistent shareable textures per submitted layer, 0 renders into transient textures instead."),
+	ECVF_RenderThreadSafe);
+
+static TGlobalResource<FLivSubmitTextureRing> GLivSubmitTextureRing;
+
+FLivSubmitTextureRing& FLivSubmitTextureRing::Get()
+{
+	return GLivSubmitTextureRing;
+}
+
+bool FLivSubmitTextureRing::IsEnabled()
+{
+	return CVarLivSubmitTextureRing.GetValueOnRenderThread() > 0;
+}
+
+FRDGTextureRef FLivSubmitTextureRing::CreateTexture(FRDGBuilder& GraphBuilder, const FRDGTextureDesc& Desc, LIV_TEXTURE_ID_ENUM Id, LIV_TEXTURE_TYPE_ENUM Type, const TCHAR* DebugName)
+{
+	check(IsInRenderingThread());
+
+	// at least two so we never write the slot LIV may still be reading
+	const int32 NumSlots = FMath::Max(CVarLivSubmitTextureRing.GetValueOnRenderThread(), 2);
+
+	FLayer& Layer = Layers.FindOrAdd(Id);
+
+	if (Layer.Extent != Desc.Extent || Layer.Format != Desc.Format || Layer.Flags != Desc.Flags || Layer.Slots.Num() != NumSlots)
+	{
+		CreateSlots(Layer, Desc, Id, Type, NumSlots, DebugName);
+	}
+
+	// a slot referenced by anything but the ring is still waiting on the submit thread
+	FLivSubmitThread::Get().ReleaseItems_RenderThread();
+
+	for (int32 Offset = 1; Offset <= Layer.Slots.Num(); ++Offset)
+	{
+		const int32 SlotIndex = (Layer.Index + Offset) % Layer.Slots.Num();
+
+		// never the slot submitted last, LIV may still be reading it
+		if (SlotIndex == Layer.Index || Layer.Slots[SlotIndex].RenderTarget->GetRefCount() > 1)
+		{
+			continue;
+		}
+
+		Layer.Index = SlotIndex;
+		return GraphBuilder.RegisterExternalTexture(Layer.Slots[SlotIndex].RenderTarget, DebugName);
+	}
+
+	// every slot is in flight, render into a transient texture rather than over one LIV hasn't read yet
+	UE_LOG(LogLivSubmitThread, Verbose, TEXT("All %d submit texture ring slots for %s are in flight."), Layer.Slots.Num(), DebugName);
+
+	return GraphBuilder.CreateTexture(Desc, DebugName, ERDGTextureFlags::None);
+}
+
+bool FLivSubmitTextureRing::FindLivTexture(const FRDGTextureRef Texture, LIV_Texture& OutLivTexture) const
+{
+	const IPooledRenderTarget* RenderTarget = Texture->GetPooledRenderTarget();
+
+	for (const TPair<LIV_TEXTURE_ID_ENUM, FLayer>& Layer : Layers)
+	{
+		for (const FSlot& Slot : Layer.Value.Slots)
+		{
+			if (Slot.RenderTarget.GetReference() == RenderTarget)
+			{
+				OutLivTexture = Slot.LivTexture;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void FLivSubmitTextureRing::ReleaseDynamicRHI()
+{
+	Layers.Empty();
+}
+
+void FLivSubmitTextureRing::CreateSlots(FLayer& Layer, const FRDGTextureDesc& Desc, LIV_TEXTURE_ID_ENUM Id, LIV_TEXTURE_TYPE_ENUM Type, int32 NumSlots, const TCHAR* DebugName)
+{
+	Layer.Extent = Desc.Extent;
+	Layer.Format = Desc.Format;
+	Layer.Flags = Desc.Flags;
+	Layer.Index = INDEX_NONE;
+	Layer.Slots.Reset(NumSlots);
+
+	const ETextureCreateFlags Flags = Desc.Flags | TexCreate_Shared | TexCreate_RenderTargetable | TexCreate_ShaderResource;
+
+	for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+	{
+		FRHIResourceCreateInfo CreateInfo(DebugName);
+		CreateInfo.ClearValueBinding = Desc.ClearValue;
+
+		const FTexture2DRHIRef Texture = RHICreateTexture2D(Desc.Extent.X, Desc.Extent.Y, Desc.Format, 1, 1, Flags, CreateInfo);
+
+		FSceneRenderTargetItem Item;
+		Item.TargetableTexture = Texture;
+		Item.ShaderResourceTexture = Texture;
+
+		FPooledRenderTargetDesc PooledDesc = FPooledRenderTargetDesc::Create2DDesc(Desc.Extent, Desc.Format, Desc.ClearValue, Flags, TexCreate_None, false);
+		PooledDesc.DebugName = DebugName;
+
+		FSlot& Slot = Layer.Slots.AddDefaulted_GetRef();
+		GRenderTargetPool.CreateUntrackedElement(PooledDesc, Slot.RenderTarget, Item);
+
+		Slot.LivTexture = FLivRenderPass::CreateLivTexture(Texture, Id, Type);
+
+#if PLATFORM_WINDOWS
+		// only textures created with TexCreate_Shared by the D3D11 RHI have a handle, LIV falls back to the pointer otherwise
+		IDXGIResource* DXGIResource = nullptr;
+		IUnknown* NativeResource = static_cast<IUnknown*>(Texture->GetNativeResource());
+
+		if (NativeResource && SUCCEEDED(NativeResource->QueryInterface(__uuidof(IDXGIResource), reinterpret_cast<void**>(&DXGIResource))))
+		{
+			DXGIResource->GetSharedHandle(&Slot.LivTexture.ShareableHandle);
+			DXGIResource->Release();
+		}
+#endif
+	}
+}
+
+#endif
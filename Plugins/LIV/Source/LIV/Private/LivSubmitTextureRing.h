@@ -0,0 +1,71 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LivSdk.h"
+
+#if LIV_CAPTURE_SUPPORTED
+
+#include "RenderGraphResources.h"
+#include "RenderResource.h"
+
+class FRDGBuilder;
+
+/**
+ * A small ring of persistent, shareable textures per submitted layer.
+ *
+ * Passes render the layers they submit straight into the current slot (see FLivRenderPass::CreateSubmitTexture),
+ * the LIV_Texture for every slot (including its ShareableHandle) is created once when the ring is (re)created for
+ * a resolution/format so submitting doesn't re-describe a different pooled texture every frame.
+ * A slot is skipped while a queued submission still references it, when every slot is busy the layer falls back to
+ * a transient texture for that frame rather than overwriting one LIV hasn't read yet.
+ *
+ * Render thread only.
+ */
+class FLivSubmitTextureRing : public FRenderResource
+{
+public:
+
+	static FLivSubmitTextureRing& Get();
+
+	/**
+	 * Whether layers should be rendered into the ring (Liv.SubmitTextureRing > 0).
+	 */
+	static bool IsEnabled();
+
+	/**
+	 * Advance to the next free slot for a layer and register it with the graph,
+	 * recreating the layer's slots when the extent, format or flags change.
+	 */
+	FRDGTextureRef CreateTexture(FRDGBuilder& GraphBuilder, const FRDGTextureDesc& Desc, LIV_TEXTURE_ID_ENUM Id, LIV_TEXTURE_TYPE_ENUM Type, const TCHAR* DebugName);
+
+	/**
+	 * Copy the LIV_Texture registered for a ring texture, returns false if the texture is not from the ring.
+	 */
+	bool FindLivTexture(const FRDGTextureRef Texture, LIV_Texture& OutLivTexture) const;
+
+	virtual void ReleaseDynamicRHI() override;
+
+private:
+
+	struct FSlot
+	{
+		TRefCountPtr<IPooledRenderTarget> RenderTarget;
+		LIV_Texture LivTexture;
+	};
+
+	struct FLayer
+	{
+		FIntPoint Extent = FIntPoint::ZeroValue;
+		EPixelFormat Format = PF_Unknown;
+		ETextureCreateFlags Flags = TexCreate_None;
+		int32 Index = INDEX_NONE;
+		TArray<FSlot> Slots;
+	};
+
+	static void CreateSlots(FLayer& Layer, const FRDGTextureDesc& Desc, LIV_TEXTURE_ID_ENUM Id, LIV_TEXTURE_TYPE_ENUM Type, int32 NumSlots, const TCHAR* DebugName);
+
+	TMap<LIV_TEXTURE_ID_ENUM, FLayer> Layers;
+};
+
+#endif
@@ -0,0 +1,286 @@
+// Copyright 2021 LIV Inc. - MIT License
+#include "LivSubmitThread.h"
+
+#if LIV_CAPTURE_SUPPORTED
+
+#include "LivNativeWrapper.h"
+#include "HAL/Event.h"
+#include "Misc/CoreDelegates.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "RenderingThread.h"
+
+DEFINE_LOG_CATEGORY(LogLivSubmitThread);
+
+static TAutoConsoleVariable<bool> CVarLivSubmitThread(TEXT("Liv.SubmitThread"),
+	false,
+	TEXT("Call LIV_AddTexture/LIV_Submit on a dedicated thread once the GPU has finished the textures, rather than in the submit pass."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarLivSubmitThreadMaxQueued(TEXT("Liv.SubmitThread.MaxQueued"),
+	1,
+	TEXT("Submissions allowed to wait behind the one being submitted before the oldest are dropped."),
+	ECVF_RenderThreadSafe);
+
+// give up on a fence after this long, the textures are stale by then anyway
+static constexpr double LivSubmitFenceTimeout = 0.1;
+
+bool FLivSubmitItem::HasShareableHandles() const
+{
+#if PLATFORM_WINDOWS
+	for (int32 Index = 0; Index < NumTextures; ++Index)
+	{
+		if (!Textures[Index].ShareableHandle)
+		{
+			return false;
+		}
+	}
+#endif
+
+	return true;
+}
+
+void FLivSubmitQueue::Enqueue(FLivSubmitItem* Item)
+{
+	PendingItems.Enqueue(Item);
+	NumPending.Increment();
+}
+
+FLivSubmitItem* FLivSubmitQueue::Dequeue(int32 MaxQueued)
+{
+	FLivSubmitItem* Item = nullptr;
+
+	if (!PendingItems.Dequeue(Item))
+	{
+		return nullptr;
+	}
+
+	NumPending.Decrement();
+
+	// the bridge fell behind, skip to the newest submissions
+	FLivSubmitItem* NewerItem = nullptr;
+
+	while (NumPending.GetValue() > FMath::Max(MaxQueued, 0) && PendingItems.Dequeue(NewerItem))
+	{
+		NumPending.Decrement();
+		Done(Item, true);
+		Item = NewerItem;
+	}
+
+	return Item;
+}
+
+void FLivSubmitQueue::Done(FLivSubmitItem* Item, bool bDropped)
+{
+	if (bDropped)
+	{
+		NumDropped.Increment();
+	}
+
+	DoneItems.Enqueue(Item);
+}
+
+FLivSubmitItem* FLivSubmitQueue::DequeueDone()
+{
+	FLivSubmitItem* Item = nullptr;
+	return DoneItems.Dequeue(Item) ? Item : nullptr;
+}
+
+void FLivSubmitQueue::CancelPending()
+{
+	FLivSubmitItem* Item = nullptr;
+
+	while (PendingItems.Dequeue(Item))
+	{
+		DoneItems.Enqueue(Item);
+	}
+
+	NumPending.Reset();
+}
+
+FLivSubmitThread& FLivSubmitThread::Get()
+{
+	static FLivSubmitThread Instance;
+	return Instance;
+}
+
+bool FLivSubmitThread::IsEnabled()
+{
+	return CVarLivSubmitThread.GetValueOnRenderThread();
+}
+
+FLivSubmitThread::FLivSubmitThread()
+	: Thread(nullptr)
+	, WakeEvent(nullptr)
+	, bStopping(false)
+{
+}
+
+bool FLivSubmitThread::Start_RenderThread()
+{
+	check(IsInRenderingThread());
+
+	if (Thread)
+	{
+		return true;
+	}
+
+	bStopping = false;
+
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("LivSubmit"), 0, TPri_AboveNormal);
+
+	if (!Thread)
+	{
+		UE_LOG(LogLivSubmitThread, Warning, TEXT("Failed to create LIV submit thread, submitting from the submit pass."));
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+		return false;
+	}
+
+	// release finished items every frame, not only when the next one is queued
+	BeginFrameHandle = FCoreDelegates::OnBeginFrameRT.AddRaw(this, &FLivSubmitThread::ReleaseItems_RenderThread);
+
+	UE_LOG(LogLivSubmitThread, Log, TEXT("Submitting to LIV on a background thread."));
+	return true;
+}
+
+void FLivSubmitThread::Shutdown()
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	Thread->Kill(true);
+	delete Thread;
+	Thread = nullptr;
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+
+	FCoreDelegates::OnBeginFrameRT.Remove(BeginFrameHandle);
+	BeginFrameHandle.Reset();
+
+	// render targets are released on the render thread
+	ENQUEUE_RENDER_COMMAND(LivReleaseSubmitItems)(
+		[this](FRHICommandListImmediate& RHICmdList)
+		{
+			Queue.CancelPending();
+			ReleaseItems_RenderThread();
+		});
+
+	FlushRenderingCommands();
+}
+
+void FLivSubmitThread::Enqueue_RenderThread(TUniquePtr<FLivSubmitItem> Item)
+{
+	check(IsInRenderingThread());
+
+	ReleaseItems_RenderThread();
+
+	if (!Start_RenderThread())
+	{
+		// no thread, submit now rather than lose the frame
+		Submit(*Item);
+		return;
+	}
+
+	Queue.Enqueue(Item.Release());
+
+	WakeEvent->Trigger();
+}
+
+bool FLivSubmitThread::Init()
+{
+	return true;
+}
+
+uint32 FLivSubmitThread::Run()
+{
+	while (!bStopping)
+	{
+		FLivSubmitItem* Item = Queue.Dequeue(CVarLivSubmitThreadMaxQueued.GetValueOnAnyThread());
+
+		if (!Item)
+		{
+			WakeEvent->Wait();
+			continue;
+		}
+
+		if (WaitForFence(*Item))
+		{
+#if LIV_WITH_LATENCY_TRACKING
+			Item->LatencyRecord.GPUCompleteTime = FPlatformTime::Seconds();
+#endif
+			Submit(*Item);
+			Queue.Done(Item, false);
+		}
+		else
+		{
+			Queue.Done(Item, !bStopping);
+		}
+	}
+
+	return 0;
+}
+
+void FLivSubmitThread::Stop()
+{
+	bStopping = true;
+
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
+
+bool FLivSubmitThread::WaitForFence(const FLivSubmitItem& Item) const
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	while (!Item.Fence->Poll())
+	{
+		if (bStopping || FPlatformTime::Seconds() - StartTime > LivSubmitFenceTimeout)
+		{
+			return false;
+		}
+
+		FPlatformProcess::SleepNoStats(0.0002f);
+	}
+
+	return true;
+}
+
+void FLivSubmitThread::Submit(FLivSubmitItem& Item) const
+{
+	for (int32 Index = 0; Index < Item.NumTextures; ++Index)
+	{
+		LIV_Texture LivTexture = Item.Textures[Index];
+		FLivNativeWrapper::AddTexture(&LivTexture);
+	}
+
+	FLivNativeWrapper::Submit();
+
+#if LIV_WITH_LATENCY_TRACKING
+	Item.LatencyRecord.SubmitTime = FPlatformTime::Seconds();
+	Item.bSubmitted = true;
+#endif
+}
+
+void FLivSubmitThread::ReleaseItems_RenderThread()
+{
+	while (FLivSubmitItem* Item = Queue.DequeueDone())
+	{
+#if LIV_WITH_LATENCY_TRACKING
+		if (Item->bHasLatencyRecord && Item->bSubmitted)
+		{
+			FLivLatencyTracker::Get().OnSubmitted_RenderThread(Item->LatencyRecord);
+		}
+#endif
+
+		delete Item;
+	}
+}
+
+#endif
@@ -0,0 +1,158 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LivSdk.h"
+
+#if LIV_CAPTURE_SUPPORTED
+
+#include "LivLatencyTracker.h"
+
+#include "Containers/Queue.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "RendererInterface.h"
+#include "RHIResources.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLivSubmitThread, Log, All);
+
+/**
+ * Textures of one LIV submission and the fence the GPU signals once they are rendered.
+ */
+struct FLivSubmitItem
+{
+	static constexpr int32 MaxTextures = 3;
+
+	/**
+	 * Whether the bridge can read every texture without the game's device context,
+	 * on D3D11 that means each texture has a ShareableHandle (see FLivSubmitTextureRing).
+	 */
+	bool HasShareableHandles() const;
+
+	LIV_Texture Textures[MaxTextures];
+	int32 NumTextures = 0;
+
+	/**
+	 * Keeps the textures out of the render target pool until the item is submitted or dropped,
+	 * the submit texture ring doesn't hand out a slot while an item still references it.
+	 */
+	TArray<TRefCountPtr<IPooledRenderTarget>, TInlineAllocator<MaxTextures>> RenderTargets;
+
+	FGPUFenceRHIRef Fence;
+
+#if LIV_WITH_LATENCY_TRACKING
+	/** Timed by the submit thread, handed back to FLivLatencyTracker once the item is released. */
+	FLivLatencyRecord LatencyRecord;
+	bool bHasLatencyRecord = false;
+	bool bSubmitted = false;
+#endif
+};
+
+/**
+ * Submissions waiting for the submit thread, single producer (the render thread) and single consumer (the submit thread).
+ * Items come back through a second queue once submitted or dropped, to be released on the render thread.
+ */
+class FLivSubmitQueue
+{
+public:
+
+	/** Producer. */
+	void Enqueue(FLivSubmitItem* Item);
+
+	/**
+	 * Consumer. The next item to submit, the oldest are dropped while more than MaxQueued wait behind it.
+	 * Returns nullptr when nothing is pending.
+	 */
+	FLivSubmitItem* Dequeue(int32 MaxQueued);
+
+	/** Consumer. Hand an item back, counted as dropped if it wasn't submitted. */
+	void Done(FLivSubmitItem* Item, bool bDropped);
+
+	/** Producer. Next item handed back, nullptr if none. */
+	FLivSubmitItem* DequeueDone();
+
+	/** Producer, once the consumer has stopped. Hand back every pending item without counting it as dropped. */
+	void CancelPending();
+
+	int32 GetNumPending() const { return NumPending.GetValue(); }
+	int32 GetNumDropped() const { return NumDropped.GetValue(); }
+
+private:
+
+	FThreadSafeCounter NumPending;
+	FThreadSafeCounter NumDropped;
+
+	TQueue<FLivSubmitItem*, EQueueMode::Spsc> PendingItems;
+	TQueue<FLivSubmitItem*, EQueueMode::Spsc> DoneItems;
+};
+
+/**
+ * Calls LIV_AddTexture/LIV_Submit on a thread of its own so a stall in the bridge never holds up the render thread.
+ *
+ * The submit pass queues an item (single producer, the render thread) and the submit thread waits for its fence
+ * before handing the textures to the bridge. When the bridge falls behind the oldest waiting items are dropped,
+ * only the newest submission matters to LIV. Items go back to the render thread to be released,
+ * at the start of every render frame so nothing is held once capturing stops.
+ *
+ * Enable with Liv.SubmitThread 1. The bridge copies through the D3D11 immediate context when a texture
+ * has no ShareableHandle, which is only safe on the thread the RHI submits from, so items are only
+ * handed to the thread when every texture is shareable (the submit texture ring, Liv.SubmitTextureRing)
+ * and are submitted from the submit pass otherwise.
+ *
+ * Shut down explicitly from module shutdown, the singleton is not torn down on static destruction.
+ */
+class FLivSubmitThread : public FRunnable
+{
+public:
+
+	static FLivSubmitThread& Get();
+
+	static bool IsEnabled();
+
+	void Shutdown();
+
+	bool IsRunning() const { return Thread != nullptr; }
+
+	/**
+	 * Start the thread if needed, returns false if it couldn't be created. Render thread only.
+	 */
+	bool Start_RenderThread();
+
+	/**
+	 * Queue a submission, starts the thread if needed. Render thread only.
+	 */
+	void Enqueue_RenderThread(TUniquePtr<FLivSubmitItem> Item);
+
+	/**
+	 * Release the items the submit thread is done with. Render thread only.
+	 */
+	void ReleaseItems_RenderThread();
+
+	/** Submissions dropped because the bridge fell behind or the GPU never signalled. */
+	int32 GetNumDropped() const { return Queue.GetNumDropped(); }
+
+	// FRunnable
+
+	virtual bool Init() override;
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+
+	FLivSubmitThread();
+
+	/** Wait for the GPU to finish an item, returns false on time out or when stopping. */
+	bool WaitForFence(const FLivSubmitItem& Item) const;
+
+	void Submit(FLivSubmitItem& Item) const;
+
+	FRunnableThread* Thread;
+	FEvent* WakeEvent;
+	FDelegateHandle BeginFrameHandle;
+	FThreadSafeBool bStopping;
+
+	FLivSubmitQueue Queue;
+};
+
+#endif
@@ -20,6 +20,7 @@ ULivWorldSubsystem::ULivWorldSubsystem()
 	: Super()
 	, CameraRoot(nullptr)
 	, CaptureComponent(nullptr)
+	, LastCaptureDuration(0.0)
 {
 }
 
@@ -124,8 +125,10 @@ USceneComponent* ULivWorldSubsystem::GetPlayerCameraParent() const
 	return nullptr;
 }
 
-void ULivWorldSubsystem::Capture(FLivCaptureContext& Context)
+void ULivWorldSubsystem::Capture(const FLivCaptureContext& Context)
 {
+	const double CaptureStartTime = FPlatformTime::Seconds();
+
 	// check we have our resources - if world changed whilst still capturing we're in a new
 	// system and have to create the resources again
 	if(CaptureComponent == nullptr || CameraRoot == nullptr)
@@ -157,6 +160,8 @@ void ULivWorldSubsystem::Capture(FLivCaptureContext& Context)
 	}
 	
 	CaptureComponent->Capture(Context);
+
+	LastCaptureDuration = FPlatformTime::Seconds() - CaptureStartTime;
 }
 
 void ULivWorldSubsystem::CreateCaptureResources()
@@ -0,0 +1,280 @@
+// Copyright 2021 LIV Inc. - MIT License
+#include "LivLoopbackBridge.h"
+
+#if LIV_WITH_LOOPBACK && WITH_DEV_AUTOMATION_TESTS
+
+#include "LivCaptureBase.h"
+#include "LivLatencyTracker.h"
+#include "LivLocalPlayerSubsystem.h"
+#include "LivPassTimings.h"
+#include "LivPluginSettings.h"
+#include "LivWorldSubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "RHI.h"
+#include "Tests/AutomationCommon.h"
+#include "UObject/UObjectIterator.h"
+
+/**
+ * Capture benchmarks, run in a game (not editor) with the loopback bridge, e.g.
+ * -game -LivLoopback [-LivReplay=<trace>] -ExecCmds="Automation RunTests LIV.Perf; Quit"
+ * Writes per-frame samples to Saved/Liv/Perf/<CaptureMethod>.csv and a line per method to Saved/Liv/Perf/Summary.csv.
+ * Whole frame timings are written next to the time spent in LIV's own passes (FLivPassTimings), the same passes
+ * show up as "LIV Passes" in stat GPU and as the LivPasses category of a csvprofile capture.
+ */
+static constexpr auto GLivPerfAutomationFlags = EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter;
+
+static const TCHAR* LivPerfMap = TEXT("/LIV/Sample/L_LivSample");
+static constexpr int32 LivPerfWarmupFrames = 60;
+static constexpr int32 LivPerfSampleFrames = 600;
+
+struct FLivPerfSample
+{
+	float GameThreadMs;
+	float RenderThreadMs;
+	float GPUMs;
+	float LivCaptureMs;
+	float LivPassRenderThreadMs;
+	float LivPassGPUMs;
+	float LivLatencyMs;
+	uint64 Submissions;
+};
+
+static UWorld* GetLivPerfWorld()
+{
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		if ((Context.WorldType == EWorldType::Game || Context.WorldType == EWorldType::PIE) && Context.World())
+		{
+			return Context.World();
+		}
+	}
+
+	return nullptr;
+}
+
+static float GetLivPerfPercentile(TArray<float> Values, float Percentile)
+{
+	if (Values.Num() == 0)
+	{
+		return 0.0f;
+	}
+
+	Values.Sort();
+	const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * Values.Num()) - 1, 0, Values.Num() - 1);
+	return Values[Index];
+}
+
+/**
+ * Switch capture method and restart capture so the new method is created.
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FLivPerfSetCaptureMethodCommand, TSubclassOf<ULivCaptureBase>, CaptureClass);
+
+bool FLivPerfSetCaptureMethodCommand::Update()
+{
+	GetMutableDefault<ULivPluginSettings>()->CaptureMethod = CaptureClass;
+
+	// restart frame ids, replay is indexed by frame id (and timed replay restarts at the first frame)
+	// so this rewinds it and every method sees the same input frames
+	FLivLoopbackBridge::Get().Reset();
+
+	for (TObjectIterator<ULivLocalPlayerSubsystem> It; It; ++It)
+	{
+		It->ResetCapture();
+	}
+
+	return true;
+}
+
+/**
+ * Put back the capture method the settings had before the benchmark and restart capture with it.
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FLivPerfRestoreCaptureMethodCommand, TSubclassOf<ULivCaptureBase>, CaptureClass);
+
+bool FLivPerfRestoreCaptureMethodCommand::Update()
+{
+	GetMutableDefault<ULivPluginSettings>()->CaptureMethod = CaptureClass;
+
+	for (TObjectIterator<ULivLocalPlayerSubsystem> It; It; ++It)
+	{
+		It->ResetCapture();
+	}
+
+	return true;
+}
+
+/**
+ * Sample frame timings while the capture method runs, then write them out.
+ */
+class FLivPerfSampleCommand : public IAutomationLatentCommand
+{
+public:
+
+	FLivPerfSampleCommand(FAutomationTestBase* InTest, const FString& InCaptureMethodName)
+		: Test(InTest)
+		, CaptureMethodName(InCaptureMethodName)
+		, FramesSeen(0)
+		, LastNumSubmissions(0)
+	{
+		Samples.Reserve(LivPerfSampleFrames);
+	}
+
+	virtual bool Update() override
+	{
+		++FramesSeen;
+
+		const uint64 NumSubmissions = FLivLoopbackBridge::Get().GetNumSubmissions();
+
+		if (FramesSeen > LivPerfWarmupFrames)
+		{
+			const UWorld* World = GetLivPerfWorld();
+			const ULivWorldSubsystem* WorldSubsystem = World ? World->GetSubsystem<ULivWorldSubsystem>() : nullptr;
+
+			FLivPerfSample& Sample = Samples.AddDefaulted_GetRef();
+			Sample.GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+			Sample.RenderThreadMs = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+			Sample.GPUMs = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+			Sample.LivCaptureMs = WorldSubsystem ? WorldSubsystem->GetLastCaptureDuration() * 1000.0 : 0.0f;
+			Sample.LivPassRenderThreadMs = 0.0f;
+			Sample.LivPassGPUMs = 0.0f;
+#if LIV_CAPTURE_SUPPORTED
+			FLivPassTimings::Get().GetLatestFrame(Sample.LivPassRenderThreadMs, Sample.LivPassGPUMs);
+#endif
+			Sample.LivLatencyMs = 0.0f;
+#if LIV_WITH_LATENCY_TRACKING
+			FLivLatencyRecord LatencyRecord;
+			if (FLivLatencyTracker::Get().GetLatestRecord(LatencyRecord))
+			{
+				Sample.LivLatencyMs = (LatencyRecord.GPUCompleteTime - LatencyRecord.InputFrameTime) * 1000.0;
+			}
+#endif
+			Sample.Submissions = NumSubmissions - LastNumSubmissions;
+		}
+
+		LastNumSubmissions = NumSubmissions;
+
+		if (Samples.Num() < LivPerfSampleFrames)
+		{
+			return false;
+		}
+
+		WriteResults();
+		return true;
+	}
+
+private:
+
+	void WriteResults() const
+	{
+		const FString PerfDirectory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Liv"), TEXT("Perf"));
+
+		FString FramesCsv = TEXT("Frame,GameThreadMs,RenderThreadMs,GPUMs,LivCaptureGameThreadMs,LivPassRenderThreadMs,LivPassGPUMs,LivLatencyMs,Submissions\n");
+
+		TArray<float> GameThread, RenderThread, GPU, LivCapture, LivPassRenderThread, LivPassGPU, LivLatency;
+		uint64 TotalSubmissions = 0;
+
+		for (int32 Idx = 0; Idx < Samples.Num(); ++Idx)
+		{
+			const FLivPerfSample& Sample = Samples[Idx];
+			FramesCsv += FString::Printf(TEXT("%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%llu\n"), Idx, Sample.GameThreadMs, Sample.RenderThreadMs, Sample.GPUMs, Sample.LivCaptureMs, Sample.LivPassRenderThreadMs, Sample.LivPassGPUMs, Sample.LivLatencyMs, Sample.Submissions);
+
+			GameThread.Add(Sample.GameThreadMs);
+			RenderThread.Add(Sample.RenderThreadMs);
+			GPU.Add(Sample.GPUMs);
+			LivCapture.Add(Sample.LivCaptureMs);
+			LivPassRenderThread.Add(Sample.LivPassRenderThreadMs);
+			LivPassGPU.Add(Sample.LivPassGPUMs);
+			LivLatency.Add(Sample.LivLatencyMs);
+			TotalSubmissions += Sample.Submissions;
+		}
+
+		FFileHelper::SaveStringToFile(FramesCsv, *FPaths::Combine(PerfDirectory, CaptureMethodName + TEXT(".csv")));
+
+		const FString SummaryPath = FPaths::Combine(PerfDirectory, TEXT("Summary.csv"));
+		FString SummaryCsv;
+
+		if (!FPaths::FileExists(SummaryPath))
+		{
+			SummaryCsv += TEXT("CaptureMethod,Frames,Submissions,GameThreadMedianMs,GameThreadP95Ms,RenderThreadMedianMs,RenderThreadP95Ms,GPUMedianMs,GPUP95Ms,LivCaptureMedianMs,LivCaptureP95Ms,LivPassRenderThreadMedianMs,LivPassRenderThreadP95Ms,LivPassGPUMedianMs,LivPassGPUP95Ms,LivLatencyMedianMs,LivLatencyP95Ms\n");
+		}
+
+		SummaryCsv += FString::Printf(TEXT("%s,%d,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n"),
+			*CaptureMethodName,
+			Samples.Num(),
+			TotalSubmissions,
+			GetLivPerfPercentile(GameThread, 0.5f), GetLivPerfPercentile(GameThread, 0.95f),
+			GetLivPerfPercentile(RenderThread, 0.5f), GetLivPerfPercentile(RenderThread, 0.95f),
+			GetLivPerfPercentile(GPU, 0.5f), GetLivPerfPercentile(GPU, 0.95f),
+			GetLivPerfPercentile(LivCapture, 0.5f), GetLivPerfPercentile(LivCapture, 0.95f),
+			GetLivPerfPercentile(LivPassRenderThread, 0.5f), GetLivPerfPercentile(LivPassRenderThread, 0.95f),
+			GetLivPerfPercentile(LivPassGPU, 0.5f), GetLivPerfPercentile(LivPassGPU, 0.95f),
+			GetLivPerfPercentile(LivLatency, 0.5f), GetLivPerfPercentile(LivLatency, 0.95f));
+
+		FFileHelper::SaveStringToFile(SummaryCsv, *SummaryPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+		// the method ran if the bridge received frames
+		Test->TestTrue(FString::Printf(TEXT("%s submitted frames"), *CaptureMethodName), TotalSubmissions > 0);
+	}
+
+	FAutomationTestBase* Test;
+	FString CaptureMethodName;
+	int32 FramesSeen;
+	uint64 LastNumSubmissions;
+	TArray<FLivPerfSample> Samples;
+};
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FLivPerfCaptureMethods, "LIV.Perf.Capture Method", GLivPerfAutomationFlags)
+
+void FLivPerfCaptureMethods::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const TSubclassOf<ULivCaptureBase>& CaptureClass : ULivCaptureBase::GetCaptureClasses())
+	{
+		OutBeautifiedNames.Add(CaptureClass->GetName());
+		OutTestCommands.Add(CaptureClass->GetName());
+	}
+}
+
+/**
+ * Benchmark one capture method in the sample level.
+ */
+bool FLivPerfCaptureMethods::RunTest(const FString& Parameters)
+{
+	if (!FLivLoopbackBridge::IsRequested())
+	{
+		AddWarning(TEXT("LIV perf tests need the loopback bridge (-LivLoopback or -LivReplay=<trace>), skipping."));
+		return true;
+	}
+
+	TSubclassOf<ULivCaptureBase> CaptureClass;
+
+	for (const TSubclassOf<ULivCaptureBase>& Class : ULivCaptureBase::GetCaptureClasses())
+	{
+		if (Class->GetName() == Parameters)
+		{
+			CaptureClass = Class;
+		}
+	}
+
+	if (!CaptureClass)
+	{
+		AddError(FString::Printf(TEXT("Unknown capture method: %s"), *Parameters));
+		return false;
+	}
+
+	const TSubclassOf<ULivCaptureBase> PreviousCaptureClass = GetDefault<ULivPluginSettings>()->CaptureMethod;
+
+	AutomationOpenMap(LivPerfMap);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitForMapToLoadCommand());
+	ADD_LATENT_AUTOMATION_COMMAND(FLivPerfSetCaptureMethodCommand(CaptureClass));
+	ADD_LATENT_AUTOMATION_COMMAND(FLivPerfSampleCommand(this, Parameters));
+	ADD_LATENT_AUTOMATION_COMMAND(FLivPerfRestoreCaptureMethodCommand(PreviousCaptureClass));
+
+	return true;
+}
+
+#endif
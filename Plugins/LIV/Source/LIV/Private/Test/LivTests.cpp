@@ -1,15 +1,30 @@
 // Copyright 2021 LIV Inc. - MIT License
 #include "LivTests.h"
-
-#if PLATFORM_WINDOWS
-
-#include "Windows/AllowWindowsPlatformTypes.h"
-#include "LIV.h"
-#include "Windows/HideWindowsPlatformTypes.h"
-
 #include "LivConversions.h"
 
+#if LIV_CAPTURE_SUPPORTED
+
+#include "LivBackgroundReuse.h"
+#include "LivCaptureAnalyticClipPlane.h"
+#include "LivCaptureContext.h"
+#include "LivCaptureScheduler.h"
+#include "LivDynamicResolution.h"
+#include "LivForegroundCulling.h"
+#include "LivForegroundRegion.h"
+#include "LivInputFrameTrace.h"
+#include "LivLoopbackBridge.h"
+#include "LivNativeWrapper.h"
+#include "LivPosePredictor.h"
+#include "LivRenderTargetPool.h"
+#include "LivSubmitThread.h"
+
+#include "Components/StaticMeshComponent.h"
+#include "ConvexVolume.h"
 #include "EngineGlobals.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "SceneManagement.h"
 #include "Tests/AutomationCommon.h"
 
 #if WITH_DEV_AUTOMATION_TESTS
@@ -136,6 +151,70 @@ bool FLivQuaternionConversion::RunTest(const FString& Parameters)
 	return true;
 }
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivBatchConversion, "LIV.Math.Batch Conversion", GAutomationFlags)
+
+/**
+ * Test batch conversion matches converting one at a time and round trips.
+ */
+bool FLivBatchConversion::RunTest(const FString& Parameters)
+{
+	constexpr int32 Num = 7;
+
+	TArray<FMatrix> UnrealMatrices;
+	TArray<FVector> UnrealLocations;
+	TArray<FQuat> UnrealQuaternions;
+
+	for (int32 Idx{ 0 }; Idx < Num; ++Idx)
+	{
+		const FTransform Transform(FRotator(10.0f * Idx, -25.0f * Idx, 5.0f + Idx), FVector(100.0f * Idx, -3.0f, 42.0f), FVector(1.0f + Idx));
+		UnrealMatrices.Add(Transform.ToMatrixWithScale());
+		UnrealLocations.Add(Transform.GetLocation());
+		UnrealQuaternions.Add(Transform.GetRotation());
+	}
+
+	TArray<LIV_Matrix4x4> LivMatrices;
+	TArray<LIV_Vector3> LivLocations;
+	TArray<LIV_Quaternion> LivQuaternions;
+	LivMatrices.SetNumUninitialized(Num);
+	LivLocations.SetNumUninitialized(Num);
+	LivQuaternions.SetNumUninitialized(Num);
+
+	ConvertArray<FMatrix, LIV_Matrix4x4>(UnrealMatrices, LivMatrices);
+	ConvertPositionArray<FVector, LIV_Vector3>(UnrealLocations, LivLocations);
+	ConvertArray<FQuat, LIV_Quaternion>(UnrealQuaternions, LivQuaternions);
+
+	TArray<FMatrix> ConvertedBackMatrices;
+	TArray<FVector> ConvertedBackLocations;
+	TArray<FQuat> ConvertedBackQuaternions;
+	ConvertedBackMatrices.SetNumUninitialized(Num);
+	ConvertedBackLocations.SetNumUninitialized(Num);
+	ConvertedBackQuaternions.SetNumUninitialized(Num);
+
+	ConvertArray<LIV_Matrix4x4, FMatrix>(LivMatrices, ConvertedBackMatrices);
+	ConvertPositionArray<LIV_Vector3, FVector>(LivLocations, ConvertedBackLocations);
+	ConvertArray<LIV_Quaternion, FQuat>(LivQuaternions, ConvertedBackQuaternions);
+
+	for (int32 Idx{ 0 }; Idx < Num; ++Idx)
+	{
+		const LIV_Matrix4x4 LivMatrix = Convert<FMatrix, LIV_Matrix4x4>(UnrealMatrices[Idx]);
+		for (int32 Element{ 0 }; Element < 16; ++Element)
+		{
+			TestEqual<float>(FString::Printf(TEXT("Matrix %d [%d]"), Idx, Element), LivMatrices[Idx].data[Element], LivMatrix.data[Element]);
+		}
+
+		const LIV_Vector3 LivLocation = ConvertPosition<FVector, LIV_Vector3>(UnrealLocations[Idx]);
+		TestEqual<float>(FString::Printf(TEXT("Location %d X"), Idx), LivLocations[Idx].x, LivLocation.x);
+		TestEqual<float>(FString::Printf(TEXT("Location %d Y"), Idx), LivLocations[Idx].y, LivLocation.y);
+		TestEqual<float>(FString::Printf(TEXT("Location %d Z"), Idx), LivLocations[Idx].z, LivLocation.z);
+
+		TestTrue(FString::Printf(TEXT("Matrix %d round trip"), Idx), ConvertedBackMatrices[Idx].Equals(UnrealMatrices[Idx], KINDA_SMALL_NUMBER * 100.0f));
+		TestTrue(FString::Printf(TEXT("Location %d round trip"), Idx), ConvertedBackLocations[Idx].Equals(UnrealLocations[Idx], KINDA_SMALL_NUMBER * 100.0f));
+		TestTrue(FString::Printf(TEXT("Quaternion %d round trip"), Idx), ConvertedBackQuaternions[Idx].Equals(UnrealQuaternions[Idx]));
+	}
+
+	return true;
+}
+
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFieldOfViewConversion, "LIV.Math.FOV Conversion", GAutomationFlags)
 
 /**
@@ -169,5 +248,706 @@ bool FFieldOfViewConversion::RunTest(const FString& Parameters)
 	return true;
 }
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivPosePrediction, "LIV.Math.Pose Prediction", GAutomationFlags)
+
+/**
+ * Test the camera pose is extrapolated at constant velocity and not past the prediction limit.
+ */
+bool FLivPosePrediction::RunTest(const FString& Parameters)
+{
+	FLivPosePredictor Predictor;
+
+	FVector Location;
+	FQuat Rotation;
+
+	TestFalse(TEXT("No prediction without samples"), Predictor.Predict(0.0, Location, Rotation));
+
+	// 100 cm/s along X and 90 deg/s around Z, sampled at 100 Hz
+	const FVector Velocity(100.0f, 0.0f, 0.0f);
+	const float AngularVelocity = HALF_PI;
+
+	for (int32 Idx = 0; Idx <= 5; ++Idx)
+	{
+		const double Time = Idx * 0.01;
+		Predictor.AddSample(Time, Velocity * Time, FQuat(FVector::UpVector, AngularVelocity * Time));
+	}
+
+	TestTrue(TEXT("Prediction with samples"), Predictor.Predict(0.07, Location, Rotation));
+	TestTrue(TEXT("Predicted location"), Location.Equals(Velocity * 0.07, KINDA_SMALL_NUMBER * 100.0f));
+	TestTrue(TEXT("Predicted rotation"), Rotation.Equals(FQuat(FVector::UpVector, AngularVelocity * 0.07f), 1.e-4f));
+
+	Predictor.MaxPredictionTime = 0.01;
+	Predictor.Predict(1.0, Location, Rotation);
+	TestTrue(TEXT("Prediction clamped"), Location.Equals(Velocity * 0.06, KINDA_SMALL_NUMBER * 100.0f));
+
+	// a camera that stops stops being extrapolated once the moving samples leave the history window
+	Predictor.MaxPredictionTime = 0.1;
+	for (int32 Idx = 1; Idx <= 20; ++Idx)
+	{
+		Predictor.RepeatNewestSample(0.05 + Idx * 0.01);
+	}
+
+	Predictor.Predict(0.3, Location, Rotation);
+	TestTrue(TEXT("Stationary camera not extrapolated"), Location.Equals(Velocity * 0.05, KINDA_SMALL_NUMBER * 100.0f));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivCaptureScheduling, "LIV.Capture Scheduler", GAutomationFlags)
+
+/**
+ * Test captures run at the target rate, evenly spread over game frames and without catching up after a hitch.
+ */
+bool FLivCaptureScheduling::RunTest(const FString& Parameters)
+{
+	const double FrameTime = 1.0 / 90.0;
+
+	struct FRateCase
+	{
+		double TargetRate;
+		int32 ExpectedCaptures;
+		int32 MaxFramesBetween;
+	};
+
+	// one second at 90 Hz
+	const FRateCase Cases[] = { { 0.0, 90, 1 }, { 30.0, 30, 3 }, { 45.0, 45, 2 }, { 60.0, 60, 2 }, { 120.0, 90, 1 } };
+
+	for (const FRateCase& Case : Cases)
+	{
+		FLivCaptureScheduler Scheduler;
+
+		int32 NumCaptures = 0;
+		int32 FramesSinceCapture = 0;
+		int32 MaxFramesBetween = 0;
+
+		for (int32 Frame = 0; Frame < 90; ++Frame)
+		{
+			++FramesSinceCapture;
+
+			if (Scheduler.ShouldCapture(FrameTime, Case.TargetRate))
+			{
+				MaxFramesBetween = FMath::Max(MaxFramesBetween, FramesSinceCapture);
+				FramesSinceCapture = 0;
+				++NumCaptures;
+			}
+		}
+
+		TestTrue(FString::Printf(TEXT("Captures at %.0f fps"), Case.TargetRate), FMath::Abs(NumCaptures - Case.ExpectedCaptures) <= 1);
+		TestTrue(FString::Printf(TEXT("Captures evenly spread at %.0f fps"), Case.TargetRate), MaxFramesBetween <= Case.MaxFramesBetween);
+	}
+
+	FLivCaptureScheduler Scheduler;
+	Scheduler.ShouldCapture(FrameTime, 30.0);
+
+	TestTrue(TEXT("Capture after a hitch"), Scheduler.ShouldCapture(1.0, 30.0));
+	TestFalse(TEXT("No catch up after a hitch"), Scheduler.ShouldCapture(FrameTime, 30.0));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivDynamicResolutionTest, "LIV.Dynamic Resolution", GAutomationFlags)
+
+/**
+ * Test the requested resolution steps down under sustained GPU load, back up with headroom, and holds in between.
+ */
+bool FLivDynamicResolutionTest::RunTest(const FString& Parameters)
+{
+	const double FrameTime = 1.0 / 90.0;
+	const float Budget = 11.1f;
+
+	FLivDynamicResolution DynamicResolution;
+
+	auto RunFor = [&DynamicResolution, FrameTime, Budget](double Seconds, float GPUFrameTimeMs)
+	{
+		int32 NumChanges = 0;
+
+		for (double Time = 0.0; Time < Seconds; Time += FrameTime)
+		{
+			NumChanges += DynamicResolution.Update(FrameTime, GPUFrameTimeMs, Budget) ? 1 : 0;
+		}
+
+		return NumChanges;
+	};
+
+	TestEqual(TEXT("A spike doesn't lower the resolution"), RunFor(0.2, 14.0f), 0);
+	TestEqual(TEXT("Between the thresholds holds the resolution"), RunFor(10.0, 9.5f), 0);
+
+	TestEqual(TEXT("Sustained load lowers the resolution once per cooldown"), RunFor(1.0, 14.0f), 1);
+	TestEqual(TEXT("Sustained load lowers to the minimum"), RunFor(10.0, 14.0f), 1);
+	TestEqual(TEXT("Minimum resolution"), DynamicResolution.GetResolution(FIntPoint(1920, 1080)), FIntPoint(1280, 720));
+
+	TestEqual(TEXT("Between the thresholds holds the minimum"), RunFor(10.0, 9.5f), 0);
+	TestEqual(TEXT("Headroom raises the resolution back"), RunFor(20.0, 5.0f), 2);
+	TestEqual(TEXT("Full resolution"), DynamicResolution.GetResolution(FIntPoint(1920, 1080)), FIntPoint(1920, 1080));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivRenderTargetPoolTest, "LIV.Render Target Pool", GAutomationFlags)
+
+/**
+ * Test released render targets are leased again for the same extent and format, and only then.
+ */
+bool FLivRenderTargetPoolTest::RunTest(const FString& Parameters)
+{
+	ULivRenderTargetPool* Pool = NewObject<ULivRenderTargetPool>(GetTransientPackage());
+
+	UTextureRenderTarget2D* Background = Pool->Acquire(640, 360, TEXT("Background"), RTF_RGBA8_SRGB, false, FLinearColor::Black, 0.0f);
+	UTextureRenderTarget2D* Foreground = Pool->Acquire(640, 360, TEXT("Foreground"), RTF_RGBA8_SRGB, false, FLinearColor::Black, 0.0f);
+
+	TestNotEqual(TEXT("Leased targets are distinct"), Background, Foreground);
+
+	Pool->Release(Background);
+	Pool->Release(Foreground);
+
+	TestEqual(TEXT("Released targets idle"), Pool->GetNumIdle(), 2);
+	TestNull(TEXT("No target for another extent"), Pool->Acquire(0, 360, TEXT("Empty"), RTF_RGBA8_SRGB, false, FLinearColor::Black, 0.0f));
+
+	UTextureRenderTarget2D* Other = Pool->Acquire(640, 360, TEXT("Depth"), RTF_R32f, false, FLinearColor::Black, 0.0f);
+	TestTrue(TEXT("Another format is created"), Other != Background && Other != Foreground);
+
+	UTextureRenderTarget2D* Reused = Pool->Acquire(640, 360, TEXT("Background"), RTF_RGBA8_SRGB, false, FLinearColor::White, 0.0f);
+	TestTrue(TEXT("Same extent and format is reused"), Reused == Background || Reused == Foreground);
+	TestEqual(TEXT("Reused target takes the new clear color"), Reused->ClearColor, FLinearColor::White);
+	TestEqual(TEXT("Reused target leaves the pool"), Pool->GetNumIdle(), 1);
+
+	Pool->Release(Reused);
+	Pool->Release(Other);
+	Pool->Empty();
+
+	TestEqual(TEXT("Emptied"), Pool->GetNumIdle(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivSubmitQueueTest, "LIV.Submit Queue", GAutomationFlags)
+
+/**
+ * Test the submit queue drops the oldest submissions when more are waiting than allowed, and hands every item back.
+ */
+bool FLivSubmitQueueTest::RunTest(const FString& Parameters)
+{
+	FLivSubmitQueue Queue;
+	TArray<FLivSubmitItem*> Items;
+
+	for (int32 Index = 0; Index < 4; ++Index)
+	{
+		Items.Add(new FLivSubmitItem());
+		Queue.Enqueue(Items.Last());
+	}
+
+	FLivSubmitItem* Item = Queue.Dequeue(1);
+
+	TestEqual(TEXT("Skips to the newest allowed to wait"), Item, Items[2]);
+	TestEqual(TEXT("Oldest dropped"), Queue.GetNumDropped(), 2);
+	TestEqual(TEXT("One left waiting"), Queue.GetNumPending(), 1);
+
+	Queue.Done(Item, false);
+	Item = Queue.Dequeue(1);
+
+	TestEqual(TEXT("Newest submitted next"), Item, Items[3]);
+
+	// the GPU never signalled
+	Queue.Done(Item, true);
+
+	TestNull(TEXT("Nothing left"), Queue.Dequeue(1));
+	TestEqual(TEXT("Timed out counts as dropped"), Queue.GetNumDropped(), 3);
+
+	int32 NumDone = 0;
+
+	while (FLivSubmitItem* DoneItem = Queue.DequeueDone())
+	{
+		TestTrue(TEXT("Handed back in order"), DoneItem == Items[NumDone]);
+		delete DoneItem;
+		++NumDone;
+	}
+
+	TestEqual(TEXT("Every item handed back"), NumDone, Items.Num());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivAnalyticClipPlaneTest, "LIV.Math.Analytic Clip Plane", GAutomationFlags)
+
+/**
+ * Test the analytic clip planes face the camera whichever way the LIV clip plane points.
+ */
+bool FLivAnalyticClipPlaneTest::RunTest(const FString& Parameters)
+{
+	const FVector VROrigin(1000.0f, 0.0f, 0.0f);
+	const FTransform VROriginTransform(VROrigin);
+
+	// clip plane half way between the player and the camera
+	const FVector CameraLocation = VROrigin + FVector(200.0f, 0.0f, 0.0f);
+	const FVector PlayerLocation = VROrigin;
+	const FVector InFrontOfPlayer = VROrigin + FVector(150.0f, 0.0f, 0.0f);
+
+	const FMatrix TowardsCamera = FTranslationMatrix(FVector(100.0f, 0.0f, 0.0f));
+	const FMatrix AwayFromCamera = FRotationMatrix(FRotator(0.0f, 180.0f, 0.0f)) * FTranslationMatrix(FVector(100.0f, 0.0f, 0.0f));
+
+	for (const FMatrix& ClipPlaneMatrix : { TowardsCamera, AwayFromCamera })
+	{
+		const FPlane Plane = ULivCaptureAnalyticClipPlane::MakeCameraSidePlane(ClipPlaneMatrix, VROriginTransform, CameraLocation);
+
+		TestTrue(TEXT("Camera on positive side"), Plane.PlaneDot(CameraLocation) > 0.0f);
+		TestTrue(TEXT("In front of player is foreground"), Plane.PlaneDot(InFrontOfPlayer) > 0.0f);
+		TestTrue(TEXT("Player is background"), Plane.PlaneDot(PlayerLocation) < 0.0f);
+		TestTrue(TEXT("Plane passes through clip plane position"), FMath::IsNearlyZero(Plane.PlaneDot(VROrigin + FVector(100.0f, 50.0f, 20.0f)), 0.01f));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivBackgroundReuseTest, "LIV.Capture.Background Reuse", GAutomationFlags)
+
+/**
+ * Test the background is only rendered again when the camera changes, the scene is dirty or it expires.
+ */
+bool FLivBackgroundReuseTest::RunTest(const FString& Parameters)
+{
+	FLivBackgroundReuse BackgroundReuse;
+	BackgroundReuse.MaxAge = 1.0;
+
+	const FTransform Camera(FRotator(0.0f, 45.0f, 0.0f), FVector(100.0f, 0.0f, 150.0f));
+	const FIntPoint Resolution(1920, 1080);
+
+	TestTrue(TEXT("First capture renders"), BackgroundReuse.ShouldRecapture(Camera, 90.0f, Resolution, false, 0.0));
+	TestFalse(TEXT("Static camera reuses"), BackgroundReuse.ShouldRecapture(Camera, 90.0f, Resolution, false, 0.1));
+	TestFalse(TEXT("Tracking noise reuses"), BackgroundReuse.ShouldRecapture(FTransform(Camera.GetRotation(), Camera.GetLocation() + FVector(0.01f, 0.0f, 0.0f)), 90.0f, Resolution, false, 0.2));
+	TestTrue(TEXT("Dirty scene renders"), BackgroundReuse.ShouldRecapture(Camera, 90.0f, Resolution, true, 0.3));
+	TestTrue(TEXT("Moved camera renders"), BackgroundReuse.ShouldRecapture(FTransform(Camera.GetRotation(), Camera.GetLocation() + FVector(0.0f, 5.0f, 0.0f)), 90.0f, Resolution, false, 0.4));
+	TestTrue(TEXT("FOV change renders"), BackgroundReuse.ShouldRecapture(FTransform(Camera.GetRotation(), Camera.GetLocation() + FVector(0.0f, 5.0f, 0.0f)), 80.0f, Resolution, false, 0.5));
+	TestTrue(TEXT("Resolution change renders"), BackgroundReuse.ShouldRecapture(FTransform(Camera.GetRotation(), Camera.GetLocation() + FVector(0.0f, 5.0f, 0.0f)), 80.0f, FIntPoint(1280, 720), false, 0.6));
+	TestFalse(TEXT("Unchanged before max age reuses"), BackgroundReuse.ShouldRecapture(FTransform(Camera.GetRotation(), Camera.GetLocation() + FVector(0.0f, 5.0f, 0.0f)), 80.0f, FIntPoint(1280, 720), false, 1.5));
+	TestTrue(TEXT("Expired renders"), BackgroundReuse.ShouldRecapture(FTransform(Camera.GetRotation(), Camera.GetLocation() + FVector(0.0f, 5.0f, 0.0f)), 80.0f, FIntPoint(1280, 720), false, 1.6));
+
+	BackgroundReuse.Reset();
+	TestTrue(TEXT("Reset renders"), BackgroundReuse.ShouldRecapture(Camera, 90.0f, Resolution, false, 1.7));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivForegroundRegionTest, "LIV.Math.Foreground Region", GAutomationFlags)
+
+/**
+ * Test the foreground region covers the player on the camera side of the clip plane and cropping keeps pixels in place.
+ */
+bool FLivForegroundRegionTest::RunTest(const FString& Parameters)
+{
+	const FIntPoint Resolution(1920, 1080);
+
+	// camera at the origin looking down +X
+	const FMatrix ViewMatrix(
+		FPlane(0, 0, 1, 0),
+		FPlane(1, 0, 0, 0),
+		FPlane(0, 1, 0, 0),
+		FPlane(0, 0, 0, 1));
+
+	const FMatrix ProjectionMatrix = FReversedZPerspectiveMatrix(PI / 4.0f, PI / 4.0f, 1.0f, 16.0f / 9.0f, GNearClippingPlane, GNearClippingPlane);
+	const FMatrix ViewProjectionMatrix = ViewMatrix * ProjectionMatrix;
+	const FIntRect FullRect(FIntPoint::ZeroValue, Resolution);
+
+	// player in the middle of the frame, clip plane through the player facing the camera
+	const FBox Player(FVector(290.0f, -50.0f, -100.0f), FVector(310.0f, 50.0f, 100.0f));
+
+	const TArray<FPlane> NoPlanes;
+	const TArray<FPlane> ThroughPlayer = { FPlane(FVector(300.0f, 0.0f, 0.0f), FVector(-1.0f, 0.0f, 0.0f)) };
+	const TArray<FPlane> InFrontOfPlayer = { FPlane(FVector(200.0f, 0.0f, 0.0f), FVector(-1.0f, 0.0f, 0.0f)) };
+
+	const FIntRect Unclipped = FLivForegroundRegion::Compute(Player, NoPlanes, ViewProjectionMatrix, Resolution, 0);
+	TestTrue(TEXT("Player region is part of the frame"), Unclipped.Area() > 0 && Unclipped.Area() < FullRect.Area() / 4);
+	TestTrue(TEXT("Player region is centered"), Unclipped.Contains(Resolution / 2));
+
+	const FIntRect Clipped = FLivForegroundRegion::Compute(Player, ThroughPlayer, ViewProjectionMatrix, Resolution, 0);
+	TestTrue(TEXT("Clipped region within the player region"), Clipped.Area() > 0 && Clipped.Area() <= Unclipped.Area());
+
+	const FIntRect Padded = FLivForegroundRegion::Compute(Player, NoPlanes, ViewProjectionMatrix, Resolution, 32);
+	TestTrue(TEXT("Padding grows the region"), Padded.Area() > Unclipped.Area());
+
+	TestEqual(TEXT("Player behind the clip plane has no region"), FLivForegroundRegion::Compute(Player, InFrontOfPlayer, ViewProjectionMatrix, Resolution, 0).Area(), 0);
+	TestTrue(TEXT("Player around the camera covers the frame"), FLivForegroundRegion::Compute(FBox(FVector(-50.0f), FVector(50.0f)), NoPlanes, ViewProjectionMatrix, Resolution, 0) == FullRect);
+
+	const auto ToPixel = [](const FMatrix& Matrix, const FVector& Position, const FIntPoint& Size)
+	{
+		const FVector4 ClipPosition = Matrix.TransformFVector4(FVector4(Position, 1.0f));
+		return FVector2D((ClipPosition.X / ClipPosition.W * 0.5f + 0.5f) * Size.X, (0.5f - ClipPosition.Y / ClipPosition.W * 0.5f) * Size.Y);
+	};
+
+	// a point inside the crop rect lands on the same pixel of the cropped view
+	const FIntRect CropRect(640, 320, 1280, 800);
+	const FMatrix CroppedViewProjectionMatrix = ViewMatrix * FLivForegroundRegion::CropProjectionMatrix(ProjectionMatrix, CropRect, Resolution);
+	const FVector Point(300.0f, 40.0f, 30.0f);
+
+	const FVector2D FullPixel = ToPixel(ViewProjectionMatrix, Point, Resolution);
+	const FVector2D CroppedPixel = ToPixel(CroppedViewProjectionMatrix, Point, CropRect.Size());
+
+	TestTrue(TEXT("Point inside the crop rect"), CropRect.Contains(FIntPoint(FMath::FloorToInt(FullPixel.X), FMath::FloorToInt(FullPixel.Y))));
+	TestTrue(TEXT("Cropped view keeps pixels in place"), FVector2D::Distance(CroppedPixel + FVector2D(CropRect.Min), FullPixel) < 0.01f);
+	TestTrue(TEXT("Full rect keeps the projection"), FLivForegroundRegion::CropProjectionMatrix(ProjectionMatrix, FullRect, Resolution).Equals(ProjectionMatrix));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivForegroundCullingTest, "LIV.Math.Foreground Culling", GAutomationFlags)
+
+/**
+ * Test primitives are only culled when entirely behind the clip plane or outside the LIV camera's frustum.
+ */
+bool FLivForegroundCullingTest::RunTest(const FString& Parameters)
+{
+	// camera at the origin looking down +X
+	const FMatrix ViewMatrix(
+		FPlane(0, 0, 1, 0),
+		FPlane(1, 0, 0, 0),
+		FPlane(0, 1, 0, 0),
+		FPlane(0, 0, 0, 1));
+
+	const FMatrix ProjectionMatrix = FReversedZPerspectiveMatrix(PI / 4.0f, PI / 4.0f, 1.0f, 16.0f / 9.0f, GNearClippingPlane, GNearClippingPlane);
+
+	FConvexVolume Frustum;
+	GetViewFrustumBounds(Frustum, ViewMatrix * ProjectionMatrix, false);
+
+	// keeps the camera side of X = 300
+	const FPlane ClipPlane(FVector(300.0f, 0.0f, 0.0f), FVector(-1.0f, 0.0f, 0.0f));
+	const TArray<FPlane> Planes = { ClipPlane };
+
+	const FVector Extent(50.0f);
+
+	TestTrue(TEXT("In front of the clip plane is visible"), FLivForegroundCulling::IsVisible(FBoxSphereBounds(FVector(200.0f, 0.0f, 0.0f), Extent, Extent.Size()), Planes, Frustum));
+	TestTrue(TEXT("Across the clip plane is visible"), FLivForegroundCulling::IsVisible(FBoxSphereBounds(FVector(320.0f, 0.0f, 0.0f), Extent, Extent.Size()), Planes, Frustum));
+	TestFalse(TEXT("Behind the clip plane is culled"), FLivForegroundCulling::IsVisible(FBoxSphereBounds(FVector(400.0f, 0.0f, 0.0f), Extent, Extent.Size()), Planes, Frustum));
+	TestFalse(TEXT("Behind the camera is culled"), FLivForegroundCulling::IsVisible(FBoxSphereBounds(FVector(-200.0f, 0.0f, 0.0f), Extent, Extent.Size()), Planes, Frustum));
+	TestFalse(TEXT("Outside the frustum is culled"), FLivForegroundCulling::IsVisible(FBoxSphereBounds(FVector(200.0f, 1000.0f, 0.0f), Extent, Extent.Size()), Planes, Frustum));
+
+	// a rotated plane, the box corner nearest the camera side decides
+	const FPlane Diagonal(FVector(300.0f, 0.0f, 0.0f), FVector(-1.0f, -1.0f, 0.0f).GetSafeNormal());
+	const TArray<FPlane> DiagonalPlanes = { Diagonal };
+
+	TestTrue(TEXT("Corner across a rotated plane is visible"), FLivForegroundCulling::IsVisible(FBoxSphereBounds(FVector(340.0f, 0.0f, 0.0f), Extent, Extent.Size()), DiagonalPlanes, Frustum));
+	TestFalse(TEXT("Behind a rotated plane is culled"), FLivForegroundCulling::IsVisible(FBoxSphereBounds(FVector(380.0f, 50.0f, 0.0f), Extent, Extent.Size()), DiagonalPlanes, Frustum));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivCaptureContextTest, "LIV.Capture.Capture Context", GAutomationFlags)
+
+/**
+ * Test the hide lists only change version when their contents do and scene captures are only updated on a new version.
+ */
+bool FLivCaptureContextTest::RunTest(const FString& Parameters)
+{
+	UPrimitiveComponent* First = NewObject<UStaticMeshComponent>(GetTransientPackage());
+	UPrimitiveComponent* Second = NewObject<UStaticMeshComponent>(GetTransientPackage());
+	USceneCaptureComponent2D* SceneCapture = NewObject<USceneCaptureComponent2D>(GetTransientPackage());
+
+	FLivCaptureContext Context;
+	const uint32 InitialVersion = Context.GetVersion();
+
+	const TArray<UPrimitiveComponent*> Components = { First, Second, First, nullptr };
+	Context.HideComponents(Components);
+
+	TestEqual(TEXT("Duplicates hidden once"), Context.GetHiddenComponents().Num(), 2);
+	TestEqual(TEXT("Batch bumps the version once"), Context.GetVersion(), InitialVersion + 1);
+
+	Context.HideComponents(MakeArrayView(&First, 1));
+	Context.ShowActors(TArray<AActor*>{ nullptr });
+	TestEqual(TEXT("No-op changes keep the version"), Context.GetVersion(), InitialVersion + 1);
+
+	Context.ApplyHideLists(SceneCapture);
+	TestEqual(TEXT("Scene capture given the hide list"), SceneCapture->HiddenComponents.Num(), 2);
+
+	// not touched again until the version changes
+	SceneCapture->HiddenComponents.Reset();
+	Context.ApplyHideLists(SceneCapture);
+	TestEqual(TEXT("Same version skips the scene capture"), SceneCapture->HiddenComponents.Num(), 0);
+
+	Context.ShowComponents(MakeArrayView(&Second, 1));
+	Context.ApplyHideLists(SceneCapture);
+	TestEqual(TEXT("New version updates the scene capture"), SceneCapture->HiddenComponents.Num(), 1);
+
+	Context.ClearHiddenComponents();
+	Context.ApplyHideLists(SceneCapture);
+	TestEqual(TEXT("Cleared hide list applied"), SceneCapture->HiddenComponents.Num(), 0);
+
+	return true;
+}
+
+#if LIV_WITH_LOOPBACK
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivLoopbackBridgeTest, "LIV.Loopback.Input Frames And Submission", GAutomationFlags)
+
+/**
+ * Test the loopback bridge serves scripted input frames, honours game requests and records submissions.
+ */
+bool FLivLoopbackBridgeTest::RunTest(const FString& Parameters)
+{
+	FLivLoopbackBridge& Bridge = FLivLoopbackBridge::Get();
+
+	// the bridge is shared with the running game (and a replayed trace), put it back afterwards
+	FLivLoopbackBridge::FState SavedState = Bridge.SaveState();
+
+	const LIV_Vector3 ScriptedPosition{ { 1.0f, 2.0f, 3.0f } };
+
+	Bridge.SetInputFrameSource([&ScriptedPosition](uint64 FrameId, LIV_InputFrame& OutInputFrame)
+	{
+		OutInputFrame.pose.local_position = ScriptedPosition;
+		OutInputFrame.pose.local_rotation = LIV_Quaternion{ { 0.0f, 0.0f, 0.0f, 1.0f } };
+		OutInputFrame.pose.width = 640;
+		OutInputFrame.pose.height = 360;
+	});
+
+	LIV_InputFrame Request;
+	Bridge.ClearInputFrame(&Request);
+
+	const LIV_InputFrame FirstFrame = *Bridge.UpdateInputFrame(&Request);
+	const LIV_InputFrame SecondFrame = *Bridge.UpdateInputFrame(&Request);
+
+	TestEqual(TEXT("Frame id increments"), SecondFrame.frameid, FirstFrame.frameid + 1);
+	TestEqual<float>(TEXT("Scripted position"), SecondFrame.pose.local_position.z, ScriptedPosition.z);
+	TestEqual(TEXT("Scripted width"), SecondFrame.pose.width, 640);
+	TestFalse(TEXT("Unchanged pose not flagged as updated"), (SecondFrame.features & LIV_FEATURES_POSE_UPDATED) != 0);
+
+	// game requests its own pose
+	Request.pose_priority = LIV_GAME_PRIORITY;
+	Request.pose.local_position = LIV_Vector3{ { 4.0f, 5.0f, 6.0f } };
+
+	const LIV_InputFrame OverriddenFrame = *Bridge.UpdateInputFrame(&Request);
+
+	TestEqual<float>(TEXT("Requested position"), OverriddenFrame.pose.local_position.z, 6.0f);
+	TestEqual(TEXT("Resolution kept"), OverriddenFrame.pose.height, 360);
+	TestTrue(TEXT("Changed pose flagged as updated"), (OverriddenFrame.features & LIV_FEATURES_POSE_UPDATED) != 0);
+
+	// submission
+	const uint64 NumSubmissions = Bridge.GetNumSubmissions();
+
+	LIV_Texture Texture{};
+	Texture.id = LIV_TEXTURE_BACKGROUND_COLOR_BUFFER_ID;
+	Bridge.AddTexture(&Texture);
+	Bridge.Submit();
+
+	TestEqual(TEXT("Submission counted"), Bridge.GetNumSubmissions(), NumSubmissions + 1);
+
+	const TArray<FLivLoopbackSubmission> Submissions = Bridge.GetRecentSubmissions();
+
+	if (TestTrue(TEXT("Submission recorded"), Submissions.Num() > 0))
+	{
+		const FLivLoopbackSubmission& Submission = Submissions.Last();
+		TestEqual(TEXT("Submission frame id"), Submission.FrameId, OverriddenFrame.frameid);
+		TestEqual(TEXT("Submission texture count"), Submission.Textures.Num(), 1);
+	}
+
+	Bridge.RestoreState(MoveTemp(SavedState));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivIncrementalInputFrameTest, "LIV.Loopback.Incremental Input Frame", GAutomationFlags)
+
+/**
+ * Test only the fields the loopback bridge reports as updated are decoded, unchanged ones are kept.
+ */
+bool FLivIncrementalInputFrameTest::RunTest(const FString& Parameters)
+{
+	FLivLoopbackBridge& Bridge = FLivLoopbackBridge::Get();
+	FLivLoopbackBridge::FState SavedState = Bridge.SaveState();
+
+	IConsoleVariable* IncrementalInputFrame = IConsoleManager::Get().FindConsoleVariable(TEXT("Liv.IncrementalInputFrame"));
+	const bool bSavedIncrementalInputFrame = IncrementalInputFrame->GetBool();
+	IncrementalInputFrame->Set(true);
+
+	float PositionX = 1.0f;
+
+	Bridge.Reset();
+	Bridge.SetInputFrameSource([&PositionX](uint64 FrameId, LIV_InputFrame& OutInputFrame)
+	{
+		OutInputFrame.pose.local_position = LIV_Vector3{ { PositionX, 0.0f, 0.0f } };
+		OutInputFrame.pose.local_rotation = LIV_Quaternion{ { 0.0f, 0.0f, 0.0f, 1.0f } };
+		OutInputFrame.pose.width = 640;
+		OutInputFrame.pose.height = 360;
+		OutInputFrame.clipPlane.transform = Convert<FMatrix, LIV_Matrix4x4>(FMatrix::Identity);
+	});
+
+	FLivInputFrame InputFrame;
+	FLivNativeWrapper::DecodeInputFrame(*Bridge.UpdateInputFrame(nullptr), InputFrame);
+
+	TestTrue(TEXT("First frame decodes everything"), InputFrame.DirtyFields == ELivInputFrameFields::All);
+
+	const FVector FirstLocation = InputFrame.CameraLocation;
+	const FMatrix FirstClipPlaneMatrix = InputFrame.CameraClipPlaneMatrix;
+
+	PositionX = 2.0f;
+	LIV_InputFrame MovedFrame = *Bridge.UpdateInputFrame(nullptr);
+
+	// not reported as updated, a full decode would pick this up
+	MovedFrame.clipPlane.transform = Convert<FMatrix, LIV_Matrix4x4>(FTranslationMatrix(FVector(100.0f, 0.0f, 0.0f)));
+
+	FLivNativeWrapper::DecodeInputFrame(MovedFrame, InputFrame);
+
+	TestTrue(TEXT("Updated pose is dirty"), InputFrame.IsDirty(ELivInputFrameFields::Pose));
+	TestFalse(TEXT("Unchanged clip planes are not dirty"), InputFrame.IsDirty(ELivInputFrameFields::ClipPlanes));
+	TestFalse(TEXT("Updated pose decoded"), InputFrame.CameraLocation.Equals(FirstLocation));
+	TestTrue(TEXT("Unchanged clip plane kept"), InputFrame.CameraClipPlaneMatrix.Equals(FirstClipPlaneMatrix));
+
+	IncrementalInputFrame->Set(bSavedIncrementalInputFrame);
+	Bridge.RestoreState(MoveTemp(SavedState));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivBackgroundDepthFeatureTest, "LIV.Loopback.Background Depth Feature", GAutomationFlags)
+
+/**
+ * Test background depth is only reported once requested through the feature bits, keeping the layers LIV sent.
+ */
+bool FLivBackgroundDepthFeatureTest::RunTest(const FString& Parameters)
+{
+	FLivLoopbackBridge& Bridge = FLivLoopbackBridge::Get();
+	FLivLoopbackBridge::FState SavedState = Bridge.SaveState();
+
+	Bridge.Reset();
+	Bridge.SetInputFrameSource([](uint64 FrameId, LIV_InputFrame& OutInputFrame)
+	{
+		OutInputFrame.pose.width = 640;
+		OutInputFrame.pose.height = 360;
+		OutInputFrame.features = LIV_FEATURES_BACKGROUND_RENDER;
+	});
+
+	FLivInputFrame InputFrame;
+	FLivNativeWrapper::DecodeInputFrame(*Bridge.UpdateInputFrame(nullptr), InputFrame);
+
+	TestFalse(TEXT("Background depth not reported unless requested"), InputFrame.bBackgroundDepthEnabled);
+
+	LIV_InputFrame Request;
+	Bridge.ClearInputFrame(&Request);
+	Request.feature_priority = LIV_GAME_PRIORITY;
+	Request.features = InputFrame.Features | LIV_FEATURES_BACKGROUND_DEPTH_RENDER;
+
+	FLivNativeWrapper::DecodeInputFrame(*Bridge.UpdateInputFrame(&Request), InputFrame);
+
+	TestTrue(TEXT("Requested background depth reported"), InputFrame.bBackgroundDepthEnabled);
+	TestTrue(TEXT("Background kept"), InputFrame.bBackgroundEnabled);
+	TestFalse(TEXT("Foreground kept off"), InputFrame.bForegroundEnabled);
+
+	Bridge.RestoreState(MoveTemp(SavedState));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivRequestedResolutionTest, "LIV.Loopback.Requested Resolution", GAutomationFlags)
+
+/**
+ * Test LIV's own resolution stays known while input frames carry the resolution the game requested.
+ */
+bool FLivRequestedResolutionTest::RunTest(const FString& Parameters)
+{
+	FLivLoopbackBridge& Bridge = FLivLoopbackBridge::Get();
+	FLivLoopbackBridge::FState SavedState = Bridge.SaveState();
+
+	// LIV's output is resized on the third frame
+	Bridge.Reset();
+	Bridge.SetInputFrameSource([](uint64 FrameId, LIV_InputFrame& OutInputFrame)
+	{
+		OutInputFrame.pose.width = FrameId < 3 ? 1280 : 1920;
+		OutInputFrame.pose.height = FrameId < 3 ? 720 : 1080;
+	});
+
+	LIV_InputFrame Request;
+	Bridge.ClearInputFrame(&Request);
+	Request.resolution_priority = LIV_GAME_PRIORITY;
+	Request.pose.width = 640;
+	Request.pose.height = 360;
+
+	LIV_Resolution Resolution;
+
+	for (uint64 FrameId = 1; FrameId <= 3; ++FrameId)
+	{
+		const LIV_InputFrame* InputFrame = Bridge.UpdateInputFrame(&Request);
+		TestTrue(TEXT("Requested resolution served"), InputFrame->pose.width == 640 && InputFrame->pose.height == 360);
+
+		Bridge.GetResolution(&Resolution);
+		TestTrue(TEXT("LIV's own resolution reported"), FrameId < 3
+			? Resolution.width == 1280 && Resolution.height == 720
+			: Resolution.width == 1920 && Resolution.height == 1080);
+	}
+
+	Bridge.RestoreState(MoveTemp(SavedState));
+
+	return true;
+}
+
+#if LIV_WITH_INPUT_FRAME_TRACE
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLivInputFrameTraceTest, "LIV.Loopback.Input Frame Trace", GAutomationFlags)
+
+/**
+ * Test input frames recorded from the loopback bridge replay through it frame for frame, looping and rewinding on reset.
+ */
+bool FLivInputFrameTraceTest::RunTest(const FString& Parameters)
+{
+	FLivLoopbackBridge& Bridge = FLivLoopbackBridge::Get();
+	FLivLoopbackBridge::FState SavedState = Bridge.SaveState();
+
+	Bridge.Reset();
+	Bridge.SetInputFrameSource([](uint64 FrameId, LIV_InputFrame& OutInputFrame)
+	{
+		OutInputFrame.pose.local_position = LIV_Vector3{ { static_cast<float>(FrameId), 0.0f, 0.0f } };
+		OutInputFrame.pose.local_rotation = LIV_Quaternion{ { 0.0f, 0.0f, 0.0f, 1.0f } };
+		OutInputFrame.pose.width = 640;
+		OutInputFrame.pose.height = 360;
+	});
+
+	// relative to Saved/Liv
+	const FString Filename = TEXT("LivInputFrameTraceTest.trace");
+	constexpr int32 NumFrames = 4;
+
+	TArray<float> RecordedPositions;
+
+	{
+		FLivInputFrameRecorder Recorder;
+		TestTrue(TEXT("Recording starts"), Recorder.Start(Filename));
+
+		for (int32 Index = 0; Index < NumFrames; ++Index)
+		{
+			const LIV_InputFrame* InputFrame = Bridge.UpdateInputFrame(nullptr);
+			Recorder.Record(*InputFrame);
+			RecordedPositions.Add(InputFrame->pose.local_position.x);
+		}
+
+		Recorder.Stop();
+	}
+
+	{
+		FLivInputFrameReplay Replay;
+
+		if (TestTrue(TEXT("Trace opens"), Replay.Open(Filename)))
+		{
+			TestEqual(TEXT("Every frame recorded"), Replay.Num(), NumFrames);
+
+			for (int32 Pass = 0; Pass < 2; ++Pass)
+			{
+				// a reset bridge starts the trace over
+				Bridge.Reset();
+
+				for (int32 Index = 0; Index < NumFrames + 1; ++Index)
+				{
+					const LIV_InputFrame* InputFrame = Bridge.UpdateInputFrame(nullptr);
+					TestEqual<float>(TEXT("Replayed frame for frame"), InputFrame->pose.local_position.x, RecordedPositions[Index % NumFrames]);
+				}
+			}
+		}
+
+		Replay.Close();
+	}
+
+	Bridge.RestoreState(MoveTemp(SavedState));
+	IFileManager::Get().Delete(*FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Liv"), Filename));
+
+	return true;
+}
+
+#endif // LIV_WITH_INPUT_FRAME_TRACE
+
+#endif // LIV_WITH_LOOPBACK
+
 #endif // WITH_DEV_AUTOMATION_TESTS
-#endif // PLATFORM_WINDOWS
\ No newline at end of file
+#endif // LIV_CAPTURE_SUPPORTED
\ No newline at end of file
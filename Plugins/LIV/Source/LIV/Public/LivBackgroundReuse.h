@@ -0,0 +1,59 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UPrimitiveComponent;
+class USceneCaptureComponent2D;
+
+/**
+ * Decides when a static LIV camera (usually on a tripod) needs its background rendered again, the last one is
+ * submitted otherwise. The background is re-rendered when the camera pose, FOV or resolution changes, when
+ * something in view is dirty or when it is older than MaxAge seconds.
+ *
+ * In view and dirty: movable primitives that moved (or left the view), active particle systems, ticking
+ * skinned meshes and anything tagged AnimatedTag, which is how animated materials opt in.
+ *
+ * Each scan only tests the world's movable primitives, see FLivPrimitiveCache.
+ */
+class LIV_API FLivBackgroundReuse
+{
+public:
+
+	FLivBackgroundReuse();
+
+	/** Component or actor tag for primitives that change without moving, e.g. animated materials. */
+	static const FName AnimatedTag;
+
+	/**
+	 * Whether to render the background this capture, records the capture when it returns true.
+	 */
+	bool ShouldRecapture(const FTransform& CameraTransform, float FOVAngle, const FIntPoint& Resolution, bool bSceneDirty, double Time);
+
+	/**
+	 * Scan the movable primitives in view of the scene capture's camera for changes since the last scan,
+	 * primitives hidden from the capture are ignored. Game thread.
+	 */
+	bool UpdateSceneDirty(const USceneCaptureComponent2D* SceneCaptureComponent, const FIntPoint& Resolution);
+
+	/**
+	 * Render the background on the next capture and forget the scanned primitives.
+	 */
+	void Reset();
+
+	/** Seconds before the background is rendered regardless, zero (or less) never expires. */
+	double MaxAge;
+
+private:
+
+	bool bHasCapture;
+	double LastCaptureTime;
+	FTransform LastCameraTransform;
+	float LastFOVAngle;
+	FIntPoint LastResolution;
+
+	/** Movable primitives in view at the last scan. */
+	TMap<TObjectKey<UPrimitiveComponent>, FTransform> PrimitiveTransforms;
+};
@@ -0,0 +1,57 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LivCaptureBase.h"
+#include "LivCaptureAnalyticClipPlane.generated.h"
+
+/**
+ * ULivCaptureAnalyticClipPlane
+ * 
+ * Render full scene for color and depth, once.
+ * Reconstruct the world position of every pixel from its depth and test it against
+ * the camera and floor clip planes of the input frame, where it is on the camera side
+ * of both mask == 1 else 0.
+ * Draw the full scene where mask is 1 and write it to alpha too.
+ * 
+ * Development Notes:
+ * - Half the scene rendering of the mesh clip plane methods but the planes are infinite
+ *   rather than the size of the clip plane meshes.
+ * - Segments by the depth in the scene capture so translucent surfaces, which don't write
+ *   depth, follow whatever is behind them. Use the mesh clip plane methods for those.
+ * - Not post processed.
+ */
+UCLASS(ClassGroup = LIV, BlueprintType)
+class LIV_API ULivCaptureAnalyticClipPlane : public ULivCaptureBase
+{
+	GENERATED_BODY()
+
+public:
+
+	ULivCaptureAnalyticClipPlane(const FObjectInitializer& ObjectInitializer);
+
+	/**
+	 * World space plane of a LIV clip plane (camera or floor) facing so the camera is on its positive side.
+	 */
+	static FPlane MakeCameraSidePlane(const FMatrix& ClipPlaneMatrix, const FTransform& VROriginTransform, const FVector& CameraLocation);
+
+public:
+
+	UPROPERTY(Transient, VisibleAnywhere, Category = "LIV", meta=(LivStage=Input,LivDepth=A))
+		UTextureRenderTarget2D* SceneRenderTarget;
+
+	UPROPERTY(Transient, VisibleAnywhere, Category = "LIV", meta=(LivStage=Output))
+		UTextureRenderTarget2D* BackgroundOutputRenderTarget;
+
+	UPROPERTY(Transient, VisibleAnywhere, Category = "LIV", meta=(LivStage=Output,LivMask=A))
+		UTextureRenderTarget2D* ForegroundOutputRenderTarget;
+
+protected:
+
+	void OnActivated() override;
+
+	void CreateRenderTargets() override;
+	void ReleaseRenderTargets() override;
+
+	void Capture(const struct FLivCaptureContext& Context) override;
+};
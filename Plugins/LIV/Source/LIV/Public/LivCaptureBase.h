@@ -5,7 +5,12 @@
 #include "Logging/LogMacros.h"
 #include "Components/SceneCaptureComponent2D.h"
 #include "Engine/TextureRenderTarget2D.h"
+#include "LivBackgroundReuse.h"
+#include "LivCaptureScheduler.h"
+#include "LivDynamicResolution.h"
+#include "LivForegroundCulling.h"
 #include "LivNativeWrapper.h"
+#include "LivPosePredictor.h"
 #include "LivCaptureBase.generated.h"
 
 class UProceduralMeshComponent;
@@ -44,6 +49,22 @@ public:
 	UFUNCTION(BlueprintPure, Category = "LIV")
 		bool IsLivCapturing() const;
 
+	/**
+	 * All non-abstract capture methods (classes deriving from ULivCaptureBase).
+	 */
+	static TArray<TSubclassOf<ULivCaptureBase>> GetCaptureClasses();
+
+	/**
+	 * Projection matrix of a scene capture rendering at Resolution, the field of view is horizontal in
+	 * landscape and vertical in portrait as the scene capture renderer sets it up.
+	 */
+	static FMatrix GetCaptureProjectionMatrix(const USceneCaptureComponent2D* InSceneCaptureComponent, const FIntPoint& Resolution);
+
+	/**
+	 * View projection matrix of a scene capture rendering at Resolution, as the scene capture renderer sets it up.
+	 */
+	static FMatrix GetCaptureViewProjectionMatrix(const USceneCaptureComponent2D* InSceneCaptureComponent, const FIntPoint& Resolution);
+
 protected:
 
 	// each frame assigned from LIV_IsActive()
@@ -52,6 +73,45 @@ protected:
 	// Expected render target dimensions
 	int32 LivInputFrameWidth;
 	int32 LivInputFrameHeight;
+
+	// Sequence of the last input frame read from the polling thread
+	uint64 PolledInputFrameSequence;
+
+	// History of camera poses for prediction (if enabled in settings)
+	FLivPosePredictor PosePredictor;
+
+	// Picks the frames to capture on when a capture rate is set
+	FLivCaptureScheduler CaptureScheduler;
+
+	// Picks the resolution to ask LIV for (if enabled in settings)
+	FLivDynamicResolution DynamicResolution;
+
+	// Skips rendering an unchanged background (if enabled in settings)
+	FLivBackgroundReuse BackgroundReuse;
+
+	// Show only lists of the foreground captures (if enabled in settings)
+	FLivForegroundCulling ForegroundCulling;
+
+	// Intermediate textures are copied to render targets for the debugging tab
+	bool bExtractIntermediates;
+
+	// Resolution LIV wants itself, dynamic resolution requests a scale of it
+	FIntPoint LivNativeResolution;
+	bool bResolutionRequested;
+
+	// Late updates the camera pose on the render thread (if enabled in settings)
+	TSharedPtr<class FLivSceneViewExtensionLateLatch, ESPMode::ThreadSafe> LateLatchViewExtension;
+
+	// input frame, VR origin and capture transform the clip plane meshes were last placed with,
+	// the meshes are attached to the capture so they move with it unless placed again
+	FMatrix LastClipPlaneCameraMatrix;
+	FMatrix LastClipPlaneFloorMatrix;
+	bool bLastFloorClipPlaneEnabled;
+	FVector LastClipPlaneCameraLocation;
+	FQuat LastClipPlaneCameraRotation;
+	FTransform LastClipPlaneOriginTransform;
+	FTransform LastClipPlaneCaptureTransform;
+	bool bClipPlaneTransformsValid;
 	
 #ifdef WITH_EDITORONLY_DATA
 	// Guard bool to request capture from LIV once
@@ -71,11 +131,81 @@ protected:
 	virtual void RecreateRenderTargets();
 	virtual void ReleaseRenderTargets();
 
+	/**
+	 * Whether to create render targets for intermediate textures (Liv.Debug.ExtractIntermediates), only what
+	 * the scene captures write needs to be persistent otherwise. Render targets are recreated when it changes.
+	 */
+	static bool ShouldExtractIntermediates();
+
 	void UpdateLivInputFrame(USceneCaptureComponent2D* InSceneCaptureComponent);
 
+	// Ask LIV for a lower resolution while the GPU is over budget, called every tick
+	void UpdateDynamicResolution();
+
+	// Replace the input frame camera pose with one predicted for when the capture is displayed
+	void PredictCameraPose(bool bNewInputFrame);
+
+	/**
+	 * Returns true if the clip plane meshes need moving this frame, i.e. the clip planes or camera pose
+	 * changed since they were last placed, the VR origin or capture moved or a debug clip plane is in use.
+	 */
+	bool ShouldUpdateClipPlaneTransforms(const FTransform& VROriginTransform);
+
+	/**
+	 * Whether to render and submit the background / foreground this frame,
+	 * follows the layers LIV composites (see FLivInputFrame) and the background only setting.
+	 * Valid after UpdateLivInputFrame.
+	 */
+	bool ShouldCaptureBackground() const;
+	bool ShouldCaptureForeground() const;
+
+	// Whether this method can submit background depth instead of the foreground (see ULivPluginSettings::bCompositorSegmentation)
+	virtual bool SupportsCompositorSegmentation() const { return false; }
+
+	/**
+	 * Whether compositor segmentation is enabled for this method, background depth is asked of LIV while it is.
+	 */
+	bool IsCompositorSegmentationRequested() const;
+
+	/**
+	 * Whether to submit background depth instead of the foreground this frame, only once LIV reports it takes
+	 * background depth, otherwise the method segments as usual. Valid after UpdateLivInputFrame.
+	 */
+	bool ShouldUseCompositorSegmentation() const;
+
+	/**
+	 * Whether the background needs rendering or the last one can be submitted again (see FLivBackgroundReuse),
+	 * only for methods that keep the background in a render target of its own. Always false when the background
+	 * isn't captured this frame. Call once per capture after SetSceneCaptureComponentParameters.
+	 */
+	bool ShouldRenderBackground(const USceneCaptureComponent2D* InSceneCaptureComponent, bool bCaptureBackground);
+
+	/**
+	 * Turn shadows, lighting and reflections off for a capture only its depth or opacity is used from,
+	 * or back on for a color capture (see ULivPluginSettings::bReusePreviousCaptureLighting).
+	 */
+	static void SetCaptureUsesLighting(USceneCaptureComponent2D* InSceneCaptureComponent, bool bUsesLighting);
+
+	/**
+	 * Render only the primitives that can be on the kept side of the scene capture's clip plane with its next
+	 * CaptureScene (see FLivForegroundCulling), if enabled in settings. Call after setting the clip plane and
+	 * EndForegroundCulling after the capture.
+	 */
+	void BeginForegroundCulling(USceneCaptureComponent2D* InSceneCaptureComponent);
+	static void EndForegroundCulling(USceneCaptureComponent2D* InSceneCaptureComponent);
+
+	/**
+	 * Whether nothing the scene capture can see may be on the kept (positive) side of ClipPlane, so the foreground
+	 * capture can be skipped, if enabled in settings. Conservative, tests primitive bounds (see FLivForegroundCulling).
+	 */
+	bool IsForegroundEmpty(const USceneCaptureComponent2D* InSceneCaptureComponent, const FPlane& ClipPlane);
+
 	// Set LIV camera parameters on scene capture component
 	virtual void SetSceneCaptureComponentParameters(USceneCaptureComponent2D* InSceneCaptureComponent);
 
+	// Views (view states) this component renders, more than one when it renders a view family itself
+	virtual int32 GetNumCaptureViews() const { return 1; }
+
 	static UTextureRenderTarget2D* CreateRenderTarget2D(UObject* WorldContextObject,
 		int32 Width,
 		int32 Height,
@@ -83,6 +213,18 @@ protected:
 		ETextureRenderTargetFormat Format = ETextureRenderTargetFormat::RTF_RGBA8,
 		FLinearColor ClearColor = FLinearColor::Black,
 		float TargetGamma = 0.0f);
+
+	// Lease render targets from the shared pool (ULivRenderTargetPool) rather than creating them outright
+	static UTextureRenderTarget2D* CreateRenderTarget2D(int32 Width,
+		int32 Height,
+		FName Name,
+		ETextureRenderTargetFormat Format,
+		bool bForceLinearGamma,
+		FLinearColor ClearColor = FLinearColor::Black,
+		float TargetGamma = 0.0f);
+
+	// Return a render target to the pool and clear the reference to it
+	static void ReleaseRenderTarget2D(UTextureRenderTarget2D*& RenderTarget);
 	
 public:
 	// void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -39,6 +39,7 @@ protected:
 	virtual void ReleaseRenderTargets() override;
 
 	virtual void Capture(const FLivCaptureContext& Context) override;
+	virtual bool SupportsCompositorSegmentation() const override { return true; }
 
 	TSharedPtr<class FLivSceneViewExtensionCombo, ESPMode::ThreadSafe> SceneViewExtension;
 };
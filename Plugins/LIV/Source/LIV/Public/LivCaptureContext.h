@@ -10,30 +10,48 @@
 
 /**
  * @TODO: Deprecate this ideally
+ *
+ * Hide lists are sets with a version that changes whenever they do, scene captures are only
+ * updated when the version changed since the lists were last applied to them.
  */
 USTRUCT(BlueprintType)
-struct FLivCaptureContext
+struct LIV_API FLivCaptureContext
 {
 	GENERATED_BODY()
 
+	FLivCaptureContext();
+
+	void HideComponents(TArrayView<UPrimitiveComponent* const> Components);
+	void ShowComponents(TArrayView<UPrimitiveComponent* const> Components);
+	void ClearHiddenComponents();
+
+	void HideActors(TArrayView<AActor* const> Actors);
+	void ShowActors(TArrayView<AActor* const> Actors);
+	void ClearHiddenActors();
+
+	const TSet<TWeakObjectPtr<UPrimitiveComponent>>& GetHiddenComponents() const { return HiddenComponents; }
+	const TSet<TWeakObjectPtr<AActor>>& GetHiddenActors() const { return HiddenActors; }
+
+	/** Incremented whenever a hide list changes. */
+	uint32 GetVersion() const { return Version; }
+
+	/**
+	 * Set the scene capture's hide lists, does nothing if they haven't changed since they were last applied to it.
+	 */
+	void ApplyHideLists(USceneCaptureComponent2D* Component) const;
+
+private:
+
 	/** The components won't rendered when LIV captures the scene. */
 	UPROPERTY(Transient)
-		TArray<TWeakObjectPtr<UPrimitiveComponent>> HiddenComponents;
+		TSet<TWeakObjectPtr<UPrimitiveComponent>> HiddenComponents;
 
 	/** These actors won't be rendered when LIV captures the scene. */
 	UPROPERTY(Transient)
-		TArray<TWeakObjectPtr<AActor>> HiddenActors;
-
-	void ApplyHideLists(USceneCaptureComponent2D* Component) const
-	{
-		Component->HiddenComponents = HiddenComponents;
-		Component->HiddenActors.Reset(HiddenActors.Num());
-		for (auto It = HiddenActors.CreateConstIterator(); It; ++It)
-		{
-			if (It->IsValid())
-			{
-				Component->HiddenActors.Add(It->Get());
-			}
-		}
-	}
-};
\ No newline at end of file
+		TSet<TWeakObjectPtr<AActor>> HiddenActors;
+
+	uint32 Version;
+
+	/** Version of the hide lists last applied to each scene capture. */
+	mutable TMap<TWeakObjectPtr<USceneCaptureComponent2D>, uint32> AppliedVersions;
+};
@@ -0,0 +1,93 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LivCaptureBase.h"
+#include "LivCaptureDualView.generated.h"
+
+class FSceneViewFamily;
+class FSceneView;
+class UGameViewportClient;
+
+/**
+ * ULivCaptureDualView
+ * 
+ * Render background and foreground (global clipping plane) with post processing as two views
+ * of one view family, side by side in the same render target, keeping the foreground's inverse
+ * opacity before post processing.
+ * Draw the background half,
+ * Draw the foreground half where the foreground's opacity is 1. Write the opacity to alpha too.
+ * 
+ * Development Notes:
+ * - One scene render rather than the three scene captures of ULivCaptureGlobalClipPlanePostProcess,
+ *   GPU scene, light setup and shadow depths are done once for both views.
+ * - Requires r.AllowGlobalClipPlane 1 like the other global clip plane methods.
+ * - With bLimitForegroundToPlayer the foreground view is cropped to the player's screen region
+ *   (FLivForegroundRegion), the segmentation clears the foreground outside it.
+ * - The family is rendered with BeginRenderingViewFamily once the game viewport has drawn rather than
+ *   from the capture tick, see RenderViews.
+ * - The foreground shares the background's eye adaptation with WITH_EYE_ADAPTATION_CALLBACK,
+ *   without it both views use manual exposure.
+ */
+UCLASS(ClassGroup = LIV, BlueprintType)
+class LIV_API ULivCaptureDualView : public ULivCaptureBase
+{
+	GENERATED_BODY()
+
+public:
+
+	ULivCaptureDualView(const FObjectInitializer& ObjectInitializer);
+
+public:
+
+	UPROPERTY(Transient, VisibleAnywhere, Category = "LIV", meta=(LivStage=Input))
+		UTextureRenderTarget2D* SceneRenderTarget;
+
+	UPROPERTY(Transient, VisibleAnywhere, Category = "LIV", meta=(LivStage=Input,LivMask=A))
+		UTextureRenderTarget2D* ForegroundOpacityRenderTarget;
+
+	UPROPERTY(Transient, VisibleAnywhere, Category = "LIV", meta=(LivStage=Output))
+		UTextureRenderTarget2D* BackgroundOutputRenderTarget;
+
+	UPROPERTY(Transient, VisibleAnywhere, Category = "LIV", meta=(LivStage=Output,LivMask=A))
+		UTextureRenderTarget2D* ForegroundOutputRenderTarget;
+
+protected:
+
+	void OnActivated() override;
+	void OnDeactivated() override;
+
+	void CreateRenderTargets() override;
+	void ReleaseRenderTargets() override;
+
+	void Capture(const struct FLivCaptureContext& Context) override;
+
+	// Render the views prepared by the last Capture, bound to the game viewport's end of draw
+	void RenderViews();
+
+	// Background and foreground
+	int32 GetNumCaptureViews() const override { return 2; }
+
+	// Add a view of this capture's camera to the family, rendered into ViewRect of the family's render target,
+	// only CropRect (relative to ViewRect) of it is rendered
+	FSceneView* AddView(FSceneViewFamily& ViewFamily, int32 ViewIndex, const FIntRect& ViewRect, const FIntRect& CropRect);
+
+	// Unreal to view space rotation and the projection of this capture's camera, as the scene capture renderer does
+	FMatrix GetViewRotationMatrix() const;
+	FMatrix GetProjectionMatrix(const FIntPoint& ViewSize) const;
+
+	// Rect of a view of ViewSize the foreground is rendered in, the whole view unless limited to the player
+	FIntRect GetForegroundRect(const FIntPoint& ViewSize) const;
+
+	TSharedPtr<class FLivSceneViewExtensionDualView, ESPMode::ThreadSafe> SceneViewExtension;
+
+	// Prepared by Capture for RenderViews
+	bool bRenderPending;
+	bool bPendingCaptureBackground;
+	bool bPendingCaptureForeground;
+	FPlane PendingClipPlane;
+	FIntRect PendingForegroundRect;
+
+	TWeakObjectPtr<UGameViewportClient> EndDrawViewport;
+	FDelegateHandle EndDrawHandle;
+};
@@ -58,4 +58,7 @@ protected:
 	void ReleaseRenderTargets() override;
 
 	void Capture(const struct FLivCaptureContext& Context) override;
+
+	// Show the clip plane meshes and capture the foreground (skipped when LIV doesn't composite it)
+	void CaptureForeground();
 };
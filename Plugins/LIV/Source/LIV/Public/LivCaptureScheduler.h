@@ -0,0 +1,32 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Decides which game frames capture for LIV so captures run at a target rate rather than the HMD frame rate,
+ * spread as evenly as the game frames allow (e.g. every third frame at 90 Hz for 30 fps).
+ */
+class LIV_API FLivCaptureScheduler
+{
+public:
+
+	FLivCaptureScheduler();
+
+	/**
+	 * Advance by a game frame of DeltaTime seconds, returns true if this frame should capture.
+	 * A TargetRate of zero (or less) captures every frame. Frames missed in a hitch are not caught up.
+	 */
+	bool ShouldCapture(double DeltaTime, double TargetRate);
+
+	/**
+	 * Capture on the next frame and schedule from there.
+	 */
+	void Reset();
+
+private:
+
+	/** Capture intervals elapsed since the last capture. */
+	double Phase;
+};
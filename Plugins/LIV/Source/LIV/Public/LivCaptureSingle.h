@@ -38,6 +38,7 @@ protected:
 	virtual void ReleaseRenderTargets() override;
 
 	virtual void Capture(const FLivCaptureContext& Context) override;
+	virtual bool SupportsCompositorSegmentation() const override { return true; }
 
 	TSharedPtr<class FLivSceneViewExtensionSingle, ESPMode::ThreadSafe> SceneViewExtension;
 };
@@ -0,0 +1,58 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Picks the resolution scale to ask LIV for from the game's GPU frame time, stepping down when the GPU
+ * stays over budget and back up when it stays well under. The gap between the thresholds, the delays
+ * and a cooldown after every change keep it from thrashing (each change recreates the capture render targets).
+ */
+class LIV_API FLivDynamicResolution
+{
+public:
+
+	FLivDynamicResolution();
+
+	/**
+	 * Feed a frame's GPU time against the frame budget, returns true if the scale changed.
+	 */
+	bool Update(double DeltaTime, float GPUFrameTimeMs, float FrameBudgetMs);
+
+	/**
+	 * Back to full resolution with no history.
+	 */
+	void Reset();
+
+	float GetScale() const { return Scale; }
+
+	/**
+	 * NativeResolution scaled by the current scale, rounded to even dimensions.
+	 */
+	FIntPoint GetResolution(const FIntPoint& NativeResolution) const;
+
+	/** Lowest scale to step down to. */
+	float MinScale;
+
+	/** Scale change per step. */
+	float ScaleStep;
+
+	/** Step down when the GPU time stays above this fraction of the budget for LowerDelay seconds. */
+	float LowerThreshold;
+	double LowerDelay;
+
+	/** Step up when the GPU time stays below this fraction of the budget for RaiseDelay seconds. */
+	float RaiseThreshold;
+	double RaiseDelay;
+
+	/** Seconds after a change before the next one. */
+	double Cooldown;
+
+private:
+
+	float Scale;
+	double OverBudgetTime;
+	double UnderBudgetTime;
+	double CooldownTime;
+};
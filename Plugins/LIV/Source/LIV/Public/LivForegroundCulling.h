@@ -0,0 +1,59 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UPrimitiveComponent;
+class USceneCaptureComponent2D;
+struct FConvexVolume;
+
+/**
+ * Builds the show only list of a foreground scene capture from the primitives that can end up on the kept side
+ * of its global clip plane, everything else would be drawn only to be clipped. Each update classifies the world's
+ * primitives (see FLivPrimitiveCache) against the clip plane and the LIV camera's frustum in parallel.
+ *
+ * Culled primitives no longer cast shadows in the foreground capture.
+ */
+class LIV_API FLivForegroundCulling
+{
+public:
+
+	FLivForegroundCulling();
+
+	/**
+	 * Whether bounds are inside the frustum and not entirely on the negative side of any of the planes.
+	 */
+	static bool IsVisible(const FBoxSphereBounds& Bounds, TArrayView<const FPlane> Planes, const FConvexVolume& Frustum);
+
+	/**
+	 * Classify the primitives the scene capture can see against ClipPlane, the result is reused for
+	 * scene captures with the same view and clip plane in the same frame. Game thread.
+	 */
+	void Update(const USceneCaptureComponent2D* SceneCaptureComponent, const FPlane& ClipPlane, const FIntPoint& Resolution);
+
+	/**
+	 * Switch the scene capture to a show only list of the primitives it can see on the kept side of its clip plane.
+	 */
+	void Apply(USceneCaptureComponent2D* SceneCaptureComponent, const FIntPoint& Resolution);
+
+	/** Back to rendering the scene's primitives. */
+	static void Restore(USceneCaptureComponent2D* SceneCaptureComponent);
+
+	int32 GetNumVisible() const { return VisiblePrimitives.Num(); }
+
+private:
+
+	void Classify(const USceneCaptureComponent2D* SceneCaptureComponent, const FPlane& ClipPlane, const FIntPoint& Resolution);
+
+	uint64 LastFrame;
+	FPlane LastClipPlane;
+	FTransform LastCameraTransform;
+	float LastFOVAngle;
+	FIntPoint LastResolution;
+
+	// kept between updates to avoid reallocating
+	TArray<bool> CandidateVisible;
+
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> VisiblePrimitives;
+};
@@ -0,0 +1,37 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/**
+ * Screen region of the LIV camera the foreground can cover: the player pawn (and actors attached to it)
+ * on the camera side of the clip plane and above the floor. Rendering the foreground view only inside it
+ * saves foreground pixels in proportion to the frame it doesn't cover, the rest is cleared.
+ */
+class LIV_API FLivForegroundRegion
+{
+public:
+
+	/** Region edges are aligned to this many pixels so the view rect doesn't change size every frame. */
+	static constexpr int32 Alignment = 16;
+
+	/**
+	 * Pixel rect of a view of Resolution covering the part of Bounds on the positive side of every plane, padded by
+	 * Padding pixels. Empty when none of it is left or it is off screen, the whole view when any of it is behind the camera.
+	 */
+	static FIntRect Compute(const FBox& Bounds, TArrayView<const FPlane> Planes, const FMatrix& ViewProjectionMatrix, const FIntPoint& Resolution, int32 Padding);
+
+	/**
+	 * Projection matrix rendering Rect of a view of Resolution, the pixels inside Rect are the same as
+	 * in the full view rendered with ProjectionMatrix.
+	 */
+	static FMatrix CropProjectionMatrix(const FMatrix& ProjectionMatrix, const FIntRect& Rect, const FIntPoint& Resolution);
+
+	/**
+	 * Bounds of the first local player's pawn and the actors attached to it, invalid without a pawn.
+	 */
+	static FBox GetPlayerBounds(const UWorld* World);
+};
@@ -66,6 +66,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "LIV")
 		void ShowComponent(UPrimitiveComponent* InComponent);
 
+	/**
+	 * Hide components from rendering during LIV scene capture, cheaper than calling HideComponent for each.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LIV")
+		void HideComponents(const TArray<UPrimitiveComponent*>& InComponents);
+
+	/**
+	 * Stop hiding components previously hidden with HideComponent or HideComponents.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LIV")
+		void ShowComponents(const TArray<UPrimitiveComponent*>& InComponents);
+
 	/**
 	 * Clear components previously hidden with HideComponent.
 	 */
@@ -84,6 +96,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "LIV")
 		void ShowActor(AActor* InActor);
 
+	/**
+	 * Hide actors from rendering during LIV scene capture, cheaper than calling HideActor for each.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LIV")
+		void HideActors(const TArray<AActor*>& InActors);
+
+	/**
+	 * Stop hiding actors previously hidden with HideActor or HideActors.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LIV")
+		void ShowActors(const TArray<AActor*>& InActors);
+
 	/**
 	 * Clear actors previously hidden with HideComponent.
 	 */
@@ -93,6 +117,8 @@ public:
 	UFUNCTION(BlueprintPure, Category = "LIV")
 		FLivCaptureContext GetCaptureContext() const;
 
+	const FLivCaptureContext& GetCaptureContextRef() const { return CaptureContext; }
+
 public:
 
 	UPROPERTY(BlueprintAssignable, Category = "LIV")
@@ -6,9 +6,31 @@
 #include "LivNativeWrapper.generated.h"
 
 class USceneCaptureComponent2D;
+struct LIV_InputFrame;
+struct LIV_Texture;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogLivNativeWrapper, Log, All);
 
+/**
+ * Groups of FLivInputFrame fields that are decoded (and change) together.
+ */
+enum class ELivInputFrameFields : uint8
+{
+	None = 0,
+
+	/** CameraLocation, CameraRotation, HorizontalFieldOfView */
+	Pose = 1 << 0,
+
+	/** CameraClipPlaneMatrix, FloorClipPlaneMatrix, bFloorClipPlaneEnabled */
+	ClipPlanes = 1 << 1,
+
+	/** Dimensions, HorizontalFieldOfView */
+	Resolution = 1 << 2,
+
+	All = Pose | ClipPlanes | Resolution
+};
+ENUM_CLASS_FLAGS(ELivInputFrameFields);
+
 USTRUCT(BlueprintType)
 struct LIV_API FLivInputFrame
 {
@@ -37,6 +59,38 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "LIV")
 		uint32 bFloorClipPlaneEnabled : 1;
 
+	/** Whether LIV composites the background layer with the current layout. */
+	UPROPERTY(BlueprintReadOnly, Category = "LIV")
+		uint32 bBackgroundEnabled : 1;
+
+	/** Whether LIV composites the foreground layer with the current layout. */
+	UPROPERTY(BlueprintReadOnly, Category = "LIV")
+		uint32 bForegroundEnabled : 1;
+
+	/** Whether LIV takes background depth and separates the foreground itself (compositor segmentation). */
+	UPROPERTY(BlueprintReadOnly, Category = "LIV")
+		uint32 bBackgroundDepthEnabled : 1;
+
+	/** LIV_FEATURES bits of the most recent frame. */
+	uint64 Features = 0;
+
+	/** Resolution the game asked LIV for with the most recent update, zero if it left it to LIV. */
+	FIntPoint RequestedResolution = FIntPoint::ZeroValue;
+
+	/** Fields that changed in the most recent update, everything is dirty until a frame has been decoded. */
+	ELivInputFrameFields DirtyFields = ELivInputFrameFields::All;
+
+	/** Whether a frame has been decoded into this, later updates only decode what LIV reports as changed. */
+	bool bDecoded = false;
+
+	/** FPlatformTime::Seconds() when this was received from LIV. */
+	double Timestamp = 0.0;
+
+	/** frameid of the LIV input frame this was received in. */
+	uint64 FrameId = 0;
+
+	bool IsDirty(ELivInputFrameFields Fields) const { return EnumHasAnyFlags(DirtyFields, Fields); }
+
 	FRotator GetCameraRotator() const { return CameraRotation.Rotator(); }
 
 	FTransform GetCameraClipPlaneTransform() const { return FTransform(CameraClipPlaneMatrix); }
@@ -46,6 +100,22 @@ public:
 	float GetHorizontalFieldOfView() const;
 };
 
+/**
+ * Camera pose the game asks LIV to use, a copy of an overriding scene capture component
+ * so the request can be made away from the game thread.
+ */
+struct LIV_API FLivInputFramePoseRequest
+{
+	FLivInputFramePoseRequest() = default;
+	explicit FLivInputFramePoseRequest(const USceneCaptureComponent2D* SceneCaptureComponent);
+
+	/** Relative to the tracking origin */
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	float HorizontalFieldOfView = 90.0f;
+	float NearClipPlane = 10.0f;
+};
+
 /**
  * Wraps LIV native library to help reduce the amount of exposed headers/symbols.
  */
@@ -78,6 +148,33 @@ public:
 	 */
 	static void Start();
 
+	/**
+	 * Adds a texture to the frame being built, call Submit once all textures are added.
+	 */
+	static void AddTexture(LIV_Texture* Texture);
+
+	/**
+	 * Submits the textures added since the last submit to LIV.
+	 */
+	static void Submit();
+
+	/**
+	 * Ask LIV for a texture resolution with every following input frame update, zero leaves it to LIV.
+	 * Safe to call from any thread.
+	 */
+	static void SetRequestedResolution(const FIntPoint& Resolution);
+
+	/**
+	 * Ask LIV to take background depth (LIV_FEATURES_BACKGROUND_DEPTH_RENDER) with every following input frame update,
+	 * FLivInputFrame::bBackgroundDepthEnabled reports whether it does. Safe to call from any thread.
+	 */
+	static void SetRequestedBackgroundDepth(bool bRequested);
+
+	/**
+	 * Get the resolution LIV wants textures to be submitted at itself, regardless of SetRequestedResolution.
+	 */
+	static bool GetResolution(FIntPoint& OutResolution);
+
 	/**
 	 * Get version string of LIV Native SDK if LIV is supported on this platform (else returns "Unsupported")
 	 */
@@ -94,6 +191,18 @@ public:
 	 */
 	static bool UpdateInputFrame(FLivInputFrame& InOutInputFrame, USceneCaptureComponent2D* OverridingSceneCaptureComponent = nullptr);
 
+	/**
+	 * Get latest input frame from LIV, safe to call from any thread.
+	 * If PoseRequest is provided then there will be a request for LIV to use that pose.
+	 */
+	static bool UpdateInputFrame(FLivInputFrame& InOutInputFrame, const FLivInputFramePoseRequest* PoseRequest);
+
+	/**
+	 * Decode a LIV input frame into InOutInputFrame. Once a frame has been decoded into it only the fields
+	 * the *_UPDATED feature bits report as changed (and ForcedFields) are decoded, see Liv.IncrementalInputFrame.
+	 */
+	static void DecodeInputFrame(const LIV_InputFrame& LivInputFrame, FLivInputFrame& InOutInputFrame, ELivInputFrameFields ForcedFields = ELivInputFrameFields::None);
+
 	/**
 	 * Sends data about this project to LIV.
 	 */
@@ -44,6 +44,16 @@ public:
 	UPROPERTY(config, EditAnywhere, Category = "Liv")
 		bool bBackgroundOnly;
 
+	/**
+	 * Submit background color and depth and let the LIV compositor separate the foreground,
+	 * skips the foreground capture and segmentation on the game GPU.
+	 * Background depth is requested of LIV and only submitted once LIV reports it takes it, until then the
+	 * foreground is segmented as usual.
+	 * Supported by the Single and Combo capture methods, ignored when background only is enabled.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Liv", meta = (EditCondition = "!bBackgroundOnly"))
+		bool bCompositorSegmentation;
+
 	/**
 	 * Does your game require transparency in the foreground?
 	 * If so enable this but it requires the global clip plane be enabled
@@ -65,6 +75,118 @@ public:
 	UPROPERTY(config, EditAnywhere, Category = "Liv")
 		float PreExposure;
 
+	/**
+	 * Captures per second to render for LIV, spread evenly over game frames. LIV streams at 30 or 60 fps
+	 * so capturing on every 90/120 Hz HMD frame renders frames that are never shown. 0 captures every frame.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Liv", meta = (ClampMin = "0.0", UIMax = "120.0"))
+		float CaptureRate;
+
+	/**
+	 * Ask LIV for a lower resolution while the GPU is over its frame budget and for full resolution again once
+	 * there's headroom, LIV upscales. Keeps the HMD frame rate stable at the cost of LIV output quality.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv")
+		bool bDynamicResolution;
+
+	/**
+	 * GPU frame time to stay under, usually the HMD frame time (11.1 ms at 90 Hz).
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv", meta = (EditCondition = "bDynamicResolution", Units = "ms", ClampMin = "1.0", UIMax = "50.0"))
+		float DynamicResolutionFrameBudget;
+
+	/**
+	 * Lowest fraction of LIV's resolution to ask for (2/3 turns 1920x1080 into 1280x720).
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv", meta = (EditCondition = "bDynamicResolution", ClampMin = "0.25", ClampMax = "1.0"))
+		float DynamicResolutionMinScale;
+
+	/**
+	 * Poll LIV for input frames on a background thread rather than on the game thread during capture.
+	 * Removes time spent in the LIV bridge from the game thread at the cost of up to one poll of latency.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv")
+		bool bPollInputFramesOnThread;
+
+	/**
+	 * How many times per second to poll LIV when polling on a background thread.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv", meta = (ClampMin = "1.0", UIMax = "240.0"))
+		float InputFramePollRate;
+
+	/**
+	 * Update the LIV camera pose on the render thread just before it is rendered (like the HMD late update),
+	 * reduces misregistration against the real camera when it moves.
+	 * Also polls LIV on a background thread (as bPollInputFramesOnThread) and persists the rendering state
+	 * of the capture components, the late update needs both.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv")
+		bool bLateLatchCameraPose;
+
+	/**
+	 * Extrapolate the LIV camera pose from its recent motion to hide latency for moving cameras.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv")
+		bool bPredictCameraPose;
+
+	/**
+	 * How far ahead to predict the camera pose, set to the measured time from capture to the LIV output.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv", meta = (EditCondition = "bPredictCameraPose", Units = "ms", ClampMin = "0.0", ClampMax = "100.0"))
+		float CameraPosePredictionTime;
+
+	/**
+	 * Captures only used for their depth or opacity (the clip plane depth of the mesh clip plane methods,
+	 * the foreground opacity of the global clip plane post process method) skip shadows, lighting and
+	 * reflections, the lit color comes from the capture before them. Shadow depths are most of their cost.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv")
+		bool bReusePreviousCaptureLighting;
+
+	/**
+	 * Submit the last background again rather than rendering it while the LIV camera is static and nothing in view
+	 * changed (global clip plane methods, which render the background separately). Tag actors or components with
+	 * animated materials LivAnimated so they count as changing.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv")
+		bool bReuseBackground;
+
+	/**
+	 * Longest a background is reused for before it is rendered regardless, catches changes that aren't detected.
+	 * 0 never expires, the background is then only rendered when a change is detected.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv", meta = (EditCondition = "bReuseBackground", Units = "s", ClampMin = "0.0", UIMax = "10.0"))
+		float BackgroundMaxAge;
+
+	/**
+	 * Render the foreground only inside the screen region of the player pawn (and actors attached to it) on the
+	 * camera side of the clip plane, the rest of the foreground is cleared. Only content of the player shows in
+	 * the foreground when enabled. Supported by the Dual View capture method.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv")
+		bool bLimitForegroundToPlayer;
+
+	/**
+	 * Pixels added around the player's screen region, covers motion since the region was computed.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv", meta = (EditCondition = "bLimitForegroundToPlayer", ClampMin = "0", UIMax = "256"))
+		int32 ForegroundRegionPadding;
+
+	/**
+	 * Render only the primitives that can be on the camera side of the clip plane in foreground captures,
+	 * classified on the CPU every capture. Culled primitives no longer cast shadows onto the foreground.
+	 * Supported by the global clip plane capture methods.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv")
+		bool bCullForegroundPrimitives;
+
+	/**
+	 * Skip the foreground capture and submit a transparent foreground when no primitive in view can be on the
+	 * camera side of the clip plane (stat Liv). Supported by the global clip plane and dual view capture methods.
+	 */
+	UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Liv")
+		bool bSkipEmptyForeground;
+
 	/**
 	 * Debugging Settings
 	 */
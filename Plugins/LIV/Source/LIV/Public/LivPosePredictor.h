@@ -0,0 +1,59 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/CircularBuffer.h"
+
+/**
+ * Extrapolates the LIV camera pose ahead in time from a short history of timestamped poses,
+ * assuming constant linear and angular velocity over the history window.
+ */
+class LIV_API FLivPosePredictor
+{
+public:
+
+	FLivPosePredictor();
+
+	/**
+	 * Add a pose received from LIV at Timestamp (FPlatformTime::Seconds()), timestamps must not decrease.
+	 * Add unchanged poses too so a camera that stops moving stops being extrapolated.
+	 */
+	void AddSample(double Timestamp, const FVector& Location, const FQuat& Rotation);
+
+	/**
+	 * Add the newest pose again at Timestamp, for when LIV reports the pose has not changed.
+	 */
+	void RepeatNewestSample(double Timestamp);
+
+	/**
+	 * Predict the pose at TargetTime, falls back to the newest pose if there is not enough history.
+	 * Returns false if there are no samples.
+	 */
+	bool Predict(double TargetTime, FVector& OutLocation, FQuat& OutRotation) const;
+
+	void Reset();
+
+	int32 Num() const { return NumSamples; }
+
+	/** Samples older than this (relative to the newest) are not used to estimate velocity. */
+	double HistoryWindow;
+
+	/** Never extrapolate further than this past the newest sample. */
+	double MaxPredictionTime;
+
+private:
+
+	struct FSample
+	{
+		double Timestamp;
+		FVector Location;
+		FQuat Rotation;
+	};
+
+	const FSample& GetSample(int32 Age) const { return Samples[NewestIndex - Age]; }
+
+	TCircularBuffer<FSample> Samples;
+	uint32 NewestIndex;
+	int32 NumSamples;
+};
@@ -0,0 +1,59 @@
+// Copyright 2021 LIV Inc. - MIT License
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "LivRenderTargetPool.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLivRenderTargetPool, Log, All);
+
+/**
+ * Render targets the capture components lease rather than create, so reconnecting, switching capture method
+ * or changing resolution reuses targets made earlier instead of allocating new objects and GPU resources.
+ *
+ * Targets are matched on extent, format and gamma. Returned targets stay idle in the pool
+ * (up to Liv.RenderTargetPool.MaxIdle) until leased again.
+ */
+UCLASS()
+class LIV_API ULivRenderTargetPool : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static ULivRenderTargetPool* Get();
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * Lease a render target, reusing an idle one when one matches.
+	 * Reused targets are cleared, new ones get a unique name derived from Name
+	 * and have their resource created on the render thread.
+	 */
+	UTextureRenderTarget2D* Acquire(int32 Width,
+		int32 Height,
+		FName Name,
+		ETextureRenderTargetFormat Format,
+		bool bForceLinearGamma,
+		FLinearColor ClearColor,
+		float TargetGamma);
+
+	/**
+	 * Return a leased render target to the pool.
+	 */
+	void Release(UTextureRenderTarget2D* RenderTarget);
+
+	/**
+	 * Release the resources of all idle render targets.
+	 */
+	void Empty();
+
+	int32 GetNumIdle() const { return IdleRenderTargets.Num(); }
+
+private:
+
+	/** Least recently returned first. */
+	UPROPERTY(Transient)
+		TArray<UTextureRenderTarget2D*> IdleRenderTargets;
+};
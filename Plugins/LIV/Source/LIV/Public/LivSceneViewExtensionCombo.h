@@ -29,6 +29,9 @@ public:
 	TWeakObjectPtr<UTextureRenderTarget2D> ForegroundRenderTarget2D;
 	TWeakObjectPtr<UTextureRenderTarget2D> BackgroundRenderTarget2D;
 
+	// Only set when intermediates are extracted for debugging
+	TWeakObjectPtr<UTextureRenderTarget2D> ForegroundOutputRenderTarget2D;
+
 	bool IsForegroundCapture(const FSceneViewFamily& Family) const
 	{
 		return ForegroundRenderTarget2D.IsValid() && Family.RenderTarget == ForegroundRenderTarget2D->GetRenderTargetResource();
@@ -59,6 +62,11 @@ protected:
 		const FSceneView& View,
 		const FPostProcessMaterialInputs& InOutInputs);
 
+	FScreenPassTexture PostProcessPassAfterFXAACompositorSegmentation_RenderThread(
+		FRDGBuilder& GraphBuilder,
+		const FSceneView& View,
+		const FPostProcessMaterialInputs& InOutInputs);
+
 	FScreenPassTexture PostProcessPassAfterFXAATransparency_RenderThread(
 		FRDGBuilder& GraphBuilder,
 		const FSceneView& View,
@@ -0,0 +1,57 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LivSceneViewExtensionsCommon.h"
+#include "SceneViewExtension.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "SceneView.h"
+
+#ifndef WITH_EYE_ADAPTATION_CALLBACK
+#define WITH_EYE_ADAPTATION_CALLBACK 0
+#endif
+
+/**
+ * Keeps the inverse opacity of the foreground view of a dual view capture (ULivCaptureDualView),
+ * post processing doesn't carry scene color alpha through to the view family render target.
+ *
+ * With WITH_EYE_ADAPTATION_CALLBACK (see FLivSceneViewExtensionMulti) the foreground view also takes the
+ * background view's eye adaptation, both views are rendered in order by the same graph.
+ */
+class LIV_API FLivSceneViewExtensionDualView : public FLivSceneViewExtensionBase
+{
+public:
+
+	FLivSceneViewExtensionDualView(const FAutoRegister& AutoRegister, FViewportClient* AssociatedViewportClient = nullptr);
+	virtual ~FLivSceneViewExtensionDualView() override {}
+
+	virtual void PrePostProcessPass_RenderThread(FRDGBuilder& GraphBuilder, const FSceneView& View, const FPostProcessingInputs& Inputs) override;
+
+#if WITH_EYE_ADAPTATION_CALLBACK
+	virtual void PostEyeAdaptation_RenderThread(FRDGBuilder& GraphBuilder, const FSceneView& View, FRDGTextureRef EyeAdaptationTexture) override;
+#endif
+
+	TWeakObjectPtr<UTextureRenderTarget2D> RenderTarget2D;
+	TWeakObjectPtr<UTextureRenderTarget2D> ForegroundOpacityRenderTarget2D;
+
+	bool IsValidForBoundRenderTarget(const FSceneViewFamily& Family) const
+	{
+		return RenderTarget2D.IsValid() && Family.RenderTarget == RenderTarget2D->GetRenderTargetResource();
+	}
+
+	/** The foreground is the only view of the family with a global clip plane. */
+	static bool IsForegroundView(const FSceneView& View)
+	{
+		return !View.GlobalClippingPlane.Equals(FPlane(0, 0, 0, 0));
+	}
+
+#if WITH_EYE_ADAPTATION_CALLBACK
+private:
+
+	// render thread, the background view's eye adaptation in the graph rendering the family
+	const FRDGBuilder* BackgroundGraphBuilder{ nullptr };
+	FRDGTextureRef BackgroundEyeAdaptationTexture{ nullptr };
+	uint32 BackgroundFrameNumber{ 0u };
+#endif
+};
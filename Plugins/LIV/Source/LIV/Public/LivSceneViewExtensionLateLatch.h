@@ -0,0 +1,63 @@
+// Copyright 2021 LIV Inc. - MIT License
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LivSceneViewExtensionsCommon.h"
+#include "SceneViewExtension.h"
+#include "SceneView.h"
+
+class USceneCaptureComponent;
+class FSceneViewStateInterface;
+
+/**
+ * Late updates the view of LIV scene captures with the newest camera pose from LIV on the render thread,
+ * the same way head mounted displays late update the player view.
+ *
+ * Each frame the game thread registers the view states of every capture component, views on the render
+ * thread rendered with one of them are moved to the newest pose published by the input frame polling thread.
+ * Registered captures always persist their rendering state so they have a view state to be recognised by.
+ */
+class LIV_API FLivSceneViewExtensionLateLatch : public FLivSceneViewExtensionBase
+{
+public:
+
+	FLivSceneViewExtensionLateLatch(const FAutoRegister& AutoRegister, FViewportClient* AssociatedViewportClient = nullptr);
+	virtual ~FLivSceneViewExtensionLateLatch() override {}
+
+	virtual void PreRenderView_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneView& InView) override;
+
+	/**
+	 * Register a capture component whose pose comes from LIV (relative to its parent, the tracking origin),
+	 * NumViews is how many views (view states) it renders.
+	 */
+	void SetCaptureView_GameThread(USceneCaptureComponent* CaptureComponent, int32 NumViews = 1);
+
+	/**
+	 * Stop late updating a capture component, e.g. when its pose no longer comes from LIV.
+	 */
+	void ClearCaptureView_GameThread(const USceneCaptureComponent* CaptureComponent);
+
+protected:
+
+	static constexpr int32 MaxViewsPerCapture = 2;
+
+	struct FCaptureView
+	{
+		/** View states of the capture's views, never dereferenced. */
+		TArray<const FSceneViewStateInterface*, TInlineAllocator<MaxViewsPerCapture>> ViewStates;
+
+		/** Tracking origin to world (the capture component's parent). */
+		FTransform TrackingToWorld;
+	};
+
+	// render thread only
+
+	/** Keyed by capture component, which is never dereferenced. */
+	TMap<const void*, FCaptureView> CaptureViews;
+
+	/** Pose latched for the current render thread frame so every capture in a frame uses the same one. */
+	FTransform LatchedPose;
+	uint32 LatchedFrameNumber{ 0u };
+	bool bHasLatchedPose{ false };
+};
@@ -6,6 +6,7 @@
 #include "LivSceneViewExtensionsCommon.h"
 #include "SceneViewExtension.h"
 #include "Engine/TextureRenderTarget2D.h"
+#include "RendererInterface.h"
 #include "SceneView.h"
 
 #ifndef WITH_EYE_ADAPTATION_CALLBACK
@@ -67,6 +68,9 @@ protected:
 	uint32 ForegroundFrameNumber{ 0u };
 	uint32 BackgroundFrameNumber{ 0u };
 
+	// Background output of the background capture, extracted from its graph for the foreground capture to submit
+	TRefCountPtr<IPooledRenderTarget> BackgroundOutputTexture;
+
 	FScreenPassTexture PostProcessPassAfterFXAA_RenderThread(
 		FRDGBuilder& GraphBuilder,
 		const FSceneView& View,
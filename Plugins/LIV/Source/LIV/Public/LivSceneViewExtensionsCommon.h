@@ -20,8 +20,18 @@ public:
 	virtual void PreRenderViewFamily_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily) override {}
 	virtual void PreRenderView_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneView& InView) override {}
 
+	/**
+	 * Set which layers the capture renders this frame and whether background depth is submitted for LIV to separate
+	 * the foreground (compositor segmentation), applied in order with the capture's render commands.
+	 */
+	void SetCaptureLayers_GameThread(bool bInCaptureBackground, bool bInCaptureForeground, bool bInCompositorSegmentation = false);
+
 protected:
 
+	bool bCaptureBackground_RenderThread { true };
+	bool bCaptureForeground_RenderThread { true };
+	bool bCompositorSegmentation_RenderThread { false };
+
 	FScreenPassTexture AddCopyPassIfLastPass(FRDGBuilder& GraphBuilder, const FSceneView& View, const FPostProcessMaterialInputs& InOutInputs) const;
 
 };
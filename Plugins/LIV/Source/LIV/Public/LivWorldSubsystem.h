@@ -46,7 +46,10 @@ public:
 	UFUNCTION(BlueprintPure, Category = "LIV")
 		USceneComponent* GetPlayerCameraParent() const;
 
-	void Capture(struct FLivCaptureContext& Context);
+	void Capture(const struct FLivCaptureContext& Context);
+
+	/** Game thread time (seconds) spent in the most recent Capture. */
+	double GetLastCaptureDuration() const { return LastCaptureDuration; }
 
 	void CreateCaptureResources();
 
@@ -70,5 +73,7 @@ private:
 	UPROPERTY(Transient)
 		class ALivCameraController* CameraController;
 
+	double LastCaptureDuration;
+
 	friend class ULivLocalPlayerSubsystem;
 };
@@ -17,6 +17,7 @@
 #include "LivPluginSettings.h"
 #include "Widgets/Docking/SDockTab.h"
 #include "Widgets/Input/SButton.h"
+#include "HAL/IConsoleManager.h"
 
 #define LOCTEXT_NAMESPACE "LivRenderTargetVisualiser"
 
@@ -111,12 +112,25 @@ SLivDebuggingTab::~SLivDebuggingTab()
 		ILivModule::Get().OnLivCaptureActivated().Remove(LivCaptureActivatedHandle);
 		ILivModule::Get().OnLivCaptureDeactivated().Remove(LivCaptureDeactivatedHandle);
 	}
+
+	SetExtractIntermediates(false);
 }
 
 void SLivDebuggingTab::Construct(const FArguments& InArgs)
 {
 	LivCaptureActivatedHandle = ILivModule::Get().OnLivCaptureActivated().AddRaw(this, &SLivDebuggingTab::OnLivCaptureActivated);
 	LivCaptureDeactivatedHandle = ILivModule::Get().OnLivCaptureDeactivated().AddRaw(this, &SLivDebuggingTab::OnLivCaptureDeactivated);
+
+	// intermediate textures only have render targets to show while something asks for them
+	SetExtractIntermediates(true);
+}
+
+void SLivDebuggingTab::SetExtractIntermediates(bool bExtract)
+{
+	if (IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(TEXT("Liv.Debug.ExtractIntermediates")))
+	{
+		CVar->Set(bExtract);
+	}
 }
 
 void SLivDebuggingTab::OnLivCaptureActivated()
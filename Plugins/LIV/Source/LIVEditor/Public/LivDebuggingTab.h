@@ -57,6 +57,8 @@ private:
 
 	void OnLivCaptureActivated();
 	void OnLivCaptureDeactivated();
+
+	static void SetExtractIntermediates(bool bExtract);
 	
 private:
 	FDelegateHandle LivCaptureActivatedHandle;
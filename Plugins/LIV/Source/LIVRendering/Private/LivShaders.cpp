@@ -22,7 +22,10 @@ IMPLEMENT_SHADER_TYPE(, FLivRDGForegroundSegmentationPPAndCopyPS, TEXT("/Plugin/
 IMPLEMENT_SHADER_TYPE(, FLivRDGCopySceneColorDepthPS, TEXT("/Plugin/Liv/LivRDGCopySceneColorDepthPS.usf"), TEXT("MainPS"), SF_Pixel)
 IMPLEMENT_SHADER_TYPE(, FLivRDGCopySceneColorAndDepthPS, TEXT("/Plugin/Liv/LivRDGCopySceneColorAndDepthPS.usf"), TEXT("MainPS"), SF_Pixel)
 IMPLEMENT_SHADER_TYPE(, FLivRDGCopyDepthPS, TEXT("/Plugin/Liv/LivRDGCopyDepthPS.usf"), TEXT("MainPS"), SF_Pixel)
+IMPLEMENT_SHADER_TYPE(, FLivRDGCopyBackgroundDepthPS, TEXT("/Plugin/Liv/LivRDGCopyBackgroundDepthPS.usf"), TEXT("MainPS"), SF_Pixel)
 IMPLEMENT_SHADER_TYPE(, FLivRDGSegmentByDepthPS, TEXT("/Plugin/Liv/LivRDGSegmentByDepthPS.usf"), TEXT("MainPS"), SF_Pixel)
+IMPLEMENT_SHADER_TYPE(, FLivRDGSegmentByPlanesPS, TEXT("/Plugin/Liv/LivRDGSegmentByPlanesPS.usf"), TEXT("MainPS"), SF_Pixel)
+IMPLEMENT_SHADER_TYPE(, FLivRDGSegmentDualViewPS, TEXT("/Plugin/Liv/LivRDGSegmentDualViewPS.usf"), TEXT("MainPS"), SF_Pixel)
 IMPLEMENT_SHADER_TYPE(, FLivRDGCopyFullSceneColorPS, TEXT("/Plugin/Liv/LivRDGCopyFullSceneColorPS.usf"), TEXT("MainPS"), SF_Pixel)
 
 IMPLEMENT_SHADER_TYPE(, FLivApplyEyeAdaptationPS, TEXT("/Plugin/Liv/LivEyeAdaptation.usf"), TEXT("MainPS"), SF_Pixel)
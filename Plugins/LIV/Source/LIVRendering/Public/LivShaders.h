@@ -280,6 +280,7 @@ protected:
 BEGIN_SHADER_PARAMETER_STRUCT(FLivSubmitParameters, LIVRENDERING_API)
 	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, BackgroundTexture)
 	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, ForegroundTexture)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, BackgroundDepthTexture)
 END_SHADER_PARAMETER_STRUCT()
 
 class FLivRDGScreenPassVS : public FGlobalShader
@@ -532,6 +533,35 @@ public:
 	}
 };
 
+/**
+ * Copy linear scene depth to a single channel float target for the LIV compositor.
+ */
+class FLivRDGCopyBackgroundDepthPS : public FGlobalShader
+{
+public:
+
+	DECLARE_EXPORTED_SHADER_TYPE(FLivRDGCopyBackgroundDepthPS, Global, LIVRENDERING_API);
+
+	SHADER_USE_PARAMETER_STRUCT(FLivRDGCopyBackgroundDepthPS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(float, DepthScale)
+		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+		SHADER_PARAMETER_STRUCT_INCLUDE(FSceneTextureShaderParameters, SceneTextures)
+		RENDER_TARGET_BINDING_SLOTS()
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::ES3_1);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	}
+};
+
 BEGIN_SHADER_PARAMETER_STRUCT(FLivFilmGrainParameters, )
 SHADER_PARAMETER(FVector, GrainRandomFull)
 SHADER_PARAMETER(FVector, GrainScaleBiasJitter)
@@ -657,6 +687,77 @@ public:
 	}
 };
 
+/**
+ * Does foreground segmentation for first bound render target by reconstructing the world position
+ * of every pixel from scene depth (alpha) and testing it against the clip planes, and a copy for
+ * the second render target. Planes are world space with the camera on the positive side.
+ */
+class FLivRDGSegmentByPlanesPS : public FGlobalShader
+{
+public:
+
+	DECLARE_EXPORTED_SHADER_TYPE(FLivRDGSegmentByPlanesPS, Global, LIVRENDERING_API);
+
+	SHADER_USE_PARAMETER_STRUCT(FLivRDGSegmentByPlanesPS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_TEXTURE(Texture2D, InputSceneColorDepthTexture)
+		SHADER_PARAMETER_SAMPLER(SamplerState, InputSceneColorDepthSampler)
+		SHADER_PARAMETER(FVector, CameraOrigin)
+		SHADER_PARAMETER(FVector, CameraForward)
+		SHADER_PARAMETER(FVector, CameraRight)
+		SHADER_PARAMETER(FVector, CameraUp)
+		SHADER_PARAMETER(FVector2D, ProjectionScale)
+		SHADER_PARAMETER(FVector4, CameraClipPlane)
+		SHADER_PARAMETER(FVector4, FloorClipPlane)
+		RENDER_TARGET_BINDING_SLOTS()
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::ES3_1);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	}
+};
+
+/**
+ * Does foreground segmentation (post processed) for first bound render target and a copy of the
+ * background for the second, both views of one view family rendered into the same scene texture.
+ */
+class FLivRDGSegmentDualViewPS : public FGlobalShader
+{
+public:
+
+	DECLARE_EXPORTED_SHADER_TYPE(FLivRDGSegmentDualViewPS, Global, LIVRENDERING_API);
+
+	SHADER_USE_PARAMETER_STRUCT(FLivRDGSegmentDualViewPS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, InputSceneTexture)
+		SHADER_PARAMETER_SAMPLER(SamplerState, InputSceneSampler)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, InputForegroundOpacityTexture)
+		SHADER_PARAMETER_SAMPLER(SamplerState, InputForegroundOpacitySampler)
+		SHADER_PARAMETER(FVector4, BackgroundUVScaleBias)
+		SHADER_PARAMETER(FVector4, ForegroundUVScaleBias)
+		SHADER_PARAMETER(FVector4, ForegroundRegion)
+		RENDER_TARGET_BINDING_SLOTS()
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::ES3_1);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	}
+};
+
 
 class FLivRDGCopy2DCS : public FGlobalShader
 {
@@ -30,5 +30,10 @@ public class LivSDK : ModuleRules
 			// Add the headers
 			PublicIncludePaths.Add(Path.Combine(ModuleDirectory, Configuration, "include"));
 		}
+		else
+		{
+			// Headers only, the plugin talks to the in-process loopback bridge on these platforms
+			PublicIncludePaths.Add(Path.Combine(ModuleDirectory, "Release", "include"));
+		}
 	}
 }